@@ -0,0 +1,330 @@
+// Copyright (c) the Dviglo project
+// License: MIT
+
+#include "profiler.hpp"
+
+#include "../fs/file_base.hpp"
+#include "../fs/log.hpp"
+
+#include <glad/gl.h>
+#include <SDL3/SDL.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+
+using namespace std;
+
+
+namespace dviglo
+{
+
+// Порядковый номер, который получит следующий поток
+static atomic<u32> next_thread_index{0};
+
+// Порядковый номер текущего потока. UINT32_MAX - ещё не назначен
+static thread_local u32 current_thread_index = UINT32_MAX;
+
+// Глубина вложенности зон в текущем потоке
+static thread_local u32 current_depth = 0;
+
+u32 Profiler::thread_index()
+{
+    if (current_thread_index == UINT32_MAX)
+        current_thread_index = next_thread_index++;
+
+    return current_thread_index;
+}
+
+Profiler::Profiler(i32 max_frames, bool gpu_timing)
+    : frames_(max(max_frames, 2))
+    , gpu_timing_(gpu_timing)
+{
+    if (gpu_timing_)
+        glGenQueries(num_gpu_queries_, gpu_queries_);
+
+    // Номер главного потока всегда 0
+    thread_index();
+
+    assert(!instance_);
+    instance_ = this;
+    DV_LOG->write_debug("Profiler constructed");
+}
+
+Profiler::~Profiler()
+{
+    instance_ = nullptr;
+
+    if (gpu_timing_)
+        glDeleteQueries(num_gpu_queries_, gpu_queries_);
+
+    DV_LOG->write_debug("Profiler destructed");
+}
+
+void Profiler::begin_frame()
+{
+    if (!enabled_)
+        return;
+
+    {
+        lock_guard lock(mutex_);
+
+        ++frame_index_;
+        current_frame_ = &frames_[frame_index_ % frames_.size()];
+        current_frame_->index = frame_index_;
+        current_frame_->begin_ns = SDL_GetTicksNS();
+        current_frame_->end_ns = 0;
+        current_frame_->gpu_ns = 0;
+        current_frame_->zones.clear(); // Ёмкость вектора сохраняется
+    }
+
+    if (gpu_timing_)
+    {
+        u32 query_index = frame_index_ % num_gpu_queries_;
+
+        // Если результат старого запроса ещё не получен, то этот кадр на видеокарте не замеряем
+        if (!gpu_query_frames_[query_index])
+        {
+            glBeginQuery(GL_TIME_ELAPSED, gpu_queries_[query_index]);
+            gpu_query_frames_[query_index] = frame_index_;
+        }
+    }
+}
+
+void Profiler::end_frame()
+{
+    if (!current_frame_)
+        return;
+
+    if (gpu_timing_)
+    {
+        u32 query_index = frame_index_ % num_gpu_queries_;
+
+        if (gpu_query_frames_[query_index] == frame_index_)
+            glEndQuery(GL_TIME_ELAPSED);
+
+        poll_gpu_queries();
+    }
+
+    lock_guard lock(mutex_);
+    current_frame_->end_ns = SDL_GetTicksNS();
+    current_frame_ = nullptr;
+}
+
+void Profiler::poll_gpu_queries()
+{
+    for (u32 i = 0; i < num_gpu_queries_; ++i)
+    {
+        if (!gpu_query_frames_[i])
+            continue;
+
+        GLint available = 0;
+        glGetQueryObjectiv(gpu_queries_[i], GL_QUERY_RESULT_AVAILABLE, &available);
+
+        if (!available)
+            continue;
+
+        GLuint64 ns = 0;
+        glGetQueryObjectui64v(gpu_queries_[i], GL_QUERY_RESULT, &ns);
+
+        lock_guard lock(mutex_);
+        ProfilerFrame& frame = frames_[gpu_query_frames_[i] % frames_.size()];
+
+        // Кадр мог быть уже перезаписан в кольцевом буфере
+        if (frame.index == gpu_query_frames_[i])
+            frame.gpu_ns = ns;
+
+        gpu_query_frames_[i] = 0;
+    }
+}
+
+void Profiler::add_zone(const ProfilerZone& zone)
+{
+    lock_guard lock(mutex_);
+
+    // Зоны вне кадров (например при загрузке ресурсов в start()) не сохраняются
+    if (current_frame_)
+        current_frame_->zones.push_back(zone);
+}
+
+vector<ProfilerFrame> Profiler::frames() const
+{
+    vector<ProfilerFrame> ret;
+
+    lock_guard lock(mutex_);
+
+    for (const ProfilerFrame& frame : frames_)
+    {
+        if (frame.index && frame.end_ns)
+            ret.push_back(frame);
+    }
+
+    sort(ret.begin(), ret.end(), [](const ProfilerFrame& a, const ProfilerFrame& b) { return a.index < b.index; });
+
+    return ret;
+}
+
+StrUtf8 Profiler::summary() const
+{
+    vector<ProfilerFrame> frames = this->frames();
+
+    if (frames.empty())
+        return StrUtf8();
+
+    struct Total
+    {
+        StrViewUtf8 name;
+        u32 thread_index;
+        u32 depth;
+        u64 ns;
+    };
+
+    // Порядок зон сохраняется как в первом кадре, в котором зона встретилась
+    vector<Total> totals;
+    u64 frame_ns = 0;
+    u64 gpu_ns = 0;
+    u32 num_gpu_frames = 0;
+
+    for (const ProfilerFrame& frame : frames)
+    {
+        frame_ns += frame.end_ns - frame.begin_ns;
+
+        if (frame.gpu_ns)
+        {
+            gpu_ns += frame.gpu_ns;
+            ++num_gpu_frames;
+        }
+
+        for (const ProfilerZone& zone : frame.zones)
+        {
+            auto it = find_if(totals.begin(), totals.end(), [&zone](const Total& total)
+                {
+                    return total.name == zone.name && total.thread_index == zone.thread_index;
+                });
+
+            if (it == totals.end())
+                totals.push_back({zone.name, zone.thread_index, zone.depth, zone.end_ns - zone.begin_ns});
+            else
+                it->ns += zone.end_ns - zone.begin_ns;
+        }
+    }
+
+    f64 num_frames = (f64)frames.size();
+    f64 ns_per_ms = (f64)SDL_NS_PER_MS;
+
+    StrUtf8 ret = format("frame: {:.3f} ms", frame_ns / num_frames / ns_per_ms);
+
+    if (num_gpu_frames)
+        ret += format(" | gpu: {:.3f} ms", gpu_ns / (f64)num_gpu_frames / ns_per_ms);
+
+    for (const Total& total : totals)
+    {
+        ret += format("\n{}[{}] {}: {:.3f} ms", StrUtf8(total.depth * 2 + 2, ' '), total.thread_index,
+                      total.name, total.ns / num_frames / ns_per_ms);
+    }
+
+    return ret;
+}
+
+// Экранирует строку для JSON
+static StrUtf8 to_json_string(StrViewUtf8 str)
+{
+    StrUtf8 ret;
+    ret.reserve(str.size() + 2);
+    ret += '"';
+
+    for (char c : str)
+    {
+        if (c == '"' || c == '\\')
+            ret += '\\';
+
+        ret += c;
+    }
+
+    ret += '"';
+    return ret;
+}
+
+bool Profiler::save_chrome_trace(const StrUtf8& path) const
+{
+    vector<ProfilerFrame> frames = this->frames();
+
+    // Chrome Trace Event использует микросекунды
+    auto to_us = [](u64 ns) { return ns / (f64)SDL_NS_PER_US; };
+
+    // Виртуальный поток для времени кадров на видеокарте
+    const u32 gpu_tid = 1000;
+
+    StrUtf8 json = "{\"traceEvents\":[\n";
+
+    json += format(R"({{"name":"thread_name","ph":"M","pid":0,"tid":{},"args":{{"name":"GPU"}}}})", gpu_tid);
+
+    for (u32 i = 0; i < next_thread_index; ++i)
+        json += format(",\n" R"({{"name":"thread_name","ph":"M","pid":0,"tid":{},"args":{{"name":"thread {}"}}}})", i, i);
+
+    for (const ProfilerFrame& frame : frames)
+    {
+        json += format(",\n" R"({{"name":"frame {}","ph":"X","pid":0,"tid":0,"ts":{:.3f},"dur":{:.3f}}})",
+                       frame.index, to_us(frame.begin_ns), to_us(frame.end_ns - frame.begin_ns));
+
+        // Точное время начала работы видеокарты неизвестно, поэтому привязываем к началу кадра
+        if (frame.gpu_ns)
+        {
+            json += format(",\n" R"({{"name":"frame {}","ph":"X","pid":0,"tid":{},"ts":{:.3f},"dur":{:.3f}}})",
+                           frame.index, gpu_tid, to_us(frame.begin_ns), to_us(frame.gpu_ns));
+        }
+
+        for (const ProfilerZone& zone : frame.zones)
+        {
+            json += format(",\n" R"({{"name":{},"ph":"X","pid":0,"tid":{},"ts":{:.3f},"dur":{:.3f}}})",
+                           to_json_string(zone.name), zone.thread_index, to_us(zone.begin_ns),
+                           to_us(zone.end_ns - zone.begin_ns));
+        }
+    }
+
+    json += "\n]}\n";
+
+    FILE* stream = file_open(path, "wb");
+
+    if (!stream)
+    {
+        DV_LOG->writef_error("Profiler::save_chrome_trace(\"{}\") | !stream", path);
+        return false;
+    }
+
+    file_write(json.data(), 1, (i32)json.size(), stream);
+    file_close(stream);
+
+    DV_LOG->writef_info("Profiler::save_chrome_trace(\"{}\") | {} frames", path, frames.size());
+    return true;
+}
+
+ProfilerScope::ProfilerScope(const char* name)
+{
+    Profiler* profiler = DV_PROFILER;
+
+    if (!profiler || !profiler->enabled())
+    {
+        name_ = nullptr;
+        return;
+    }
+
+    name_ = name;
+    depth_ = current_depth++;
+    begin_ns_ = SDL_GetTicksNS();
+}
+
+ProfilerScope::~ProfilerScope()
+{
+    if (!name_)
+        return;
+
+    u64 end_ns = SDL_GetTicksNS();
+    --current_depth;
+
+    // Профайлер мог быть уничтожен, пока зона была открыта
+    if (Profiler* profiler = DV_PROFILER)
+        profiler->add_zone({name_, begin_ns_, end_ns, Profiler::thread_index(), depth_});
+}
+
+} // namespace dviglo
@@ -0,0 +1,138 @@
+// Copyright (c) the Dviglo project
+// License: MIT
+
+#pragma once
+
+#include "../std_utils/string.hpp"
+
+#include <mutex>
+#include <vector>
+
+
+namespace dviglo
+{
+
+// Замер одной зоны
+struct ProfilerZone
+{
+    // Строковый литерал, поэтому указатель всегда валиден
+    const char* name;
+
+    u64 begin_ns;
+    u64 end_ns;
+
+    // Порядковый номер потока (0 - поток, который первым что-то замерил)
+    u32 thread_index;
+
+    // Глубина вложенности в пределах потока (0 - зона верхнего уровня)
+    u32 depth;
+};
+
+// Замеры одного кадра
+struct ProfilerFrame
+{
+    u64 index = 0;
+    u64 begin_ns = 0;
+    u64 end_ns = 0;
+
+    // Сколько кадр выполнялся на видеокарте. 0 - результат ещё не получен или неизвестен
+    u64 gpu_ns = 0;
+
+    // Зоны в порядке их завершения
+    std::vector<ProfilerZone> zones;
+};
+
+class Profiler
+{
+private:
+    // Инициализируется в конструкторе
+    inline static Profiler* instance_ = nullptr;
+
+    // Число GL-запросов в кольце. Результат запроса становится доступен
+    // через несколько кадров, поэтому запросы используются по очереди
+    static constexpr u32 num_gpu_queries_ = 4;
+
+    bool enabled_ = true;
+
+    // Зоны могут завершаться в разных потоках
+    mutable std::mutex mutex_;
+
+    // Кольцевой буфер последних кадров. Вектора зон переиспользуются,
+    // поэтому после прогрева профайлер не выделяет память
+    std::vector<ProfilerFrame> frames_;
+
+    // Номер текущего кадра (кадры нумеруются с 1)
+    u64 frame_index_ = 0;
+
+    // Текущий кадр в кольцевом буфере
+    ProfilerFrame* current_frame_ = nullptr;
+
+    bool gpu_timing_ = false;
+    u32 gpu_queries_[num_gpu_queries_]{};
+
+    // Номер кадра, время которого измеряет запрос. 0 - запрос свободен
+    u64 gpu_query_frames_[num_gpu_queries_]{};
+
+    void poll_gpu_queries();
+
+public:
+    static Profiler* instance() { return instance_; }
+
+    // Если gpu_timing == true, то должен быть создан OpenGL-контекст
+    Profiler(i32 max_frames, bool gpu_timing);
+    ~Profiler();
+
+    bool enabled() const { return enabled_; }
+    void set_enabled(bool enabled) { enabled_ = enabled; }
+
+    // Вызываются в начале и в конце главного цикла
+    void begin_frame();
+    void end_frame();
+
+    // Вызывается в ProfilerScope
+    void add_zone(const ProfilerZone& zone);
+
+    // Порядковый номер текущего потока
+    static u32 thread_index();
+
+    // Копия завершённых кадров от старых к новым
+    std::vector<ProfilerFrame> frames() const;
+
+    // Средние значения зон за сохранённые кадры (для вывода на экран или в лог)
+    StrUtf8 summary() const;
+
+    // Сохраняет сохранённые кадры в формате Chrome Trace Event.
+    // Файл можно открыть в chrome://tracing или https://ui.perfetto.dev
+    bool save_chrome_trace(const StrUtf8& path) const;
+};
+
+#define DV_PROFILER (dviglo::Profiler::instance())
+
+
+// Замеряет время от создания до уничтожения объекта
+class ProfilerScope
+{
+private:
+    // nullptr, если профайлер отсутствует или выключен
+    const char* name_;
+
+    u64 begin_ns_;
+    u32 depth_;
+
+public:
+    // name должен быть строковым литералом
+    ProfilerScope(const char* name);
+    ~ProfilerScope();
+
+    ProfilerScope(const ProfilerScope&) = delete;
+    ProfilerScope& operator=(const ProfilerScope&) = delete;
+};
+
+#define DV_PROFILE_CONCAT_INTERNAL(a, b) a##b
+#define DV_PROFILE_CONCAT(a, b) DV_PROFILE_CONCAT_INTERNAL(a, b)
+
+// Замеряет время до конца текущей области видимости.
+// Пример: DV_PROFILE_SCOPE("update");
+#define DV_PROFILE_SCOPE(name) dviglo::ProfilerScope DV_PROFILE_CONCAT(dv_profiler_scope_, __LINE__)(name)
+
+} // namespace dviglo
@@ -0,0 +1,171 @@
+// Copyright (c) the Dviglo project
+// License: MIT
+
+#include "file_watcher.hpp"
+
+#include "log.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+#ifndef _WIN32 // Linux
+    #include <poll.h>
+    #include <sys/eventfd.h>
+    #include <sys/inotify.h>
+    #include <unistd.h>
+#endif
+
+using namespace std;
+
+
+namespace dviglo
+{
+
+FileWatcher::FileWatcher()
+{
+    assert(!instance_);
+    instance_ = this;
+
+#ifdef _WIN32
+    DV_LOG->write_info("FileWatcher::FileWatcher(): not supported on Windows");
+#else
+    inotify_fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+    if (inotify_fd_ < 0 || wake_fd_ < 0)
+    {
+        DV_LOG->write_error("FileWatcher::FileWatcher(): inotify_fd_ < 0 || wake_fd_ < 0");
+
+        if (inotify_fd_ >= 0)
+            close(inotify_fd_);
+
+        if (wake_fd_ >= 0)
+            close(wake_fd_);
+
+        inotify_fd_ = wake_fd_ = -1;
+    }
+    else
+    {
+        thread_ = thread(&FileWatcher::thread_func, this);
+    }
+#endif
+
+    DV_LOG->write_debug("FileWatcher constructed");
+}
+
+FileWatcher::~FileWatcher()
+{
+#ifndef _WIN32
+    if (thread_.joinable())
+    {
+        u64 one = 1;
+        [[maybe_unused]] ssize_t ret = write(wake_fd_, &one, sizeof(one));
+        thread_.join();
+
+        close(inotify_fd_);
+        close(wake_fd_);
+    }
+#endif
+
+    instance_ = nullptr;
+    DV_LOG->write_debug("FileWatcher destructed");
+}
+
+void FileWatcher::add(const StrUtf8& path)
+{
+#ifndef _WIN32
+    if (inotify_fd_ < 0)
+        return;
+
+    size_t slash_pos = path.rfind('/');
+    StrUtf8 dir = slash_pos == StrUtf8::npos ? StrUtf8(".") : path.substr(0, slash_pos + 1);
+    StrUtf8 name = slash_pos == StrUtf8::npos ? path : path.substr(slash_pos + 1);
+
+    // Для одной и той же папки inotify возвращает один и тот же дескриптор
+    i32 wd = inotify_add_watch(inotify_fd_, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+
+    if (wd < 0)
+    {
+        DV_LOG->writef_warning("FileWatcher::add(): wd < 0 | dir = \"{}\"", dir);
+        return;
+    }
+
+    lock_guard lock(mutex_);
+    vector<StrUtf8>& paths = watches_[wd][name];
+
+    if (find(paths.begin(), paths.end(), path) == paths.end())
+        paths.push_back(path);
+#else
+    (void)path;
+#endif
+}
+
+vector<StrUtf8> FileWatcher::take_changes()
+{
+    vector<StrUtf8> ret;
+
+    lock_guard lock(mutex_);
+    ret.swap(changes_);
+
+    return ret;
+}
+
+void FileWatcher::thread_func()
+{
+#ifndef _WIN32
+    // События inotify выровнены как struct inotify_event
+    alignas(inotify_event) char buffer[4096];
+
+    pollfd fds[2]{};
+    fds[0].fd = inotify_fd_;
+    fds[0].events = POLLIN;
+    fds[1].fd = wake_fd_;
+    fds[1].events = POLLIN;
+
+    while (true)
+    {
+        if (poll(fds, 2, -1) < 0)
+            continue; // EINTR
+
+        if (fds[1].revents)
+            return;
+
+        while (true)
+        {
+            ssize_t length = read(inotify_fd_, buffer, sizeof(buffer));
+
+            if (length <= 0)
+                break;
+
+            lock_guard lock(mutex_);
+
+            for (char* ptr = buffer; ptr < buffer + length;)
+            {
+                const inotify_event* event = reinterpret_cast<const inotify_event*>(ptr);
+                ptr += sizeof(inotify_event) + event->len;
+
+                if (!event->len)
+                    continue;
+
+                auto dir_it = watches_.find(event->wd);
+
+                if (dir_it == watches_.end())
+                    continue;
+
+                auto file_it = dir_it->second.find(event->name);
+
+                if (file_it == dir_it->second.end())
+                    continue;
+
+                for (const StrUtf8& path : file_it->second)
+                {
+                    if (find(changes_.begin(), changes_.end(), path) == changes_.end())
+                        changes_.push_back(path);
+                }
+            }
+        }
+    }
+#endif
+}
+
+} // namespace dviglo
@@ -0,0 +1,66 @@
+// Copyright (c) the Dviglo project
+// License: MIT
+
+#pragma once
+
+#include "../std_utils/string.hpp"
+
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+
+namespace dviglo
+{
+
+// Следит за изменением файлов в фоновом потоке (inotify). Нужен для горячей перезагрузки
+// шейдеров и текстур: ShaderCache и TextureCache регистрируют свои файлы, а Application
+// в начале каждого кадра забирает список изменённых файлов и передаёт его кэшам.
+// Создаётся, только если включён engine_params::hot_reload.
+// В Windows пока не поддерживается (изменения не отслеживаются)
+class FileWatcher
+{
+private:
+    // Инициализируется в конструкторе
+    inline static FileWatcher* instance_ = nullptr;
+
+    // Защищает все поля ниже (кроме потока и дескрипторов)
+    std::mutex mutex_;
+
+    // Для каждой отслеживаемой папки (ключ - дескриптор inotify): имя файла -> пути к нему,
+    // под которыми файл был зарегистрирован
+    std::unordered_map<i32, std::unordered_map<StrUtf8, std::vector<StrUtf8>>> watches_;
+
+    // Изменённые файлы, которые ещё не забрали с помощью take_changes()
+    std::vector<StrUtf8> changes_;
+
+    // Дескриптор inotify. -1, если отслеживание не работает
+    i32 inotify_fd_ = -1;
+
+    // Будит фоновый поток при уничтожении объекта
+    i32 wake_fd_ = -1;
+
+    std::thread thread_;
+
+    void thread_func();
+
+public:
+    static FileWatcher* instance() { return instance_; }
+
+    FileWatcher();
+    ~FileWatcher();
+
+    // Начинает следить за файлом. Файла может ещё не быть.
+    // Отслеживается папка файла, поэтому замена файла через переименование
+    // (так сохраняют многие редакторы) тоже замечается. Можно вызывать повторно
+    void add(const StrUtf8& path);
+
+    // Возвращает пути (в том виде, в котором они переданы в add()) файлов, изменённых после
+    // предыдущего вызова. Каждый путь встречается один раз
+    std::vector<StrUtf8> take_changes();
+};
+
+#define DV_FILE_WATCHER (dviglo::FileWatcher::instance())
+
+} // namespace dviglo
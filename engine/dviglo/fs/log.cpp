@@ -75,6 +75,8 @@ void Log::write(LogLevel message_type, StrViewUtf8 message)
     if (message_type == LogLevel::none)
         return;
 
+    lock_guard lock(mutex_);
+
     StrUtf8 str = format("[{}] {}: {}\n", time_to_str(), to_string(message_type), message);
     cout << str;
 
@@ -6,6 +6,7 @@
 #include "../std_utils/string.hpp"
 
 #include <format>
+#include <mutex>
 
 
 namespace dviglo
@@ -29,6 +30,9 @@ private:
 
     FILE* stream_ = nullptr;
 
+    // В лог могут писать задачи JobSystem (например при перезагрузке текстур)
+    std::mutex mutex_;
+
 public:
     static Log* instance() { return instance_; }
 
@@ -13,15 +13,71 @@ namespace dviglo
 {
 
 Fbo::Fbo(ivec2 size)
+    : Fbo(FboParams{.size = size})
 {
+}
+
+Fbo::Fbo(const FboParams& params)
+    : params_(params)
+{
+    // Запоминаем текущие framebuffer'ы, чтобы создание Fbo посреди кадра не меняло, куда идёт рендеринг
+    GLint prev_draw_framebuffer;
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &prev_draw_framebuffer);
+    GLint prev_read_framebuffer;
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &prev_read_framebuffer);
+
     glGenFramebuffers(1, &gpu_object_name_);
     glBindFramebuffer(GL_FRAMEBUFFER, gpu_object_name_);
 
-    texture_ = make_unique<Texture>(size);
-    glFramebufferTexture(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, texture_->gpu_object_name(), 0);
+    if (is_multisample())
+    {
+        glGenRenderbuffers(1, &color_renderbuffer_);
+        glBindRenderbuffer(GL_RENDERBUFFER, color_renderbuffer_);
+        glRenderbufferStorageMultisample(GL_RENDERBUFFER, params.samples, params.format, params.size.x, params.size.y);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, color_renderbuffer_);
+    }
+    else
+    {
+        texture_ = make_unique<Texture>(params.size, params.format);
+        glFramebufferTexture(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, texture_->gpu_object_name(), 0);
+    }
+
+    if (params.depth_stencil)
+    {
+        glGenRenderbuffers(1, &depth_stencil_renderbuffer_);
+        glBindRenderbuffer(GL_RENDERBUFFER, depth_stencil_renderbuffer_);
+
+        if (is_multisample())
+            glRenderbufferStorageMultisample(GL_RENDERBUFFER, params.samples, GL_DEPTH24_STENCIL8, params.size.x, params.size.y);
+        else
+            glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, params.size.x, params.size.y);
+
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depth_stencil_renderbuffer_);
+    }
+
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
 
     if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
-        DV_LOG->writef_error(R"(Fbo::Fbo(ivec2 size) | glCheckFramebufferStatus() returns {})", glCheckFramebufferStatus(GL_FRAMEBUFFER));
+        DV_LOG->writef_error(R"(Fbo::Fbo(const FboParams& params) | glCheckFramebufferStatus() returns {})", glCheckFramebufferStatus(GL_FRAMEBUFFER));
+
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, (GLuint)prev_draw_framebuffer);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, (GLuint)prev_read_framebuffer);
+}
+
+void Fbo::resolve(Fbo& target) const
+{
+    if (target.size() != size())
+    {
+        DV_LOG->write_error("Fbo::resolve(Fbo& target) | target.size() != size()");
+        return;
+    }
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, gpu_object_name_);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, target.gpu_object_name_);
+
+    // При MSAA фильтр должен быть GL_NEAREST, так как размеры совпадают
+    glBlitFramebuffer(0, 0, params_.size.x, params_.size.y, 0, 0, params_.size.x, params_.size.y,
+                      GL_COLOR_BUFFER_BIT, GL_NEAREST);
 }
 
 } // namespace dviglo
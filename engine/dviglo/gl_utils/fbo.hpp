@@ -11,6 +11,24 @@
 namespace dviglo
 {
 
+struct FboParams
+{
+    glm::ivec2 size{0, 0};
+
+    // Внутренний формат цветового буфера (GL_RGBA8, GL_RGBA16F и т.п., но не целочисленный)
+    GLenum format = GL_RGBA8;
+
+    // 0 или 1 - MSAA выключено. Цвет мультисэмплового Fbo хранится не в текстуре,
+    // а в renderbuffer, поэтому перед использованием его нужно скопировать
+    // в обычный Fbo с помощью resolve() (или FboPool::resolve())
+    i32 samples = 0;
+
+    // Буфер глубины и трафарета (GL_DEPTH24_STENCIL8)
+    bool depth_stencil = false;
+
+    bool operator==(const FboParams& rhs) const = default;
+};
+
 // Framebuffer object
 class Fbo
 {
@@ -18,10 +36,20 @@ private:
     // Идентификатор объекта OpenGL
     GLuint gpu_object_name_ = 0;
 
+    FboParams params_;
+
+    // nullptr при MSAA
     std::unique_ptr<Texture> texture_;
 
+    // Цветовой буфер при MSAA
+    GLuint color_renderbuffer_ = 0;
+
+    GLuint depth_stencil_renderbuffer_ = 0;
+
 public:
+    // Привязка framebuffer'ов после создания не меняется. Для рендеринга в Fbo нужно вызвать bind()
     Fbo(glm::ivec2 size);
+    Fbo(const FboParams& params);
 
     // Запрещаем копировать объект, так как если в одной из копий будет вызван деструктор,
     // все другие объекты будут хранить уничтоженный gpu_object_name_
@@ -30,10 +58,17 @@ public:
 
     ~Fbo()
     {
-        glDeleteFramebuffers(1, &gpu_object_name_); // Проверка на 0 не нужна
+        // Проверка на 0 не нужна
+        glDeleteFramebuffers(1, &gpu_object_name_);
+        glDeleteRenderbuffers(1, &color_renderbuffer_);
+        glDeleteRenderbuffers(1, &depth_stencil_renderbuffer_);
         gpu_object_name_ = 0;
     }
 
+    const FboParams& params() const { return params_; }
+    glm::ivec2 size() const { return params_.size; }
+    bool is_multisample() const { return params_.samples > 1; }
+
     Texture* texture() const { return texture_.get(); }
     std::unique_ptr<Texture> move_texture() { return std::move(texture_); }
     GLuint gpu_object_name() const { return gpu_object_name_; }
@@ -42,6 +77,10 @@ public:
     {
         glBindFramebuffer(GL_FRAMEBUFFER, gpu_object_name_);
     }
+
+    // Копирует цвет в target (glBlitFramebuffer). Если этот Fbo мультисэмпловый, то сэмплы усредняются.
+    // Размеры должны совпадать. Меняет привязку GL_READ_FRAMEBUFFER и GL_DRAW_FRAMEBUFFER
+    void resolve(Fbo& target) const;
 };
 
 } // namespace dviglo
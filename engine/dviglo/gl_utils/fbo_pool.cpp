@@ -0,0 +1,119 @@
+// Copyright (c) the Dviglo project
+// License: MIT
+
+#include "fbo_pool.hpp"
+
+#include "../fs/log.hpp"
+
+#include <cassert>
+
+using namespace std;
+
+
+namespace dviglo
+{
+
+FboPool::FboPool()
+{
+    assert(!instance_);
+    instance_ = this;
+
+    DV_LOG->write_debug("FboPool constructed");
+}
+
+FboPool::~FboPool()
+{
+    instance_ = nullptr;
+
+    for (const Entry& entry : entries_)
+    {
+        if (entry.in_use)
+            DV_LOG->write_error("FboPool::~FboPool() | entry.in_use");
+    }
+
+    entries_.clear();
+
+    DV_LOG->write_debug("FboPool destructed");
+}
+
+FboPool::Entry* FboPool::find_entry(const Fbo* fbo)
+{
+    for (Entry& entry : entries_)
+    {
+        if (entry.fbo.get() == fbo)
+            return &entry;
+    }
+
+    return nullptr;
+}
+
+Fbo* FboPool::acquire(const FboParams& params)
+{
+    for (Entry& entry : entries_)
+    {
+        if (!entry.in_use && entry.fbo->params() == params)
+        {
+            entry.in_use = true;
+            entry.last_used_frame = frame_;
+            return entry.fbo.get();
+        }
+    }
+
+    Entry& entry = entries_.emplace_back();
+    entry.fbo = make_unique<Fbo>(params);
+    entry.in_use = true;
+    entry.last_used_frame = frame_;
+
+    return entry.fbo.get();
+}
+
+void FboPool::release(Fbo* fbo)
+{
+    Entry* entry = find_entry(fbo);
+
+    if (!entry || !entry->in_use)
+    {
+        DV_LOG->write_error("FboPool::release(Fbo* fbo) | !entry || !entry->in_use");
+        return;
+    }
+
+    entry->in_use = false;
+
+    // Fbo мог быть выдан давно, поэтому время простоя отсчитывается с возврата
+    entry->last_used_frame = frame_;
+}
+
+Fbo* FboPool::resolve(const Fbo* src)
+{
+    FboParams params;
+    params.size = src->size();
+    params.format = src->params().format;
+
+    Fbo* target = acquire(params);
+    src->resolve(*target);
+
+    return target;
+}
+
+void FboPool::end_frame()
+{
+    // Заменяем удаляемый элемент последним, порядок не важен
+    for (size_t i = 0; i < entries_.size();)
+    {
+        Entry& entry = entries_[i];
+
+        if (!entry.in_use && frame_ - entry.last_used_frame >= max_unused_frames)
+        {
+            entry = std::move(entries_.back());
+            entries_.pop_back();
+        }
+        else
+        {
+            ++i;
+        }
+    }
+
+    ++frame_;
+}
+
+} // namespace dviglo
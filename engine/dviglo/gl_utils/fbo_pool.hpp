@@ -0,0 +1,69 @@
+// Copyright (c) the Dviglo project
+// License: MIT
+
+#pragma once
+
+#include "fbo.hpp"
+
+#include <vector>
+
+
+namespace dviglo
+{
+
+// Пул временных render targets. Позволяет рендерить вне экрана (постобработка, слои интерфейса)
+// без создания и удаления объектов OpenGL каждый кадр: Fbo с одинаковыми параметрами
+// переиспользуются, а долго не используемые удаляются
+class FboPool
+{
+private:
+    // Инициализируется в конструкторе
+    inline static FboPool* instance_ = nullptr;
+
+    struct Entry
+    {
+        std::unique_ptr<Fbo> fbo;
+        bool in_use = false;
+
+        // Номер кадра, в котором Fbo последний раз выдавался или возвращался
+        u64 last_used_frame = 0;
+    };
+
+    std::vector<Entry> entries_;
+
+    // Номер текущего кадра
+    u64 frame_ = 0;
+
+    Entry* find_entry(const Fbo* fbo);
+
+public:
+    // Сколько кадров хранится неиспользуемый Fbo
+    inline static u64 max_unused_frames = 60;
+
+    static FboPool* instance() { return instance_; }
+
+    FboPool();
+    ~FboPool();
+
+    // Возвращает свободный Fbo с такими параметрами или создаёт новый.
+    // Содержимое Fbo не определено (обычно там остался предыдущий кадр).
+    // Fbo нужно вернуть с помощью release(), можно в следующих кадрах
+    Fbo* acquire(const FboParams& params);
+
+    void release(Fbo* fbo);
+
+    // Берёт из пула Fbo без MSAA того же размера и формата и копирует в него цвет из src
+    // (с усреднением сэмплов, если src мультисэмпловый). Результат нужно вернуть с помощью release().
+    // Меняет привязку GL_READ_FRAMEBUFFER и GL_DRAW_FRAMEBUFFER
+    Fbo* resolve(const Fbo* src);
+
+    // Число Fbo в пуле (включая выданные)
+    size_t size() const { return entries_.size(); }
+
+    // Вызывается в конце каждого кадра. Удаляет Fbo, которые не используются max_unused_frames кадров
+    void end_frame();
+};
+
+#define DV_FBO_POOL (dviglo::FboPool::instance())
+
+} // namespace dviglo
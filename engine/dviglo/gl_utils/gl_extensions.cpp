@@ -0,0 +1,71 @@
+// Copyright (c) the Dviglo project
+// License: MIT
+
+#include "gl_extensions.hpp"
+
+#include "../fs/log.hpp"
+
+#include <cstring>
+
+
+namespace dviglo
+{
+
+static bool has_extension(const char* name)
+{
+    GLint num_extensions = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &num_extensions);
+
+    for (GLint i = 0; i < num_extensions; ++i)
+    {
+        const char* extension = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+
+        if (extension && strcmp(extension, name) == 0)
+            return true;
+    }
+
+    return false;
+}
+
+namespace gl_ext
+{
+    void load(GLADloadfunc load_func)
+    {
+        GLint major_version = 0;
+        GLint minor_version = 0;
+        glGetIntegerv(GL_MAJOR_VERSION, &major_version);
+        glGetIntegerv(GL_MINOR_VERSION, &minor_version);
+        bool gl_4_1 = major_version > 4 || (major_version == 4 && minor_version >= 1);
+
+        GLint num_binary_formats = 0;
+
+        if (gl_4_1 || has_extension("GL_ARB_get_program_binary"))
+            glGetIntegerv(num_program_binary_formats, &num_binary_formats);
+
+        // Mesa может поддерживать расширение, но не иметь ни одного формата
+        if (num_binary_formats > 0)
+        {
+            get_program_binary = reinterpret_cast<GetProgramBinaryFunc>(load_func("glGetProgramBinary"));
+            program_binary = reinterpret_cast<ProgramBinaryFunc>(load_func("glProgramBinary"));
+            program_parameteri = reinterpret_cast<ProgramParameteriFunc>(load_func("glProgramParameteri"));
+
+            if (!get_program_binary || !program_binary || !program_parameteri)
+            {
+                get_program_binary = nullptr;
+                program_binary = nullptr;
+                program_parameteri = nullptr;
+            }
+        }
+
+        if (has_extension("GL_KHR_parallel_shader_compile"))
+        {
+            max_shader_compiler_threads =
+                reinterpret_cast<MaxShaderCompilerThreadsFunc>(load_func("glMaxShaderCompilerThreadsKHR"));
+        }
+
+        DV_LOG->writef_info("Program binaries: {}, parallel shader compile: {}",
+                            get_program_binary ? "yes" : "no", max_shader_compiler_threads ? "yes" : "no");
+    }
+}
+
+} // namespace dviglo
@@ -0,0 +1,48 @@
+// Copyright (c) the Dviglo project
+// License: MIT
+
+// Расширения OpenGL, которых нет в glad (он сгенерирован для GL 3.3 Core без расширений,
+// см. third_party/glad/dv_notes.md)
+
+#pragma once
+
+#include <glad/gl.h>
+
+
+namespace dviglo
+{
+
+// Указатели на функции загружаются в OsWindow после gladLoadGL().
+// Если расширение не поддерживается, то указатели равны nullptr
+namespace gl_ext
+{
+    // ============ GL_ARB_get_program_binary (входит в GL 4.1) ============
+
+    inline constexpr GLenum program_binary_retrievable_hint = 0x8257;
+    inline constexpr GLenum program_binary_length = 0x8741;
+    inline constexpr GLenum num_program_binary_formats = 0x87FE;
+
+    using GetProgramBinaryFunc = void (GLAD_API_PTR*)(GLuint program, GLsizei buf_size, GLsizei* length,
+                                                      GLenum* binary_format, void* binary);
+    using ProgramBinaryFunc = void (GLAD_API_PTR*)(GLuint program, GLenum binary_format, const void* binary,
+                                                   GLsizei length);
+    using ProgramParameteriFunc = void (GLAD_API_PTR*)(GLuint program, GLenum pname, GLint value);
+
+    // Также nullptr, если драйвер не поддерживает ни одного формата бинарников
+    inline GetProgramBinaryFunc get_program_binary = nullptr;
+    inline ProgramBinaryFunc program_binary = nullptr;
+    inline ProgramParameteriFunc program_parameteri = nullptr;
+
+    // ================== GL_KHR_parallel_shader_compile ==================
+
+    inline constexpr GLenum completion_status = 0x91B1;
+
+    using MaxShaderCompilerThreadsFunc = void (GLAD_API_PTR*)(GLuint count);
+
+    inline MaxShaderCompilerThreadsFunc max_shader_compiler_threads = nullptr;
+
+    // Вызывается после gladLoadGL()
+    void load(GLADloadfunc load_func);
+}
+
+} // namespace dviglo
@@ -0,0 +1,25 @@
+// Copyright (c) the Dviglo project
+// License: MIT
+
+#include "render_stats.hpp"
+
+#include <format>
+
+using namespace std;
+
+
+namespace dviglo
+{
+
+StrUtf8 RenderStats::csv_header()
+{
+    return "draw_calls,vertices,texture_binds,shader_program_uses,buffer_uploads,buffer_upload_bytes";
+}
+
+StrUtf8 RenderStats::to_csv_row() const
+{
+    return format("{},{},{},{},{},{}", draw_calls, vertices, texture_binds, shader_program_uses,
+                  buffer_uploads, buffer_upload_bytes);
+}
+
+} // namespace dviglo
@@ -0,0 +1,44 @@
+// Copyright (c) the Dviglo project
+// License: MIT
+
+#pragma once
+
+#include "../std_utils/string.hpp"
+
+
+namespace dviglo
+{
+
+// Статистика рендеринга за кадр
+struct RenderStats
+{
+    // Вызовы glDrawArrays() и glDrawElements()
+    u32 draw_calls = 0;
+
+    // Число вершин, отправленных на отрисовку
+    u64 vertices = 0;
+
+    // Вызовы Texture::bind()
+    u32 texture_binds = 0;
+
+    // Вызовы ShaderProgram::use()
+    u32 shader_program_uses = 0;
+
+    // Вызовы VertexBuffer::set_data()
+    u32 buffer_uploads = 0;
+
+    // Сколько байт скопировано в буферы на GPU
+    u64 buffer_upload_bytes = 0;
+
+    // Заголовок для to_csv_row()
+    static StrUtf8 csv_header();
+
+    // Значения через запятую без перевода строки
+    StrUtf8 to_csv_row() const;
+};
+
+// Счётчики текущего кадра. Сбрасываются в Application::main_iterate().
+// Используются только в потоке OpenGL, поэтому не атомарные
+inline RenderStats current_render_stats;
+
+} // namespace dviglo
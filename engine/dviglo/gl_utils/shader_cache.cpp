@@ -3,32 +3,316 @@
 
 #include "shader_cache.hpp"
 
+#include "gl_extensions.hpp"
+#include "../debug/profiler.hpp"
+#include "../fs/file_base.hpp"
+#include "../fs/file_watcher.hpp"
+#include "../fs/fs_base.hpp"
 #include "../fs/log.hpp"
+#include "../main/engine_params.hpp"
+#include "../threading/job_system.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <format>
+
+using namespace std;
 
 
 namespace dviglo
 {
 
+// Заголовок файла с бинарником программы. После заголовка идёт сам бинарник
+struct ProgramBinaryHeader
+{
+    char magic[4] = {'D', 'V', 'P', 'B'};
+    u32 version = 1;
+    u64 hash = 0; // Для защиты от чужих файлов с тем же именем
+    u32 format = 0;
+    u32 size = 0;
+};
+
+// Используется в потоках JobSystem, поэтому не пишет в лог (Log не потокобезопасный)
+static bool read_file_silent(const StrUtf8& path, StrUtf8& out)
+{
+    FILE* fp = file_open(path, "rb");
+
+    if (!fp)
+        return false;
+
+    file_seek(fp, 0, SEEK_END);
+    out.resize(file_tell(fp));
+    file_rewind(fp);
+
+    bool ok = (size_t)file_read(out.data(), 1, (i32)out.size(), fp) == out.size();
+    file_close(fp);
+
+    return ok;
+}
+
+// FNV-1a
+static u64 hash_str(StrViewUtf8 str, u64 hash = 14695981039346656037ull)
+{
+    for (char c : str)
+    {
+        hash ^= (u8)c;
+        hash *= 1099511628211ull;
+    }
+
+    return hash;
+}
+
+static StrUtf8 get_id(const ShaderCache::ProgramPaths& paths)
+{
+    return paths.vertex + "*" + paths.fragment + "*" + paths.geometry;
+}
+
 ShaderProgram* ShaderCache::get(const StrUtf8& vertex_shader_path, const StrUtf8& fragment_shader_path,
                                 const StrUtf8& geometry_shader_path)
 {
-    StrUtf8 id = vertex_shader_path + "*" + fragment_shader_path + "*" + geometry_shader_path;
+    ProgramPaths paths{vertex_shader_path, fragment_shader_path, geometry_shader_path};
+    StrUtf8 id = get_id(paths);
 
     auto it = storage_.find(id);
 
     if (it != storage_.end())
         return it->second;
 
-    ShaderProgram* shader_program = new ShaderProgram(vertex_shader_path, fragment_shader_path, geometry_shader_path);
-    storage_[id] = shader_program;
+    preload({paths});
+
+    return storage_[id];
+}
+
+void ShaderCache::preload(const vector<ProgramPaths>& programs)
+{
+    DV_PROFILE_SCOPE("ShaderCache::preload");
+
+    struct Job
+    {
+        const ProgramPaths* paths;
+        StrUtf8 id;
+        ShaderSources sources;
+        bool sources_ok = false;
+        u64 hash = 0;
+        StrUtf8 cache_path;
+        StrUtf8 cache_data; // Пусто, если в кэше на диске программы нет
+        ShaderProgram* program = nullptr;
+    };
+
+    vector<Job> jobs;
+    jobs.reserve(programs.size());
+
+    for (const ProgramPaths& paths : programs)
+    {
+        StrUtf8 id = get_id(paths);
+
+        if (storage_.contains(id))
+            continue;
+
+        // Программа может повторяться в списке
+        storage_[id] = nullptr;
+        Job& job = jobs.emplace_back();
+        job.paths = &paths;
+        job.id = std::move(id);
+    }
+
+    if (jobs.empty())
+        return;
+
+    // Читаем тексты шейдеров и бинарники
+    auto read_files = [this, &jobs](i32 begin, i32 end)
+    {
+        for (i32 i = begin; i < end; ++i)
+        {
+            Job& job = jobs[i];
+            ShaderSources& sources = job.sources;
+            sources.vertex_path = job.paths->vertex;
+            sources.fragment_path = job.paths->fragment;
+            sources.geometry_path = job.paths->geometry;
+
+            job.sources_ok = read_file_silent(sources.vertex_path, sources.vertex)
+                             && read_file_silent(sources.fragment_path, sources.fragment)
+                             && (sources.geometry_path.empty() || read_file_silent(sources.geometry_path, sources.geometry));
+
+            if (!job.sources_ok || dir_.empty())
+                continue;
+
+            // Нулевой символ отделяет тексты, чтобы перенос текста из одного шейдера в другой менял хеш
+            job.hash = hash_str(driver_id_);
+            job.hash = hash_str(StrViewUtf8(sources.vertex.c_str(), sources.vertex.size() + 1), job.hash);
+            job.hash = hash_str(StrViewUtf8(sources.fragment.c_str(), sources.fragment.size() + 1), job.hash);
+            job.hash = hash_str(sources.geometry, job.hash);
+            job.cache_path = dir_ + format("{:016x}.bin", job.hash);
+
+            if (!read_file_silent(job.cache_path, job.cache_data))
+                job.cache_data.clear();
+        }
+    };
+
+    if (DV_JOB_SYSTEM)
+        DV_JOB_SYSTEM->parallel_for(0, (i32)jobs.size(), 1, read_files);
+    else
+        read_files(0, (i32)jobs.size());
 
-    return shader_program;
+    vector<Job*> compiled_jobs;
+
+    for (Job& job : jobs)
+    {
+        job.program = new ShaderProgram();
+        storage_[job.id] = job.program;
+
+        if (DV_FILE_WATCHER)
+        {
+            DV_FILE_WATCHER->add(job.paths->vertex);
+            DV_FILE_WATCHER->add(job.paths->fragment);
+
+            if (!job.paths->geometry.empty())
+                DV_FILE_WATCHER->add(job.paths->geometry);
+
+            watched_.emplace_back(*job.paths, job.program);
+        }
+
+        if (!job.sources_ok)
+        {
+            // Программа остаётся невалидной, как и при ошибке компиляции
+            DV_LOG->writef_error("ShaderCache::preload(): !job.sources_ok | {}", job.id);
+            continue;
+        }
+
+        if (job.cache_data.size() > sizeof(ProgramBinaryHeader))
+        {
+            ProgramBinaryHeader header;
+            memcpy(&header, job.cache_data.data(), sizeof(header));
+
+            if (memcmp(header.magic, ProgramBinaryHeader().magic, sizeof(header.magic)) == 0
+                && header.version == ProgramBinaryHeader().version && header.hash == job.hash
+                && header.size == job.cache_data.size() - sizeof(header)
+                && job.program->load_binary(header.format, job.cache_data.data() + sizeof(header), header.size))
+            {
+                continue;
+            }
+
+            // Драйвер отклонил бинарник (обычно после обновления). Файл будет перезаписан
+            DV_LOG->writef_debug("ShaderCache::preload(): binary rejected | {}", job.id);
+        }
+
+        job.program->start_build(job.sources);
+        compiled_jobs.push_back(&job);
+    }
+
+    // Пока драйвер компилирует шейдеры в своих потоках, мы не ждём каждую программу по отдельности
+    for (Job* job : compiled_jobs)
+    {
+        job->program->finish_build();
+
+        if (dir_.empty() || !job->program->is_valid())
+            continue;
+
+        GLenum format = 0;
+        vector<byte> binary = job->program->get_binary(format);
+
+        if (binary.empty())
+            continue;
+
+        ProgramBinaryHeader header;
+        header.hash = job->hash;
+        header.format = format;
+        header.size = (u32)binary.size();
+
+        FILE* fp = file_open(job->cache_path, "wb");
+
+        if (!fp)
+        {
+            DV_LOG->writef_warning("ShaderCache::preload(): !fp | path = \"{}\"", job->cache_path);
+            continue;
+        }
+
+        file_write(&header, sizeof(header), 1, fp);
+        file_write(binary.data(), 1, (i32)binary.size(), fp);
+        file_close(fp);
+    }
+}
+
+void ShaderCache::hot_reload(const vector<StrUtf8>& changed_files)
+{
+    auto is_changed = [&changed_files](const StrUtf8& path)
+    {
+        return !path.empty() && find(changed_files.begin(), changed_files.end(), path) != changed_files.end();
+    };
+
+    for (const auto& [paths, program] : watched_)
+    {
+        if (!is_changed(paths.vertex) && !is_changed(paths.fragment) && !is_changed(paths.geometry))
+            continue;
+
+        ShaderSources sources;
+        sources.vertex_path = paths.vertex;
+        sources.fragment_path = paths.fragment;
+        sources.geometry_path = paths.geometry;
+
+        // Редактор мог ещё не дописать файл. Тогда придёт ещё одно уведомление
+        if (!read_file_silent(sources.vertex_path, sources.vertex)
+            || !read_file_silent(sources.fragment_path, sources.fragment)
+            || (!sources.geometry_path.empty() && !read_file_silent(sources.geometry_path, sources.geometry)))
+        {
+            DV_LOG->writef_warning("ShaderCache::hot_reload(): can't read {} + {}", paths.vertex, paths.fragment);
+            continue;
+        }
+
+        // Незаконченная перекомпиляция этой же программы больше не нужна
+        erase_if(reloads_, [program](const Reload& reload) { return reload.target == program; });
+
+        Reload& reload = reloads_.emplace_back();
+        reload.target = program;
+        reload.name = paths.vertex + " + " + paths.fragment;
+        reload.program.start_build(sources);
+    }
+
+    for (size_t i = 0; i < reloads_.size();)
+    {
+        Reload& reload = reloads_[i];
+
+        if (!reload.program.is_build_complete())
+        {
+            ++i;
+            continue;
+        }
+
+        reload.program.finish_build(); // Ошибки выведены в лог
+
+        if (reload.program.is_valid())
+        {
+            *reload.target = std::move(reload.program);
+            DV_LOG->writef_info("ShaderCache::hot_reload(): {}", reload.name);
+        }
+        else
+            DV_LOG->writef_warning("ShaderCache::hot_reload(): old program is kept | {}", reload.name);
+
+        reloads_.erase(reloads_.begin() + i);
+    }
 }
 
 ShaderCache::ShaderCache()
 {
     assert(!instance_);
     instance_ = this;
+
+    if (gl_ext::get_program_binary && !engine_params::shader_cache_dir.empty())
+    {
+        if (dir_exists(engine_params::shader_cache_dir) || create_dir_silent(engine_params::shader_cache_dir))
+            dir_ = engine_params::shader_cache_dir;
+        else
+            DV_LOG->writef_warning("ShaderCache::ShaderCache(): can't create \"{}\"", engine_params::shader_cache_dir);
+
+        driver_id_ = StrUtf8(reinterpret_cast<const char*>(glGetString(GL_VENDOR))) + '\0'
+                     + reinterpret_cast<const char*>(glGetString(GL_RENDERER)) + '\0'
+                     + reinterpret_cast<const char*>(glGetString(GL_VERSION)) + '\0';
+    }
+
+    // Разрешаем драйверу компилировать шейдеры в стольких потоках, сколько он сочтёт нужным
+    if (gl_ext::max_shader_compiler_threads)
+        gl_ext::max_shader_compiler_threads(0xFFFFFFFF);
+
     DV_LOG->write_debug("ShaderCache constructed");
 }
 
@@ -8,19 +8,58 @@
 #include "../std_utils/string.hpp"
 
 #include <unordered_map>
+#include <vector>
 
 
 namespace dviglo
 {
 
+// Хранит шейдерные программы. Слинкованные программы сохраняются на диск
+// (в engine_params::shader_cache_dir), чтобы при следующем запуске не компилировать их заново.
+// Ключ кэша - хеш текстов шейдеров, GL_VENDOR, GL_RENDERER и GL_VERSION, поэтому после
+// изменения шейдеров или обновления драйвера программы компилируются заново
 class ShaderCache
 {
+public:
+    struct ProgramPaths
+    {
+        StrUtf8 vertex;
+        StrUtf8 fragment;
+        StrUtf8 geometry;
+
+        // Геометрический шейдер может отсутствовать
+        ProgramPaths(const StrUtf8& vertex_path, const StrUtf8& fragment_path,
+                     const StrUtf8& geometry_path = StrUtf8())
+            : vertex(vertex_path), fragment(fragment_path), geometry(geometry_path)
+        {
+        }
+    };
+
 private:
     // Инициализируется в конструкторе
     inline static ShaderCache* instance_ = nullptr;
 
     std::unordered_map<StrUtf8, ShaderProgram*> storage_;
 
+    // Пустая строка, если кэш на диске выключен или бинарники программ не поддерживаются
+    StrUtf8 dir_;
+
+    // Добавляется к хешу текстов шейдеров
+    StrUtf8 driver_id_;
+
+    // Программы, файлы которых отслеживаются DV_FILE_WATCHER
+    std::vector<std::pair<ProgramPaths, ShaderProgram*>> watched_;
+
+    // Новая версия программы, которая компилируется после изменения файлов
+    struct Reload
+    {
+        ShaderProgram* target = nullptr;
+        ShaderProgram program;
+        StrUtf8 name; // Для лога
+    };
+
+    std::vector<Reload> reloads_;
+
 public:
     static ShaderCache* instance() { return instance_; }
 
@@ -29,6 +68,18 @@ public:
 
     ShaderProgram* get(const StrUtf8& vertex_shader_path, const StrUtf8& fragment_shader_path,
                        const StrUtf8& geometry_shader_path = StrUtf8());
+
+    // Загружает сразу несколько программ (например при запуске игры).
+    // Файлы читаются параллельно с помощью DV_JOB_SYSTEM, а программы, которых нет в кэше на диске,
+    // компилируются драйвером параллельно, если он поддерживает GL_KHR_parallel_shader_compile.
+    // Уже загруженные программы пропускаются
+    void preload(const std::vector<ProgramPaths>& programs);
+
+    // Начинает перекомпиляцию программ, файлы которых изменились, и подменяет программы,
+    // которые уже скомпилированы. Если при компиляции произошла ошибка, то остаётся старая программа.
+    // Указатели, возвращённые get(), остаются валидными.
+    // Вызывается в главном потоке в начале кадра
+    void hot_reload(const std::vector<StrUtf8>& changed_files);
 };
 
 #define DV_SHADER_CACHE (dviglo::ShaderCache::instance())
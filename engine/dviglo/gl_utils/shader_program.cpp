@@ -3,27 +3,31 @@
 
 #include "shader_program.hpp"
 
+#include "gl_extensions.hpp"
+#include "../debug/profiler.hpp"
 #include "../fs/file.hpp"
 #include "../fs/log.hpp"
 
+using namespace std;
+
 
 namespace dviglo
 {
 
-// Возвращает ID скомпилированного шейдера или ноль в случае ошибки
-static GLuint compile_shader(const StrUtf8& file_path, GLenum type)
+// Отправляет шейдер на компиляцию, не дожидаясь результата
+static GLuint start_compile_shader(const StrUtf8& src, GLenum type)
 {
-    StrUtf8 src = read_all_text(file_path); // Читаем файл
-
-    if (src.empty())
-        return 0; // Если не удалось прочесть файл, сообщение об ошибке уже выведено в лог
-
-    // Компилируем шейдер
     GLuint gpu_object_name = glCreateShader(type);
     const char* src_c_str = src.c_str();
     glShaderSource(gpu_object_name, 1, &src_c_str, nullptr);
     glCompileShader(gpu_object_name);
 
+    return gpu_object_name;
+}
+
+// Дожидается компиляции шейдера и выводит лог компилятора. Возвращает false в случае ошибки
+static bool check_shader(GLuint gpu_object_name, const StrUtf8& file_path)
+{
     // Успешно ли прошла компиляция
     GLint success;
     glGetShaderiv(gpu_object_name, GL_COMPILE_STATUS, &success);
@@ -44,94 +48,183 @@ static GLuint compile_shader(const StrUtf8& file_path, GLenum type)
             DV_LOG->write_error(file_path + " | " + msg);
     }
 
-    if (success)
-    {
-        return gpu_object_name;
-    }
-    else
-    {
-        glDeleteShader(gpu_object_name);
-        return 0;
-    }
+    return success;
 }
 
 ShaderProgram::ShaderProgram(const StrUtf8& vertex_shader_path, const StrUtf8& fragment_shader_path,
                              const StrUtf8& geometry_shader_path)
 {
-    GLuint vertex_shader = compile_shader(vertex_shader_path, GL_VERTEX_SHADER);
+    DV_PROFILE_SCOPE("ShaderProgram::ShaderProgram");
 
-    if (!vertex_shader)
-        return;
+    ShaderSources sources;
+    sources.vertex_path = vertex_shader_path;
+    sources.fragment_path = fragment_shader_path;
+    sources.geometry_path = geometry_shader_path;
 
-    GLuint fragment_shader = compile_shader(fragment_shader_path, GL_FRAGMENT_SHADER);
+    // Если не удалось прочесть файл, сообщение об ошибке уже выведено в лог
+    sources.vertex = read_all_text(vertex_shader_path);
 
-    if (!fragment_shader)
-    {
-        glDeleteShader(vertex_shader);
+    if (sources.vertex.empty())
         return;
-    }
 
-    GLuint geometry_shader = 0;
+    sources.fragment = read_all_text(fragment_shader_path);
+
+    if (sources.fragment.empty())
+        return;
 
     if (!geometry_shader_path.empty()) // Геометрический шейдер может отсутствовать
     {
-        geometry_shader = compile_shader(geometry_shader_path, GL_GEOMETRY_SHADER);
+        sources.geometry = read_all_text(geometry_shader_path);
 
-        if (!geometry_shader)
-        {
-            glDeleteShader(vertex_shader);
-            glDeleteShader(fragment_shader);
+        if (sources.geometry.empty())
             return;
-        }
     }
 
-    // Линкуем все шейдеры в шейдерную программу
+    start_build(sources);
+    finish_build();
+}
+
+void ShaderProgram::start_build(const ShaderSources& sources)
+{
+    paths_ = {sources.vertex_path, sources.fragment_path, sources.geometry_path};
+
+    pending_shaders_[0] = start_compile_shader(sources.vertex, GL_VERTEX_SHADER);
+    pending_shaders_[1] = start_compile_shader(sources.fragment, GL_FRAGMENT_SHADER);
+
+    if (!sources.geometry.empty())
+        pending_shaders_[2] = start_compile_shader(sources.geometry, GL_GEOMETRY_SHADER);
+
+    // Линкуем все шейдеры в шейдерную программу. Результат компиляции проверим в finish_build().
+    // Если компиляция не удалась, то не удастся и линковка
     gpu_object_name_ = glCreateProgram();
-    glAttachShader(gpu_object_name_, vertex_shader);
-    glAttachShader(gpu_object_name_, fragment_shader);
 
-    if (geometry_shader)
-        glAttachShader(gpu_object_name_, geometry_shader);
+    // Просим драйвер сохранить бинарник программы, чтобы потом его можно было получить
+    if (gl_ext::program_parameteri)
+        gl_ext::program_parameteri(gpu_object_name_, gl_ext::program_binary_retrievable_hint, GL_TRUE);
+
+    for (GLuint shader : pending_shaders_)
+    {
+        if (shader)
+            glAttachShader(gpu_object_name_, shader);
+    }
 
     glLinkProgram(gpu_object_name_);
+}
+
+bool ShaderProgram::is_build_complete() const
+{
+    if (!gpu_object_name_ || !gl_ext::max_shader_compiler_threads)
+        return true;
+
+    GLint complete = GL_TRUE;
+    glGetProgramiv(gpu_object_name_, gl_ext::completion_status, &complete);
+
+    return complete;
+}
+
+void ShaderProgram::finish_build()
+{
+    DV_PROFILE_SCOPE("ShaderProgram::finish_build");
+
+    if (!gpu_object_name_)
+        return;
+
+    bool shaders_ok = true;
+
+    for (size_t i = 0; i < pending_shaders_.size(); ++i)
+    {
+        if (pending_shaders_[i])
+            shaders_ok = check_shader(pending_shaders_[i], paths_[i]) && shaders_ok;
+    }
 
     // Успешно ли прошла линковка
     GLint success;
     glGetProgramiv(gpu_object_name_, GL_LINK_STATUS, &success);
 
-    // Компоновщик может выдавать предупреждения, поэтому проверяем лог даже при успешной линковке
-    GLint log_buffer_size; // Длина строки + нуль-терминатор
-    glGetProgramiv(gpu_object_name_, GL_INFO_LOG_LENGTH, &log_buffer_size);
-
-    if (log_buffer_size)
+    // Ошибки компиляции уже выведены в лог, а лог линковщика в этом случае бесполезен
+    if (shaders_ok)
     {
-        StrUtf8 msg(log_buffer_size - 1, '\0');
-        glGetProgramInfoLog(gpu_object_name_, log_buffer_size, nullptr, msg.data());
-        trim_end_chars(msg, "\n"); // Удаляем перевод строки в конце
+        // Компоновщик может выдавать предупреждения, поэтому проверяем лог даже при успешной линковке
+        GLint log_buffer_size; // Длина строки + нуль-терминатор
+        glGetProgramiv(gpu_object_name_, GL_INFO_LOG_LENGTH, &log_buffer_size);
 
-        StrUtf8 out_message = vertex_shader_path + " + " + fragment_shader_path;
+        if (log_buffer_size)
+        {
+            StrUtf8 msg(log_buffer_size - 1, '\0');
+            glGetProgramInfoLog(gpu_object_name_, log_buffer_size, nullptr, msg.data());
+            trim_end_chars(msg, "\n"); // Удаляем перевод строки в конце
 
-        if (geometry_shader)
-            out_message += " + " + geometry_shader_path;
+            StrUtf8 out_message = paths_[0] + " + " + paths_[1];
 
-        out_message += " | " + msg;
+            if (!paths_[2].empty())
+                out_message += " + " + paths_[2];
 
-        if (success)
-            DV_LOG->write_warning(out_message);
-        else
-            DV_LOG->write_error(out_message);
+            out_message += " | " + msg;
+
+            if (success)
+                DV_LOG->write_warning(out_message);
+            else
+                DV_LOG->write_error(out_message);
+        }
     }
 
     // Шейдеры после линковки не нужны
-    glDeleteShader(vertex_shader);
-    glDeleteShader(fragment_shader);
-    glDeleteShader(geometry_shader); // Проверка на 0 не нужна
+    for (GLuint& shader : pending_shaders_)
+    {
+        glDeleteShader(shader); // Проверка на 0 не нужна
+        shader = 0;
+    }
+
+    if (!success)
+    {
+        glDeleteProgram(gpu_object_name_);
+        gpu_object_name_ = 0;
+    }
+}
+
+bool ShaderProgram::load_binary(GLenum format, const void* data, GLsizei size)
+{
+    if (!gl_ext::program_binary)
+        return false;
+
+    glDeleteProgram(gpu_object_name_);
+    gpu_object_name_ = glCreateProgram();
+
+    // Программу из бинарника тоже можно будет сохранить
+    gl_ext::program_parameteri(gpu_object_name_, gl_ext::program_binary_retrievable_hint, GL_TRUE);
+    gl_ext::program_binary(gpu_object_name_, format, data, size);
+
+    GLint success;
+    glGetProgramiv(gpu_object_name_, GL_LINK_STATUS, &success);
 
     if (!success)
     {
         glDeleteProgram(gpu_object_name_);
         gpu_object_name_ = 0;
     }
+
+    return success;
+}
+
+vector<byte> ShaderProgram::get_binary(GLenum& format) const
+{
+    vector<byte> ret;
+
+    if (!gl_ext::get_program_binary || !gpu_object_name_)
+        return ret;
+
+    GLint size = 0;
+    glGetProgramiv(gpu_object_name_, gl_ext::program_binary_length, &size);
+
+    if (size <= 0)
+        return ret;
+
+    ret.resize(size);
+    GLsizei written = 0;
+    gl_ext::get_program_binary(gpu_object_name_, size, &written, &format, ret.data());
+    ret.resize(written);
+
+    return ret;
 }
 
 } // namespace dviglo
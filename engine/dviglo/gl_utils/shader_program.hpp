@@ -3,32 +3,58 @@
 
 #pragma once
 
+#include "render_stats.hpp"
+
 #include "../std_utils/string.hpp"
 
 #include <glad/gl.h>
 #include <glm/glm.hpp>
 
+#include <array>
 #include <utility> // std::exchange()
+#include <vector>
 
 
 namespace dviglo
 {
 
+// Тексты шейдеров программы. Пути нужны только для сообщений в логе
+struct ShaderSources
+{
+    StrUtf8 vertex_path;
+    StrUtf8 fragment_path;
+    StrUtf8 geometry_path; // Может быть пустым
+
+    StrUtf8 vertex;
+    StrUtf8 fragment;
+    StrUtf8 geometry; // Пусто, если геометрического шейдера нет
+};
+
 class ShaderProgram
 {
 private:
     // Идентификатор объекта OpenGL
     GLuint gpu_object_name_ = 0;
 
+    // Шейдеры, отправленные на компиляцию в start_build() и ещё не проверенные в finish_build()
+    std::array<GLuint, 3> pending_shaders_{};
+
+    // Пути к шейдерам для сообщений в логе
+    std::array<StrUtf8, 3> paths_;
+
 public:
     ShaderProgram() = default;
 
-    // Геометрический шейдер может отсутствовать
+    // Геометрический шейдер может отсутствовать.
+    // Компилирует программу сразу (то же, что start_build() + finish_build())
     ShaderProgram(const StrUtf8& vertex_shader_path, const StrUtf8& fragment_shader_path,
                   const StrUtf8& geometry_shader_path = StrUtf8());
 
     ~ShaderProgram()
     {
+        for (GLuint shader : pending_shaders_)
+            glDeleteShader(shader); // Проверка на 0 не нужна
+
         glDeleteProgram(gpu_object_name_); // Проверка на 0 не нужна
     }
 
@@ -41,19 +67,54 @@ public:
 
     ShaderProgram(ShaderProgram&& other) noexcept
         : gpu_object_name_(std::exchange(other.gpu_object_name_, 0))
+        , pending_shaders_(std::exchange(other.pending_shaders_, {}))
+        , paths_(std::move(other.paths_))
     {
     }
 
     ShaderProgram& operator=(ShaderProgram&& other) noexcept
     {
         if (this != &other)
+        {
+            for (GLuint shader : pending_shaders_)
+                glDeleteShader(shader);
+
+            glDeleteProgram(gpu_object_name_);
+
             gpu_object_name_ = std::exchange(other.gpu_object_name_, 0);
+            pending_shaders_ = std::exchange(other.pending_shaders_, {});
+            paths_ = std::move(other.paths_);
+        }
 
         return *this;
     }
 
+    // Отправляет шейдеры на компиляцию и линковку, не дожидаясь результата.
+    // Если драйвер поддерживает GL_KHR_parallel_shader_compile, то несколько программ
+    // компилируются параллельно: сначала нужно вызвать start_build() для всех программ,
+    // а потом finish_build() для каждой
+    void start_build(const ShaderSources& sources);
+
+    // Закончил ли драйвер компиляцию, начатую в start_build(). Без GL_KHR_parallel_shader_compile
+    // всегда true (finish_build() будет ждать)
+    bool is_build_complete() const;
+
+    // Дожидается окончания компиляции, выводит ошибки и предупреждения в лог.
+    // В случае ошибки программа становится невалидной
+    void finish_build();
+
+    // Создаёт программу из бинарника, полученного от get_binary().
+    // Драйвер может отклонить бинарник (например после обновления), тогда возвращает false
+    bool load_binary(GLenum format, const void* data, GLsizei size);
+
+    // Возвращает пустой вектор, если бинарники не поддерживаются
+    std::vector<byte> get_binary(GLenum& format) const;
+
+    bool is_valid() const { return gpu_object_name_ != 0; }
+
     void use() const
     {
+        ++current_render_stats.shader_program_uses;
         glUseProgram(gpu_object_name_);
     }
 
@@ -3,6 +3,7 @@
 
 #include "texture.hpp"
 
+#include "../debug/profiler.hpp"
 #include "../fs/log.hpp"
 
 #include <pugixml.hpp>
@@ -88,6 +89,8 @@ static TextureParams try_load_xml(const StrUtf8& xml_file_path)
 
 Texture::Texture(const StrUtf8& file_path)
 {
+    DV_PROFILE_SCOPE("Texture::Texture(file_path)");
+
     shared_ptr<Image> image = make_shared<Image>(file_path, true);
 
     GLenum img_format;
@@ -107,12 +110,12 @@ Texture::Texture(const StrUtf8& file_path)
     set_params(try_load_xml(file_path + ".xml"));
 }
 
-Texture::Texture(ivec2 size)
+Texture::Texture(ivec2 size, GLenum internal_format)
     : size_(size)
 {
     glGenTextures(1, &gpu_object_name_);
     glBindTexture(GL_TEXTURE_2D, gpu_object_name_);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, size.x, size.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexImage2D(GL_TEXTURE_2D, 0, internal_format, size.x, size.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
     glGenerateMipmap(GL_TEXTURE_2D);
 }
 
@@ -173,6 +176,32 @@ Texture::Texture(shared_ptr<Image> image, bool keep_ptr)
         image_ = image;
 }
 
+bool Texture::reload(shared_ptr<Image> image, const StrUtf8& file_path)
+{
+    DV_PROFILE_SCOPE("Texture::reload()");
+
+    if (image->empty() || (image->num_components() != 3 && image->num_components() != 4))
+        return false;
+
+    GLenum img_format = (image->num_components() == 3) ? GL_RGB : GL_RGBA;
+
+    size_ = image->size();
+
+    // Если раньше изображение хранилось, то храним новое
+    if (image_)
+        image_ = image;
+
+    // Заново задаём содержимое существующего объекта (размер тоже может измениться),
+    // чтобы указатели и идентификаторы, которые хранят пользователи, оставались валидными
+    glBindTexture(GL_TEXTURE_2D, gpu_object_name_);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, size_.x, size_.y, 0, img_format, GL_UNSIGNED_BYTE, image->data());
+    glGenerateMipmap(GL_TEXTURE_2D);
+    set_params(try_load_xml(file_path + ".xml"));
+    ++revision_;
+
+    return true;
+}
+
 void Texture::from_error_image()
 {
     size_ = error_image.size();
@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include "render_stats.hpp"
+
 #include "../res/image.hpp"
 
 #include <glad/gl.h>
@@ -26,6 +28,9 @@ private:
     glm::ivec2 size_;
     std::shared_ptr<Image> image_; // Картинка, из которой была загружена текстура
 
+    // Увеличивается при каждой перезагрузке (см. reload())
+    u32 revision_ = 0;
+
     // Если что-то пошло не так, то используем шахматную текстуру
     void from_error_image();
 
@@ -42,8 +47,9 @@ public:
     // Загружает тестуру из файла
     Texture(const StrUtf8& file_path);
 
-    // Создаёт пустую RGBA текстуру нужного размера
-    Texture(glm::ivec2 size);
+    // Создаёт пустую текстуру нужного размера.
+    // internal_format - цветовой формат (например GL_RGBA16F), но не целочисленный
+    Texture(glm::ivec2 size, GLenum internal_format = GL_RGBA8);
 
     // Создаёт текстуру из изображения
     Texture(const Image& image);
@@ -66,6 +72,7 @@ public:
     Texture(Texture&& other) noexcept
         : gpu_object_name_(std::exchange(other.gpu_object_name_, 0))
         , size_(std::exchange(other.size_, {}))
+        , revision_(std::exchange(other.revision_, 0))
     {
     }
 
@@ -75,11 +82,21 @@ public:
         {
             gpu_object_name_ = std::exchange(other.gpu_object_name_, 0);
             size_ = std::exchange(other.size_, {});
+            revision_ = std::exchange(other.revision_, 0);
         }
 
         return *this;
     }
 
+    // Заменяет содержимое текстуры заново загруженным из file_path изображением
+    // (параметры тоже перечитываются из file_path + ".xml"). Используется для горячей перезагрузки.
+    // Если изображение не подходит, то текстура не меняется и возвращается false.
+    // gpu_object_name() при этом не меняется, а revision() увеличивается
+    bool reload(std::shared_ptr<Image> image, const StrUtf8& file_path);
+
+    // Позволяет заметить, что содержимое текстуры (и, возможно, размер) изменилось
+    u32 revision() const { return revision_; }
+
     glm::ivec2 size() const { return size_; }
     i32 width() const { return size_.x; }
     i32 height() const { return size_.y; }
@@ -88,6 +105,7 @@ public:
 
     void bind()
     {
+        ++current_render_stats.texture_binds;
         glBindTexture(GL_TEXTURE_2D, gpu_object_name_);
     }
 
@@ -3,6 +3,7 @@
 
 #include "texture_cache.hpp"
 
+#include "../fs/file_watcher.hpp"
 #include "../fs/log.hpp"
 
 #include <cassert>
@@ -25,6 +26,15 @@ TextureCache::~TextureCache()
 {
     instance_ = nullptr;
 
+    // Задачи ссылаются на reloads_
+    for (const unique_ptr<Reload>& reload : reloads_)
+    {
+        if (!reload->counter.is_done())
+            DV_JOB_SYSTEM->wait(reload->counter);
+    }
+
+    reloads_.clear();
+
     for (const auto& pair : umap_storage_)
     {
         if (pair.second.use_count() != 1)
@@ -53,6 +63,12 @@ std::shared_ptr<Texture> TextureCache::get(const StrUtf8& file_path)
     shared_ptr<Texture> texture = make_shared<Texture>(file_path);
     umap_storage_[file_path] = texture;
 
+    if (DV_FILE_WATCHER)
+    {
+        DV_FILE_WATCHER->add(file_path);
+        DV_FILE_WATCHER->add(file_path + ".xml");
+    }
+
     return texture;
 }
 
@@ -74,4 +90,44 @@ void TextureCache::remove(std::shared_ptr<Texture> texture)
     vec_storage_.pop_back();
 }
 
+void TextureCache::hot_reload(const vector<StrUtf8>& changed_files)
+{
+    for (const StrUtf8& changed_file : changed_files)
+    {
+        StrUtf8 path = changed_file;
+
+        if (path.ends_with(".xml"))
+            path.resize(path.size() - 4);
+
+        if (!umap_storage_.contains(path))
+            continue;
+
+        Reload* reload = reloads_.emplace_back(make_unique<Reload>()).get();
+        reload->path = path;
+
+        // Image пишет в лог, если не удалось загрузить файл
+        auto decode = [reload] { reload->image = make_shared<Image>(reload->path); };
+
+        if (DV_JOB_SYSTEM)
+            DV_JOB_SYSTEM->run(decode, &reload->counter);
+        else
+            decode();
+    }
+
+    // Применяем по порядку, чтобы более старая версия файла не заменила более новую
+    size_t num_done = 0;
+
+    for (; num_done < reloads_.size() && reloads_[num_done]->counter.is_done(); ++num_done)
+    {
+        Reload& reload = *reloads_[num_done];
+
+        if (umap_storage_[reload.path]->reload(reload.image, reload.path))
+            DV_LOG->writef_info("TextureCache::hot_reload(): {}", reload.path);
+        else
+            DV_LOG->writef_warning("TextureCache::hot_reload(): old texture is kept | {}", reload.path);
+    }
+
+    reloads_.erase(reloads_.begin(), reloads_.begin() + num_done);
+}
+
 } // namespace dviglo
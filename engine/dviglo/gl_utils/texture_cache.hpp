@@ -5,6 +5,8 @@
 
 #include "texture.hpp"
 
+#include "../threading/job_system.hpp"
+
 #include <unordered_map>
 
 
@@ -22,6 +24,17 @@ private:
     std::unordered_map<StrUtf8, std::shared_ptr<Texture>> umap_storage_;
     std::vector<std::shared_ptr<Texture>> vec_storage_;
 
+    // Изображение, которое декодируется после изменения файла текстуры
+    struct Reload
+    {
+        StrUtf8 path;
+        std::shared_ptr<Image> image;
+        JobCounter counter;
+    };
+
+    // В порядке изменения файлов. unique_ptr, так как задачи хранят указатель на Reload
+    std::vector<std::unique_ptr<Reload>> reloads_;
+
 public:
     static TextureCache* instance() { return instance_; }
 
@@ -36,6 +49,12 @@ public:
     // Убирает текстуру из vec_storage_. Не вызывает деструктор.
     // Меняет порядок элементов в vec_storage_
     void remove(std::shared_ptr<Texture> texture);
+
+    // Начинает декодировать изменённые файлы текстур из umap_storage_ (в задачах DV_JOB_SYSTEM)
+    // и обновляет текстуры, изображения для которых уже декодированы. Изменение file_path + ".xml"
+    // тоже перезагружает текстуру. Если файл не удалось загрузить, то текстура не меняется.
+    // Вызывается в главном потоке в начале кадра
+    void hot_reload(const std::vector<StrUtf8>& changed_files);
 };
 
 #define DV_TEXTURE_CACHE (dviglo::TextureCache::instance())
@@ -3,6 +3,8 @@
 
 #include "vertex_buffer.hpp"
 
+#include "render_stats.hpp"
+
 
 namespace dviglo
 {
@@ -122,8 +124,12 @@ void VertexBuffer::set_data(GLsizei num_vertices, const void* data)
     // TODO: Добавить проверки
     glBindVertexArray(vao_);
     glBindBuffer(GL_ARRAY_BUFFER, vbo_);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, calc_vertex_size(vertex_attributes_) * num_vertices, data);
+    GLsizeiptr data_size = calc_vertex_size(vertex_attributes_) * num_vertices;
+    glBufferSubData(GL_ARRAY_BUFFER, 0, data_size, data);
     num_vertices_ = num_vertices;
+
+    ++current_render_stats.buffer_uploads;
+    current_render_stats.buffer_upload_bytes += data_size;
 }
 
 void VertexBuffer::bind()
@@ -0,0 +1,101 @@
+// Copyright (c) the Dviglo project
+// License: MIT
+
+#include "cached_layer.hpp"
+
+#include "../debug/profiler.hpp"
+#include "../gl_utils/gl_utils.hpp"
+
+using namespace glm;
+using namespace std;
+
+
+namespace dviglo
+{
+
+CachedLayer::CachedLayer(const IntRect& area)
+    : area_(area)
+{
+    fbo_ = make_unique<Fbo>(area.size);
+
+    // Слой выводится пиксель в пиксель
+    fbo_->texture()->set_params({.min_filter = GL_NEAREST, .mag_filter = GL_NEAREST});
+}
+
+void CachedLayer::set_dirty(const IntRect& rect)
+{
+    if (fully_dirty_)
+        return;
+
+    // Обрезаем по границам слоя
+    ivec2 begin = glm::max(rect.pos, area_.pos);
+    ivec2 end = glm::min(rect.pos + rect.size, area_.pos + area_.size);
+
+    if (begin.x >= end.x || begin.y >= end.y)
+        return;
+
+    if (has_dirty_rect_)
+    {
+        begin = glm::min(begin, dirty_rect_.pos);
+        end = glm::max(end, dirty_rect_.pos + dirty_rect_.size);
+    }
+
+    dirty_rect_ = IntRect(begin, end - begin);
+    has_dirty_rect_ = true;
+}
+
+void CachedLayer::draw(SpriteBatch* sprite_batch, const function<void(SpriteBatch*)>& draw_func)
+{
+    if (is_dirty())
+    {
+        DV_PROFILE_SCOPE("CachedLayer::draw(): redraw");
+
+        sprite_batch->flush();
+
+        // Запоминаем состояние, которое меняем
+        GLint prev_framebuffer;
+        glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &prev_framebuffer);
+        IntRect prev_viewport = get_viewport();
+        vec4 prev_clear_color;
+        glGetFloatv(GL_COLOR_CLEAR_VALUE, &prev_clear_color[0]);
+
+        fbo_->bind();
+
+        // Сдвигаем viewport, чтобы левый верхний угол слоя попал в начало текстуры.
+        // При вертикальном отражении строки текстуры совпадают с координатой y экрана
+        glViewport(-area_.pos.x, -area_.pos.y, area_.size.x, area_.size.y);
+
+        if (!fully_dirty_)
+        {
+            glEnable(GL_SCISSOR_TEST);
+            glScissor(dirty_rect_.pos.x - area_.pos.x, dirty_rect_.pos.y - area_.pos.y,
+                      dirty_rect_.size.x, dirty_rect_.size.y);
+        }
+
+        glClearColor(0.f, 0.f, 0.f, 0.f);
+        glClear(GL_COLOR_BUFFER_BIT);
+
+        // В текстуре храним цвет, умноженный на альфу, иначе полупрозрачные пиксели
+        // после двойного смешения (в слой и на экран) станут темнее
+        sprite_batch->prepare_ogl(true, true);
+        glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+        draw_func(sprite_batch);
+        sprite_batch->flush();
+
+        glDisable(GL_SCISSOR_TEST);
+        glBindFramebuffer(GL_FRAMEBUFFER, (GLuint)prev_framebuffer);
+        glViewport(prev_viewport.pos.x, prev_viewport.pos.y, prev_viewport.size.x, prev_viewport.size.y);
+        glClearColor(prev_clear_color.r, prev_clear_color.g, prev_clear_color.b, prev_clear_color.a);
+
+        fully_dirty_ = false;
+        has_dirty_rect_ = false;
+    }
+
+    // Выводим слой
+    sprite_batch->prepare_ogl();
+    glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+    sprite_batch->draw_sprite(fbo_->texture(), Rect(area_));
+    sprite_batch->prepare_ogl(); // Выводит спрайт и восстанавливает смешение
+}
+
+} // namespace dviglo
@@ -0,0 +1,57 @@
+// Copyright (c) the Dviglo project
+// License: MIT
+
+#pragma once
+
+#include "sprite_batch.hpp"
+
+#include "../gl_utils/fbo.hpp"
+
+#include <functional>
+#include <memory>
+
+
+namespace dviglo
+{
+
+// Слой, который рендерится в текстуру и выводится на экран одним спрайтом.
+// Подходит для почти неизменных частей сцены (игровое поле, статичный интерфейс):
+// пока слой не помечен устаревшим, его содержимое не перерисовывается.
+// Если устарели только отдельные прямоугольники, то перерисовываются только они (с помощью scissor test)
+class CachedLayer
+{
+private:
+    // Участок экрана, который занимает слой. Начало координат в левом верхнем углу
+    IntRect area_;
+
+    std::unique_ptr<Fbo> fbo_;
+
+    // Слой нужно перерисовать целиком
+    bool fully_dirty_ = true;
+
+    // Ограничивающий прямоугольник всех устаревших участков (в координатах экрана).
+    // Не используется, если fully_dirty_
+    IntRect dirty_rect_;
+    bool has_dirty_rect_ = false;
+
+public:
+    CachedLayer(const IntRect& area);
+
+    const IntRect& area() const { return area_; }
+
+    // Помечает слой устаревшим целиком
+    void set_dirty() { fully_dirty_ = true; }
+
+    // Помечает устаревшим участок слоя (в координатах экрана)
+    void set_dirty(const IntRect& rect);
+
+    bool is_dirty() const { return fully_dirty_ || has_dirty_rect_; }
+
+    // Если слой устарел, то вызывает draw_func, которая должна нарисовать содержимое слоя
+    // в координатах экрана (как без кэширования). Затем выводит слой на экран.
+    // Рисование за пределами устаревших участков отбрасывается видеокартой.
+    // После вызова SpriteBatch настроен как после prepare_ogl() с параметрами по умолчанию
+    void draw(SpriteBatch* sprite_batch, const std::function<void(SpriteBatch*)>& draw_func);
+};
+
+} // namespace dviglo
@@ -4,8 +4,10 @@
 
 #include "sprite_batch.hpp"
 
+#include "../debug/profiler.hpp"
 #include "../fs/fs_base.hpp"
 #include "../gl_utils/gl_utils.hpp"
+#include "../gl_utils/render_stats.hpp"
 #include "../gl_utils/shader_cache.hpp"
 #include "../math/math.hpp"
 
@@ -96,8 +98,16 @@ SpriteBatch::SpriteBatch()
         VertexAttributes::position | VertexAttributes::color, BufferUsage::dynamic_draw, nullptr);
 
     StrUtf8 base_path = get_base_path();
-    t_shader_program_ = DV_SHADER_CACHE->get(base_path + "engine_data/shaders/vert_color.vert", base_path + "engine_data/shaders/vert_color.frag");
-    q_current_shader_program_ = q_default_shader_program_ = DV_SHADER_CACHE->get(base_path + "engine_data/shaders/vert_color_texture.vert", base_path + "engine_data/shaders/vert_color_texture.frag");
+    StrUtf8 t_vert = base_path + "engine_data/shaders/vert_color.vert";
+    StrUtf8 t_frag = base_path + "engine_data/shaders/vert_color.frag";
+    StrUtf8 q_vert = base_path + "engine_data/shaders/vert_color_texture.vert";
+    StrUtf8 q_frag = base_path + "engine_data/shaders/vert_color_texture.frag";
+
+    // Обе программы компилируются (или загружаются с диска) за один проход
+    DV_SHADER_CACHE->preload({{t_vert, t_frag}, {q_vert, q_frag}});
+
+    t_shader_program_ = DV_SHADER_CACHE->get(t_vert, t_frag);
+    q_current_shader_program_ = q_default_shader_program_ = DV_SHADER_CACHE->get(q_vert, q_frag);
     quad.shader_program = sprite.shader_program = q_default_shader_program_;
 
     set_shape_color(0xFFFFFFFF);
@@ -128,6 +138,8 @@ SpriteBatch::SpriteBatch()
 
 void SpriteBatch::flush()
 {
+    DV_PROFILE_SCOPE("SpriteBatch::flush");
+
     if (t_num_vertices_ > 0)
     {
         t_shader_program_->use();
@@ -139,6 +151,8 @@ void SpriteBatch::flush()
 
         // t_vertex_buffer_->bind() вызывается в t_vertex_buffer_->set_data()
         glDrawArrays(GL_TRIANGLES, 0, t_vertex_buffer_->num_vertices());
+        ++current_render_stats.draw_calls;
+        current_render_stats.vertices += t_num_vertices_;
 
         // Начинаем новую порцию
         t_num_vertices_ = 0;
@@ -160,6 +174,8 @@ void SpriteBatch::flush()
         // q_vertex_buffer_->bind() вызывается в q_vertex_buffer_->set_data()
         i32 num_quads = q_num_vertices_ / vertices_per_quad_;
         glDrawElements(GL_TRIANGLES, num_quads * indices_per_quad_, q_index_buffer_->type(), nullptr);
+        ++current_render_stats.draw_calls;
+        current_render_stats.vertices += q_num_vertices_;
 
         // Начинаем новую порцию
         q_num_vertices_ = 0;
@@ -215,64 +231,13 @@ void SpriteBatch::draw_disk(vec2 center_pos, f32 radius, i32 num_segments)
 
 void SpriteBatch::transform_sprite_internal()
 {
-        // Если спрайт не отмасштабирован и не повёрнут, то прорисовка очень проста
-    if (sprite.rotation == 0.f && sprite.scale == vec2(1.f, 1.f))
-    {
-        // Сдвигаем спрайт на -origin
-        Rect result_dest{sprite.destination.pos - sprite.origin, sprite.destination.size};
-        vec2 far_corner = result_dest.pos + result_dest.size;
-
-        // Лицевая грань задаётся по часовой стрелке, ось Y направлена вниз
-        quad.v0.position = vec2(result_dest.pos.x, result_dest.pos.y); // Верхний левый угол спрайта
-        quad.v1.position = vec2(far_corner.x, result_dest.pos.y); // Верхний правый угол
-        quad.v2.position = vec2(far_corner.x, far_corner.y); // Нижний правый угол
-        quad.v3.position = vec2(result_dest.pos.x, far_corner.y); // Нижний левый угол
-    }
-    else
-    {
-        // Масштабировать и вращать необходимо относительно центра локальных координат:
-        // 1) При стандартном origin == vec2(0.f, 0.f), который соответствует верхнему левому углу спрайта,
-        //    локальные координаты углов будут ноль и размеры_спрайта
-        // 2) При ненулевом origin координаты нужно сдвинуть на -origin
-        Rect local(-sprite.origin, sprite.destination.size);
-        vec2 far_corner = local.pos + local.size;
-
-        f32 sin, cos;
-        sin_cos(sprite.rotation, sin, cos);
-
-        // Нам нужна матрица, которая масштабирует и поворачивает вершину в локальных координатах, а затем
-        // смещает ее в требуемые мировые координаты.
-        // Но в матрице 3x3 последняя строка "0 0 1", умножать на которую бессмысленно.
-        // Поэтому вычисляем без матрицы для оптимизации
-        f32 m11 = cos * sprite.scale.x; f32 m12 = -sin * sprite.scale.y; f32 m13 = sprite.destination.pos.x;
-        f32 m21 = sin * sprite.scale.x; f32 m22 =  cos * sprite.scale.y; f32 m23 = sprite.destination.pos.y;
-        //          0                                  0                                 1
-
-        f32 pos_x_m11 = local.pos.x * m11;
-        f32 pos_x_m21 = local.pos.x * m21;
-        f32 far_x_m11 = far_corner.x * m11;
-        f32 far_x_m21 = far_corner.x * m21;
-        f32 pos_y_m12 = local.pos.y * m12;
-        f32 pos_y_m22 = local.pos.y * m22;
-        f32 far_y_m12 = far_corner.y * m12;
-        f32 far_y_m22 = far_corner.y * m22;
-
-        // transform * vec2(local.pos.x, local.pos.y)
-        quad.v0.position = vec2(pos_x_m11 + pos_y_m12 + m13,
-                                pos_x_m21 + pos_y_m22 + m23);
-
-        // transform * vec2(far_corner.x, local.pos.y)
-        quad.v1.position = vec2(far_x_m11 + pos_y_m12 + m13,
-                                far_x_m21 + pos_y_m22 + m23);
-
-        // transform * vec2(far_corner.x, far_corner.y)
-        quad.v2.position = vec2(far_x_m11 + far_y_m12 + m13,
-                                far_x_m21 + far_y_m22 + m23);
-
-        // transform * vec2(local.pos.x, far_corner.y)
-        quad.v3.position = vec2(pos_x_m11 + far_y_m12 + m13,
-                                pos_x_m21 + far_y_m22 + m23);
-    }
+    vec2 positions[4];
+    transform_sprite(sprite.destination, sprite.origin, sprite.rotation, sprite.scale, positions);
+
+    quad.v0.position = positions[0];
+    quad.v1.position = positions[1];
+    quad.v2.position = positions[2];
+    quad.v3.position = positions[3];
 }
 
 void SpriteBatch::draw_sprite_internal()
@@ -283,17 +248,7 @@ void SpriteBatch::draw_sprite_internal()
     // Вычисляем координаты вершин
     transform_sprite_internal();
 
-    if (!!(sprite.flip_modes & FlipModes::horizontally))
-    {
-        sprite.source_uv.pos.x += sprite.source_uv.size.x;
-        sprite.source_uv.size.x = -sprite.source_uv.size.x;
-    }
-
-    if (!!(sprite.flip_modes & FlipModes::vertically))
-    {
-        sprite.source_uv.pos.y += sprite.source_uv.size.y;
-        sprite.source_uv.size.y = -sprite.source_uv.size.y;
-    }
+    sprite.source_uv = flip_uv(sprite.source_uv, sprite.flip_modes);
 
     quad.v0.color = sprite.color0;
     quad.v0.uv = sprite.source_uv.pos;
@@ -323,40 +278,6 @@ Aabb SpriteBatch::measure_sprite_internal()
     return ret;
 }
 
-// Преобразует пиксельные координаты в диапазон [0, 1]
-static Rect src_to_uv(const Rect* source, Texture* texture)
-{
-    if (source == nullptr)
-    {
-        return Rect(0.f, 0.f, 1.f, 1.f);
-    }
-    else
-    {
-        // Проверки не производятся, текстура должна быть корректной
-        f32 inv_width = 1.f / texture->width();
-        f32 inv_height = 1.f / texture->height();
-
-        return Rect
-        (
-            source->pos.x * inv_width, source->pos.y * inv_height,
-            source->size.x * inv_width, source->size.y * inv_height
-        );
-    }
-}
-
-static Rect pos_to_dest(vec2 position, Texture* texture, const Rect* src)
-{
-    if (src == nullptr)
-    {
-        // Проверки не производятся, текстура должна быть корректной
-        return Rect{position, texture->size()};
-    }
-    else
-    {
-        return Rect{position, src->size};
-    }
-}
-
 void SpriteBatch::draw_sprite(Texture* texture, const Rect& destination, const Rect* source, u32 color,
     f32 rotation, vec2 origin, vec2 scale, FlipModes flip_modes)
 {
@@ -553,4 +474,137 @@ Rect SpriteBatch::measure_string(const StrUtf8& text, SpriteFont* font, vec2 pos
     return string_aabb.to_rect();
 }
 
+// ======================= Отрисовка записанных списков команд =======================
+
+void SpriteBatch::use_shader_program(ShaderProgram* shader_program)
+{
+    shader_program->use();
+    ivec2 viewport_size = get_viewport().size;
+    shader_program->set("u_pixel_size", vec2(2.f / viewport_size.x, 2.f / viewport_size.y));
+    shader_program->set("u_flip_vertically", flip_vertically_);
+}
+
+void SpriteBatch::submit(const SpriteCommandList& list)
+{
+    if (list.empty())
+        return;
+
+    DV_PROFILE_SCOPE("SpriteBatch::submit");
+
+    // Сохраняем порядок рендеринга
+    flush();
+
+    const vector<ShapeVertex>& t_vertices = list.t_vertices();
+    const vector<SpriteVertex>& q_vertices = list.q_vertices();
+
+    // Загружаем всю геометрию списка на GPU. При нехватке места буферы пересоздаются с запасом
+
+    if (!t_vertices.empty())
+    {
+        if (!s_t_vertex_buffer_ || s_t_vertex_buffer_->capacity() < (GLsizei)t_vertices.size())
+        {
+            s_t_vertex_buffer_ = make_unique<VertexBuffer>((GLsizei)t_vertices.size() * 2,
+                VertexAttributes::position | VertexAttributes::color, BufferUsage::dynamic_draw, nullptr);
+        }
+
+        s_t_vertex_buffer_->set_data((GLsizei)t_vertices.size(), t_vertices.data());
+    }
+
+    if (!q_vertices.empty())
+    {
+        if (!s_q_vertex_buffer_ || s_q_vertex_buffer_->capacity() < (GLsizei)q_vertices.size())
+        {
+            s_q_vertex_buffer_ = make_unique<VertexBuffer>((GLsizei)q_vertices.size() * 2,
+                VertexAttributes::position | VertexAttributes::color | VertexAttributes::uv, BufferUsage::dynamic_draw, nullptr);
+        }
+
+        s_q_vertex_buffer_->set_data((GLsizei)q_vertices.size(), q_vertices.data());
+
+        // Индексный буфер содержит набор четырёхугольников. Индексы 32-битные, так как вершин может быть много
+        i32 num_quads = (i32)q_vertices.size() / SpriteCommandList::vertices_per_quad;
+
+        if (s_max_quads_ < num_quads)
+        {
+            s_max_quads_ = num_quads * 2;
+            unique_ptr<u32[]> indices = make_unique<u32[]>(s_max_quads_ * indices_per_quad_);
+
+            for (u32 i = 0; i < (u32)s_max_quads_; ++i)
+            {
+                // Первый треугольник четырёхугольника
+                indices[i * indices_per_quad_ + 0] = i * vertices_per_quad_ + 0;
+                indices[i * indices_per_quad_ + 1] = i * vertices_per_quad_ + 1;
+                indices[i * indices_per_quad_ + 2] = i * vertices_per_quad_ + 2;
+
+                // Второй треугольник
+                indices[i * indices_per_quad_ + 3] = i * vertices_per_quad_ + 2;
+                indices[i * indices_per_quad_ + 4] = i * vertices_per_quad_ + 3;
+                indices[i * indices_per_quad_ + 5] = i * vertices_per_quad_ + 0;
+            }
+
+            s_q_index_buffer_ = make_unique<IndexBuffer>(s_max_quads_ * indices_per_quad_, IndexType::u32,
+                                                         BufferUsage::static_draw, indices.get());
+        }
+
+        // Индексный буфер запоминается в VAO
+        s_q_vertex_buffer_->bind();
+        s_q_index_buffer_->bind();
+    }
+
+    // Рендерим порции, меняя состояние OpenGL только при необходимости
+
+    ShaderProgram* current_shader_program = nullptr;
+    Texture* current_texture = nullptr;
+    SpriteCommandList::BatchType current_type = SpriteCommandList::BatchType::triangles;
+    bool first_batch = true;
+
+    glActiveTexture(GL_TEXTURE0);
+
+    for (const SpriteCommandList::Batch& batch : list.batches())
+    {
+        if (batch.type == SpriteCommandList::BatchType::triangles)
+        {
+            if (first_batch || current_type != batch.type)
+                s_t_vertex_buffer_->bind();
+
+            if (current_shader_program != t_shader_program_)
+            {
+                current_shader_program = t_shader_program_;
+                use_shader_program(current_shader_program);
+            }
+
+            glDrawArrays(GL_TRIANGLES, batch.first_vertex, batch.num_vertices);
+        }
+        else
+        {
+            if (first_batch || current_type != batch.type)
+                s_q_vertex_buffer_->bind();
+
+            ShaderProgram* shader_program = batch.shader_program ? batch.shader_program : q_default_shader_program_;
+
+            if (current_shader_program != shader_program)
+            {
+                current_shader_program = shader_program;
+                use_shader_program(current_shader_program);
+                current_shader_program->set("u_texture", 0);
+            }
+
+            if (current_texture != batch.texture)
+            {
+                current_texture = batch.texture;
+                current_texture->bind();
+            }
+
+            GLsizei first_index = batch.first_vertex / vertices_per_quad_ * indices_per_quad_;
+            GLsizei num_indices = batch.num_vertices / vertices_per_quad_ * indices_per_quad_;
+            glDrawElements(GL_TRIANGLES, num_indices, s_q_index_buffer_->type(), (void*)(first_index * sizeof(u32)));
+        }
+
+        ++current_render_stats.draw_calls;
+        current_render_stats.vertices += batch.num_vertices;
+
+        current_type = batch.type;
+        first_batch = false;
+    }
+}
+
 } // namespace dviglo
@@ -4,6 +4,9 @@
 
 #pragma once
 
+#include "sprite_command_list.hpp"
+#include "sprite_geometry.hpp"
+
 #include "../gl_utils/index_buffer.hpp"
 #include "../gl_utils/shader_program.hpp"
 #include "../gl_utils/texture.hpp"
@@ -17,17 +20,6 @@
 namespace dviglo
 {
 
-// Режимы зеркального отображения спрайтов и текста
-enum class FlipModes : u32
-{
-    none         = 0,
-    horizontally = 1 << 0,
-    vertically   = 1 << 1,
-    both = horizontally | vertically
-};
-DV_FLAGS(FlipModes);
-
-
 class SpriteBatch
 {
     // ============================ Пакетный рендеринг треугольников ============================
@@ -41,11 +33,7 @@ private:
     inline static constexpr i32 vertices_per_triangle_ = 3;
 
     // Атрибуты вершин треугольников
-    struct TVertex
-    {
-        glm::vec2 position;
-        u32 color; // Цвет в формате 0xAABBGGRR
-    };
+    using TVertex = ShapeVertex;
 
     // Текущая порция треугольников
     TVertex t_vertices_[max_triangles_in_portion_ * vertices_per_triangle_];
@@ -91,12 +79,7 @@ private:
     inline static constexpr u16 vertices_per_quad_ = 4;
 
     // Атрибуты вершин четырёхугольников
-    struct QVertex
-    {
-        glm::vec2 position;
-        u32 color; // Цвет в формате 0xAABBGGRR
-        glm::vec2 uv;
-    };
+    using QVertex = SpriteVertex;
 
     // Текущая порция четырёхугольников
     QVertex q_vertices_[max_quads_in_portion_ * vertices_per_quad_];
@@ -216,6 +199,27 @@ public:
 
     Rect measure_string(const StrUtf8& text, SpriteFont* font, glm::vec2 position = {0.f, 0.f},
         f32 rotation = 0.0f, glm::vec2 origin = {0.f, 0.f}, glm::vec2 scale = {1.f, 1.f}, FlipModes flip_modes = FlipModes::none);
+
+    // ======================= Отрисовка записанных списков команд =======================
+
+private:
+
+    // Буферы для submit(). Растут по мере необходимости и не уменьшаются
+    std::unique_ptr<VertexBuffer> s_t_vertex_buffer_;
+    std::unique_ptr<VertexBuffer> s_q_vertex_buffer_;
+    std::unique_ptr<IndexBuffer> s_q_index_buffer_;
+
+    // Сколько четырёхугольников помещается в s_q_index_buffer_
+    i32 s_max_quads_ = 0;
+
+    // Устанавливает шейдерную программу и её общие параметры
+    void use_shader_program(ShaderProgram* shader_program);
+
+public:
+
+    // Загружает на GPU всю геометрию списка за один раз и рендерит его.
+    // Текущая порция рендерится до списка
+    void submit(const SpriteCommandList& list);
 };
 
 } // namespace dviglo
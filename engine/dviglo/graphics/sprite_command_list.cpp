@@ -0,0 +1,221 @@
+// Copyright (c) the Dviglo project
+// License: MIT
+
+#include "sprite_command_list.hpp"
+
+#include "../math/math.hpp"
+
+using namespace glm;
+using namespace std;
+
+
+namespace dviglo
+{
+
+void SpriteCommandList::clear()
+{
+    t_vertices_.clear();
+    q_vertices_.clear();
+    batches_.clear();
+}
+
+void SpriteCommandList::add_vertices(BatchType type, Texture* texture, ShaderProgram* shader_program, u32 num_vertices)
+{
+    if (!batches_.empty())
+    {
+        Batch& last = batches_.back();
+
+        if (last.type == type && last.texture == texture && last.shader_program == shader_program)
+        {
+            last.num_vertices += num_vertices;
+            return;
+        }
+    }
+
+    u32 first_vertex = type == BatchType::triangles ? (u32)t_vertices_.size() : (u32)q_vertices_.size();
+    batches_.push_back({type, texture, shader_program, first_vertex, num_vertices});
+}
+
+void SpriteCommandList::append(const SpriteCommandList& other)
+{
+    u32 t_offset = (u32)t_vertices_.size();
+    u32 q_offset = (u32)q_vertices_.size();
+
+    for (const Batch& batch : other.batches_)
+    {
+        Batch& added = batches_.emplace_back(batch);
+        added.first_vertex += added.type == BatchType::triangles ? t_offset : q_offset;
+
+        // Вершины соседних порций одного типа в массивах идут подряд, поэтому порции можно объединить
+        if (batches_.size() >= 2)
+        {
+            Batch& prev = batches_[batches_.size() - 2];
+
+            if (prev.type == added.type && prev.texture == added.texture && prev.shader_program == added.shader_program)
+            {
+                prev.num_vertices += added.num_vertices;
+                batches_.pop_back();
+            }
+        }
+    }
+
+    t_vertices_.insert(t_vertices_.end(), other.t_vertices_.begin(), other.t_vertices_.end());
+    q_vertices_.insert(q_vertices_.end(), other.q_vertices_.begin(), other.q_vertices_.end());
+}
+
+// ======================= Треугольники =======================
+
+void SpriteCommandList::add_triangle(vec2 v0, vec2 v1, vec2 v2)
+{
+    add_vertices(BatchType::triangles, nullptr, nullptr, 3);
+    t_vertices_.push_back({v0, shape_color_});
+    t_vertices_.push_back({v1, shape_color_});
+    t_vertices_.push_back({v2, shape_color_});
+}
+
+void SpriteCommandList::draw_triangle(vec2 v0, vec2 v1, vec2 v2)
+{
+    add_triangle(v0, v1, v2);
+}
+
+void SpriteCommandList::draw_rect(const Rect& rect)
+{
+    vec2 far_corner = rect.pos + rect.size;
+    add_triangle({rect.pos.x, rect.pos.y}, {far_corner.x, rect.pos.y}, {rect.pos.x, far_corner.y});
+    add_triangle({far_corner.x, rect.pos.y}, {far_corner.x, far_corner.y}, {rect.pos.x, far_corner.y});
+}
+
+void SpriteCommandList::draw_disk(vec2 center_pos, f32 radius, i32 num_segments)
+{
+    if (num_segments < 3)
+        return;
+
+    vec2 first_point(radius + center_pos.x, center_pos.y);
+    vec2 prev_point = first_point;
+
+    for (i32 i = 1; i < num_segments; ++i)
+    {
+        // Угол увеличивается по часовой стрелке
+        f32 angle = radians(360.f) * i / num_segments;
+        f32 cos, sin;
+        sin_cos(angle, sin, cos);
+        vec2 point = vec2(cos, sin) * radius + center_pos;
+
+        add_triangle(prev_point, point, center_pos);
+        prev_point = point;
+    }
+
+    // Последний сегмент
+    add_triangle(prev_point, first_point, center_pos);
+}
+
+// ======================= Четырёхугольники =======================
+
+void SpriteCommandList::add_sprite(Texture* texture, const Rect& destination, const Rect& source_uv, u32 color,
+                                   f32 rotation, vec2 origin, vec2 scale, FlipModes flip_modes)
+{
+    vec2 positions[4];
+    transform_sprite(destination, origin, rotation, scale, positions);
+
+    Rect uv = flip_uv(source_uv, flip_modes);
+
+    add_vertices(BatchType::quads, texture, nullptr, vertices_per_quad);
+    q_vertices_.push_back({positions[0], color, uv.pos});
+    q_vertices_.push_back({positions[1], color, vec2(uv.pos.x + uv.size.x, uv.pos.y)});
+    q_vertices_.push_back({positions[2], color, uv.pos + uv.size});
+    q_vertices_.push_back({positions[3], color, vec2(uv.pos.x, uv.pos.y + uv.size.y)});
+}
+
+void SpriteCommandList::draw_sprite(Texture* texture, const Rect& destination, const Rect* source, u32 color,
+    f32 rotation, vec2 origin, vec2 scale, FlipModes flip_modes)
+{
+    if (!texture)
+        return;
+
+    add_sprite(texture, destination, src_to_uv(source, texture), color, rotation, origin, scale, flip_modes);
+}
+
+void SpriteCommandList::draw_sprite(Texture* texture, vec2 position, const Rect* source, u32 color,
+    f32 rotation, vec2 origin, vec2 scale, FlipModes flip_modes)
+{
+    if (!texture)
+        return;
+
+    add_sprite(texture, pos_to_dest(position, texture, source), src_to_uv(source, texture), color,
+               rotation, origin, scale, flip_modes);
+}
+
+void SpriteCommandList::draw_sprites(Texture* texture, const SpriteInstance* sprites, u32 count)
+{
+    if (!texture || count == 0)
+        return;
+
+    add_vertices(BatchType::quads, texture, nullptr, count * vertices_per_quad);
+
+    size_t first = q_vertices_.size();
+    q_vertices_.resize(first + count * vertices_per_quad);
+    SpriteVertex* vertex = q_vertices_.data() + first;
+
+    for (u32 i = 0; i < count; ++i)
+    {
+        const SpriteInstance& sprite = sprites[i];
+        vec2 far_corner = sprite.destination.pos + sprite.destination.size;
+        vec2 far_uv = sprite.uv.pos + sprite.uv.size;
+
+        // Углы по часовой стрелке, начиная с верхнего левого (как в transform_sprite())
+        vertex[0] = {sprite.destination.pos, sprite.color, sprite.uv.pos};
+        vertex[1] = {vec2(far_corner.x, sprite.destination.pos.y), sprite.color, vec2(far_uv.x, sprite.uv.pos.y)};
+        vertex[2] = {far_corner, sprite.color, far_uv};
+        vertex[3] = {vec2(sprite.destination.pos.x, far_corner.y), sprite.color, vec2(sprite.uv.pos.x, far_uv.y)};
+        vertex += vertices_per_quad;
+    }
+}
+
+void SpriteCommandList::draw_string(const StrUtf8& text, const SpriteFont* font, vec2 position, u32 color,
+    f32 rotation, vec2 origin, vec2 scale, FlipModes flip_modes)
+{
+    if (text.length() == 0)
+        return;
+
+    vector<c32> unicode_text = to_utf32(text);
+    const vector<shared_ptr<Texture>>& textures = font->textures();
+
+    // По идее все текстуры одинакового размера
+    vec2 pixel_size(1.f / textures[0]->width(), 1.f / textures[0]->height());
+
+    vec2 char_orig = origin;
+
+    i32 i = 0;
+    i32 step = 1;
+
+    if (!!(flip_modes & FlipModes::horizontally))
+    {
+        i = (i32)unicode_text.size() - 1;
+        step = -1;
+    }
+
+    for (; i >= 0 && i < (i32)unicode_text.size(); i += step)
+    {
+        const Glyph& glyph = font->glyph(unicode_text[i]);
+
+        // Символа нет в шрифте
+        if (glyph.page < 0 || glyph.page >= (i32)textures.size())
+            continue;
+
+        Rect rect(glyph.rect);
+        vec2 offset(glyph.offset);
+
+        // Модифицируем origin, а не позицию, чтобы было правильное вращение
+        vec2 char_origin = !!(flip_modes & FlipModes::vertically)
+                           ? char_orig - vec2(offset.x, font->line_height() - offset.y - rect.size.y)
+                           : char_orig - offset;
+
+        add_sprite(textures[glyph.page].get(), Rect(position, rect.size),
+                   Rect(rect.pos * pixel_size, rect.size * pixel_size), color,
+                   rotation, char_origin, scale, flip_modes);
+
+        char_orig.x -= (f32)glyph.advance_x;
+    }
+}
+
+} // namespace dviglo
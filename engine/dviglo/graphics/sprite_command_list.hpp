@@ -0,0 +1,112 @@
+// Copyright (c) the Dviglo project
+// License: MIT
+
+#pragma once
+
+#include "sprite_geometry.hpp"
+
+#include "../gl_utils/shader_program.hpp"
+#include "../res/sprite_font.hpp"
+
+#include <vector>
+
+
+namespace dviglo
+{
+
+// Записывает те же команды, что и SpriteBatch, но только в память CPU, без вызовов OpenGL.
+// Поэтому список можно заполнять в любом потоке (разные списки - в разных потоках).
+// Рендерится с помощью SpriteBatch::submit().
+// Текстуры и шрифты должны существовать, пока список не отрендерен
+class SpriteCommandList
+{
+public:
+    enum class BatchType : u32
+    {
+        triangles = 0,
+        quads
+    };
+
+    // Последовательность вершин, которая рендерится с одинаковыми настройками
+    struct Batch
+    {
+        BatchType type;
+
+        // Для четырёхугольников
+        Texture* texture;
+
+        // nullptr - дефолтная шейдерная программа SpriteBatch
+        ShaderProgram* shader_program;
+
+        // Индекс первой вершины в t_vertices() или q_vertices() в зависимости от type
+        u32 first_vertex;
+        u32 num_vertices;
+    };
+
+    // Четырёхугольник занимает 4 вершины
+    inline static constexpr u32 vertices_per_quad = 4;
+
+private:
+    // Память не освобождается при clear(), поэтому после прогрева
+    // повторное заполнение списка не выделяет память
+    std::vector<ShapeVertex> t_vertices_;
+    std::vector<SpriteVertex> q_vertices_;
+    std::vector<Batch> batches_;
+
+    // Цвет треугольников в формате 0xAABBGGRR
+    u32 shape_color_ = 0xFFFFFFFF;
+
+    // Продлевает последнюю порцию или начинает новую
+    void add_vertices(BatchType type, Texture* texture, ShaderProgram* shader_program, u32 num_vertices);
+
+    void add_triangle(glm::vec2 v0, glm::vec2 v1, glm::vec2 v2);
+
+    void add_sprite(Texture* texture, const Rect& destination, const Rect& source_uv, u32 color,
+                    f32 rotation, glm::vec2 origin, glm::vec2 scale, FlipModes flip_modes);
+
+public:
+    const std::vector<ShapeVertex>& t_vertices() const { return t_vertices_; }
+    const std::vector<SpriteVertex>& q_vertices() const { return q_vertices_; }
+    const std::vector<Batch>& batches() const { return batches_; }
+
+    bool empty() const { return batches_.empty(); }
+
+    // Очищает список, сохраняя выделенную память
+    void clear();
+
+    // Добавляет команды другого списка в конец этого.
+    // Соседние порции с одинаковыми настройками объединяются
+    void append(const SpriteCommandList& other);
+
+    // ======================= Треугольники =======================
+
+    // Указывает цвет для следующих треугольников (в формате 0xAABBGGRR)
+    void set_shape_color(u32 color) { shape_color_ = color; }
+
+    void draw_triangle(glm::vec2 v0, glm::vec2 v1, glm::vec2 v2);
+
+    void draw_rect(const Rect& rect);
+
+    // Рисует круг
+    void draw_disk(glm::vec2 center_pos, f32 radius, i32 num_segments);
+
+    // ======================= Четырёхугольники =======================
+
+    // color - цвет в формате 0xAABBGGRR
+    void draw_sprite(Texture* texture, const Rect& destination, const Rect* source = nullptr, u32 color = 0xFFFFFFFF,
+        f32 rotation = 0.f, glm::vec2 origin = {0.f, 0.f}, glm::vec2 scale = {1.f, 1.f}, FlipModes flip_modes = FlipModes::none);
+
+    // color - цвет в формате 0xAABBGGRR
+    void draw_sprite(Texture* texture, glm::vec2 position, const Rect* source = nullptr, u32 color = 0xFFFFFFFF,
+        f32 rotation = 0.f, glm::vec2 origin = {0.f, 0.f}, glm::vec2 scale = {1.f, 1.f}, FlipModes flip_modes = FlipModes::none);
+
+    // Добавляет спрайты одной порцией. Быстрее, чем draw_sprite() для каждого спрайта,
+    // так как не вычисляет поворот, масштаб и текстурные координаты
+    void draw_sprites(Texture* texture, const SpriteInstance* sprites, u32 count);
+
+    // color - цвет в формате 0xAABBGGRR
+    void draw_string(const StrUtf8& text, const SpriteFont* font, glm::vec2 position, u32 color = 0xFFFFFFFF,
+        f32 rotation = 0.0f, glm::vec2 origin = {0.f, 0.f}, glm::vec2 scale = {1.f, 1.f}, FlipModes flip_modes = FlipModes::none);
+};
+
+} // namespace dviglo
@@ -0,0 +1,127 @@
+// Copyright (c) the Dviglo project
+// Copyright (c) 2008-2023 the Urho3D project
+// License: MIT
+
+#include "sprite_geometry.hpp"
+
+#include "../math/math.hpp"
+
+using namespace glm;
+
+
+namespace dviglo
+{
+
+void transform_sprite(const Rect& destination, vec2 origin, f32 rotation, vec2 scale, vec2 out_positions[4])
+{
+    // Если спрайт не отмасштабирован и не повёрнут, то прорисовка очень проста
+    if (rotation == 0.f && scale == vec2(1.f, 1.f))
+    {
+        // Сдвигаем спрайт на -origin
+        Rect result_dest{destination.pos - origin, destination.size};
+        vec2 far_corner = result_dest.pos + result_dest.size;
+
+        // Лицевая грань задаётся по часовой стрелке, ось Y направлена вниз
+        out_positions[0] = vec2(result_dest.pos.x, result_dest.pos.y); // Верхний левый угол спрайта
+        out_positions[1] = vec2(far_corner.x, result_dest.pos.y); // Верхний правый угол
+        out_positions[2] = vec2(far_corner.x, far_corner.y); // Нижний правый угол
+        out_positions[3] = vec2(result_dest.pos.x, far_corner.y); // Нижний левый угол
+    }
+    else
+    {
+        // Масштабировать и вращать необходимо относительно центра локальных координат:
+        // 1) При стандартном origin == vec2(0.f, 0.f), который соответствует верхнему левому углу спрайта,
+        //    локальные координаты углов будут ноль и размеры_спрайта
+        // 2) При ненулевом origin координаты нужно сдвинуть на -origin
+        Rect local(-origin, destination.size);
+        vec2 far_corner = local.pos + local.size;
+
+        f32 sin, cos;
+        sin_cos(rotation, sin, cos);
+
+        // Нам нужна матрица, которая масштабирует и поворачивает вершину в локальных координатах, а затем
+        // смещает ее в требуемые мировые координаты.
+        // Но в матрице 3x3 последняя строка "0 0 1", умножать на которую бессмысленно.
+        // Поэтому вычисляем без матрицы для оптимизации
+        f32 m11 = cos * scale.x; f32 m12 = -sin * scale.y; f32 m13 = destination.pos.x;
+        f32 m21 = sin * scale.x; f32 m22 =  cos * scale.y; f32 m23 = destination.pos.y;
+        //          0                    0                   1
+
+        f32 pos_x_m11 = local.pos.x * m11;
+        f32 pos_x_m21 = local.pos.x * m21;
+        f32 far_x_m11 = far_corner.x * m11;
+        f32 far_x_m21 = far_corner.x * m21;
+        f32 pos_y_m12 = local.pos.y * m12;
+        f32 pos_y_m22 = local.pos.y * m22;
+        f32 far_y_m12 = far_corner.y * m12;
+        f32 far_y_m22 = far_corner.y * m22;
+
+        // transform * vec2(local.pos.x, local.pos.y)
+        out_positions[0] = vec2(pos_x_m11 + pos_y_m12 + m13,
+                                pos_x_m21 + pos_y_m22 + m23);
+
+        // transform * vec2(far_corner.x, local.pos.y)
+        out_positions[1] = vec2(far_x_m11 + pos_y_m12 + m13,
+                                far_x_m21 + pos_y_m22 + m23);
+
+        // transform * vec2(far_corner.x, far_corner.y)
+        out_positions[2] = vec2(far_x_m11 + far_y_m12 + m13,
+                                far_x_m21 + far_y_m22 + m23);
+
+        // transform * vec2(local.pos.x, far_corner.y)
+        out_positions[3] = vec2(pos_x_m11 + far_y_m12 + m13,
+                                pos_x_m21 + far_y_m22 + m23);
+    }
+}
+
+Rect flip_uv(Rect source_uv, FlipModes flip_modes)
+{
+    if (!!(flip_modes & FlipModes::horizontally))
+    {
+        source_uv.pos.x += source_uv.size.x;
+        source_uv.size.x = -source_uv.size.x;
+    }
+
+    if (!!(flip_modes & FlipModes::vertically))
+    {
+        source_uv.pos.y += source_uv.size.y;
+        source_uv.size.y = -source_uv.size.y;
+    }
+
+    return source_uv;
+}
+
+Rect src_to_uv(const Rect* source, const Texture* texture)
+{
+    if (source == nullptr)
+    {
+        return Rect(0.f, 0.f, 1.f, 1.f);
+    }
+    else
+    {
+        // Проверки не производятся, текстура должна быть корректной
+        f32 inv_width = 1.f / texture->width();
+        f32 inv_height = 1.f / texture->height();
+
+        return Rect
+        (
+            source->pos.x * inv_width, source->pos.y * inv_height,
+            source->size.x * inv_width, source->size.y * inv_height
+        );
+    }
+}
+
+Rect pos_to_dest(vec2 position, const Texture* texture, const Rect* src)
+{
+    if (src == nullptr)
+    {
+        // Проверки не производятся, текстура должна быть корректной
+        return Rect{position, texture->size()};
+    }
+    else
+    {
+        return Rect{position, src->size};
+    }
+}
+
+} // namespace dviglo
@@ -0,0 +1,68 @@
+// Copyright (c) the Dviglo project
+// License: MIT
+
+// Вычисления, общие для SpriteBatch и SpriteCommandList. Не используют OpenGL
+
+#pragma once
+
+#include "../gl_utils/texture.hpp"
+#include "../math/rect.hpp"
+#include "../std_utils/flags.hpp"
+
+
+namespace dviglo
+{
+
+// Режимы зеркального отображения спрайтов и текста
+enum class FlipModes : u32
+{
+    none         = 0,
+    horizontally = 1 << 0,
+    vertically   = 1 << 1,
+    both = horizontally | vertically
+};
+DV_FLAGS(FlipModes);
+
+
+// Атрибуты вершин треугольников
+struct ShapeVertex
+{
+    glm::vec2 position;
+    u32 color; // Цвет в формате 0xAABBGGRR
+};
+
+// Атрибуты вершин четырёхугольников
+struct SpriteVertex
+{
+    glm::vec2 position;
+    u32 color; // Цвет в формате 0xAABBGGRR
+    glm::vec2 uv;
+};
+
+// Спрайт без поворота и масштабирования для пакетного добавления (SpriteCommandList::draw_sprites())
+struct SpriteInstance
+{
+    // Область на экране
+    Rect destination;
+
+    // Текстурные координаты в диапазоне [0, 1] (см. src_to_uv()).
+    // Обычно одинаковы у всех спрайтов одного типа, поэтому вычисляются заранее
+    Rect uv;
+
+    u32 color; // Цвет в формате 0xAABBGGRR
+};
+
+// Вычисляет позиции углов спрайта по часовой стрелке, начиная с верхнего левого угла
+void transform_sprite(const Rect& destination, glm::vec2 origin, f32 rotation, glm::vec2 scale,
+                      glm::vec2 out_positions[4]);
+
+// Отражает текстурные координаты
+Rect flip_uv(Rect source_uv, FlipModes flip_modes);
+
+// Преобразует пиксельные координаты в диапазон [0, 1]
+Rect src_to_uv(const Rect* source, const Texture* texture);
+
+// Область, которую займёт спрайт без масштабирования
+Rect pos_to_dest(glm::vec2 position, const Texture* texture, const Rect* src);
+
+} // namespace dviglo
@@ -0,0 +1,192 @@
+// Copyright (c) the Dviglo project
+// License: MIT
+
+#include "tile_map.hpp"
+
+#include "../debug/profiler.hpp"
+#include "../fs/fs_base.hpp"
+#include "../gl_utils/gl_utils.hpp"
+#include "../gl_utils/render_stats.hpp"
+#include "../gl_utils/shader_cache.hpp"
+
+using namespace glm;
+using namespace std;
+
+
+namespace dviglo
+{
+
+// Четырёхугольник состоит из двух треугольников с общими вершинами
+static constexpr i32 vertices_per_quad = 4;
+static constexpr i32 indices_per_quad = 6;
+
+static constexpr i32 max_quads_in_chunk = TileMap::chunk_size * TileMap::chunk_size;
+static_assert(max_quads_in_chunk * vertices_per_quad <= 65536);
+
+TileMap::TileMap(ivec2 size, ivec2 tile_size, shared_ptr<Texture> spritesheet)
+    : size_(glm::max(size, ivec2(0, 0)))
+    , tile_size_(tile_size)
+    , spritesheet_(spritesheet)
+{
+    spritesheet_columns_ = std::max(spritesheet_->width() / std::max(tile_size_.x, 1), 1);
+    tiles_.resize((size_t)size_.x * size_.y, empty_tile);
+
+    num_chunks_ = (size_ + chunk_size - 1) / chunk_size;
+    chunks_.resize((size_t)num_chunks_.x * num_chunks_.y);
+
+    // Вершины тайла идут по часовой стрелке, начиная с верхнего левого угла (как в SpriteBatch)
+    vector<u16> indices(max_quads_in_chunk * indices_per_quad);
+
+    for (i32 i = 0; i < max_quads_in_chunk; ++i)
+    {
+        // Первый треугольник четырёхугольника
+        indices[i * indices_per_quad + 0] = u16(i * vertices_per_quad + 0);
+        indices[i * indices_per_quad + 1] = u16(i * vertices_per_quad + 1);
+        indices[i * indices_per_quad + 2] = u16(i * vertices_per_quad + 2);
+
+        // Второй треугольник
+        indices[i * indices_per_quad + 3] = u16(i * vertices_per_quad + 2);
+        indices[i * indices_per_quad + 4] = u16(i * vertices_per_quad + 3);
+        indices[i * indices_per_quad + 5] = u16(i * vertices_per_quad + 0);
+    }
+
+    index_buffer_ = make_unique<IndexBuffer>((GLsizei)indices.size(), IndexType::u16, BufferUsage::static_draw,
+                                             indices.data());
+
+    StrUtf8 base_path = get_base_path();
+    shader_program_ = DV_SHADER_CACHE->get(base_path + "engine_data/shaders/tile_map.vert",
+                                           base_path + "engine_data/shaders/vert_color_texture.frag");
+
+    vertices_.reserve(max_quads_in_chunk * vertices_per_quad);
+}
+
+TileMap::Tile TileMap::get_tile(ivec2 pos) const
+{
+    if (pos.x < 0 || pos.y < 0 || pos.x >= size_.x || pos.y >= size_.y)
+        return empty_tile;
+
+    return tiles_[(size_t)pos.y * size_.x + pos.x];
+}
+
+void TileMap::set_tile(ivec2 pos, Tile tile)
+{
+    if (pos.x < 0 || pos.y < 0 || pos.x >= size_.x || pos.y >= size_.y)
+        return;
+
+    Tile& old_tile = tiles_[(size_t)pos.y * size_.x + pos.x];
+
+    if (old_tile == tile)
+        return;
+
+    old_tile = tile;
+    ivec2 chunk_index = pos / chunk_size;
+    chunks_[chunk_index.y * num_chunks_.x + chunk_index.x].dirty = true;
+}
+
+void TileMap::rebuild_chunk(ivec2 chunk_index)
+{
+    DV_PROFILE_SCOPE("TileMap::rebuild_chunk()");
+
+    Chunk& chunk = chunks_[chunk_index.y * num_chunks_.x + chunk_index.x];
+    vertices_.clear();
+
+    ivec2 begin = chunk_index * chunk_size;
+    ivec2 end = glm::min(begin + chunk_size, size_);
+    vec2 uv_size = vec2(tile_size_) / vec2(spritesheet_->size());
+
+    for (i32 y = begin.y; y < end.y; ++y)
+    {
+        for (i32 x = begin.x; x < end.x; ++x)
+        {
+            Tile tile = tiles_[(size_t)y * size_.x + x];
+
+            if (tile == empty_tile)
+                continue;
+
+            vec2 pos0 = vec2(x, y) * vec2(tile_size_);
+            vec2 pos1 = pos0 + vec2(tile_size_);
+            vec2 uv0 = vec2(tile % spritesheet_columns_, tile / spritesheet_columns_) * uv_size;
+            vec2 uv1 = uv0 + uv_size;
+
+            vertices_.push_back({pos0, uv0});                        // Верхний левый угол
+            vertices_.push_back({{pos1.x, pos0.y}, {uv1.x, uv0.y}}); // Верхний правый
+            vertices_.push_back({pos1, uv1});                        // Нижний правый
+            vertices_.push_back({{pos0.x, pos1.y}, {uv0.x, uv1.y}}); // Нижний левый
+        }
+    }
+
+    GLsizei num_vertices = (GLsizei)vertices_.size();
+    chunk.num_quads = num_vertices / vertices_per_quad;
+    chunk.dirty = false;
+
+    if (!num_vertices)
+        return; // Старый буфер не нужен, но оставляем его на случай, если в куске снова появятся тайлы
+
+    if (chunk.vertex_buffer && chunk.vertex_buffer->capacity() >= num_vertices)
+    {
+        chunk.vertex_buffer->set_data(num_vertices, vertices_.data());
+    }
+    else
+    {
+        chunk.vertex_buffer = make_unique<VertexBuffer>(num_vertices, VertexAttributes::position | VertexAttributes::uv,
+                                                        BufferUsage::static_draw, vertices_.data());
+
+        ++current_render_stats.buffer_uploads;
+        current_render_stats.buffer_upload_bytes += num_vertices * sizeof(TileVertex);
+    }
+}
+
+void TileMap::draw(vec2 camera_pos, bool flip_vertically)
+{
+    DV_PROFILE_SCOPE("TileMap::draw()");
+
+    num_drawn_chunks_ = 0;
+    num_rebuilt_chunks_ = 0;
+
+    ivec2 viewport_size = get_viewport().size;
+
+    // Видимые куски
+    vec2 chunk_pixel_size = vec2(tile_size_ * chunk_size);
+    ivec2 begin = glm::max(ivec2(glm::floor(camera_pos / chunk_pixel_size)), ivec2(0, 0));
+    ivec2 end = glm::min(ivec2(glm::ceil((camera_pos + vec2(viewport_size)) / chunk_pixel_size)), num_chunks_);
+
+    if (begin.x >= end.x || begin.y >= end.y)
+        return;
+
+    shader_program_->use();
+    shader_program_->set("u_pixel_size", vec2(2.f / viewport_size.x, 2.f / viewport_size.y));
+    shader_program_->set("u_flip_vertically", flip_vertically);
+    shader_program_->set("u_offset", -camera_pos);
+    shader_program_->set("u_texture", 0);
+
+    glActiveTexture(GL_TEXTURE0);
+    spritesheet_->bind();
+
+    for (i32 y = begin.y; y < end.y; ++y)
+    {
+        for (i32 x = begin.x; x < end.x; ++x)
+        {
+            Chunk& chunk = chunks_[y * num_chunks_.x + x];
+
+            if (chunk.dirty)
+            {
+                rebuild_chunk({x, y});
+                ++num_rebuilt_chunks_;
+            }
+
+            if (!chunk.num_quads)
+                continue;
+
+            // Индексный буфер запоминается в VAO куска
+            chunk.vertex_buffer->bind();
+            index_buffer_->bind();
+            glDrawElements(GL_TRIANGLES, chunk.num_quads * indices_per_quad, index_buffer_->type(), nullptr);
+
+            ++current_render_stats.draw_calls;
+            current_render_stats.vertices += chunk.num_quads * vertices_per_quad;
+            ++num_drawn_chunks_;
+        }
+    }
+}
+
+} // namespace dviglo
@@ -0,0 +1,118 @@
+// Copyright (c) the Dviglo project
+// License: MIT
+
+#pragma once
+
+#include "../gl_utils/index_buffer.hpp"
+#include "../gl_utils/shader_program.hpp"
+#include "../gl_utils/texture.hpp"
+#include "../gl_utils/vertex_buffer.hpp"
+
+#include <memory>
+#include <vector>
+
+
+namespace dviglo
+{
+
+// Карта из тайлов одинакового размера. В отличие от SpriteBatch геометрия не отправляется
+// на GPU каждый кадр: карта разбита на куски (chunks) chunk_size x chunk_size тайлов,
+// и у каждого куска свой статический вершинный буфер. Рисуются только видимые куски.
+// Буфер куска строится, когда кусок впервые попадает на экран, и перестраивается,
+// только если в куске изменились тайлы.
+// Тайлы в спрайтшите идут без промежутков слева направо и сверху вниз.
+// Чтобы соседние тайлы не просвечивали по краям, у спрайтшита должна быть фильтрация GL_NEAREST
+class TileMap
+{
+public:
+    // Номер тайла в спрайтшите
+    using Tile = u16;
+
+    // Пустая клетка (ничего не рисуется)
+    static constexpr Tile empty_tile = 0xFFFF;
+
+    // Сторона куска в тайлах. Вершин в куске не больше 65536, поэтому хватает 16-битных индексов
+    static constexpr i32 chunk_size = 32;
+
+private:
+    // Атрибуты вершин тайлов
+    struct TileVertex
+    {
+        glm::vec2 position; // В координатах карты (в пикселях)
+        glm::vec2 uv;
+    };
+
+    struct Chunk
+    {
+        // nullptr, пока кусок ни разу не был виден
+        std::unique_ptr<VertexBuffer> vertex_buffer;
+
+        // Число непустых тайлов
+        i32 num_quads = 0;
+
+        // Тайлы изменились после построения буфера
+        bool dirty = true;
+    };
+
+    // Размер карты в тайлах
+    glm::ivec2 size_;
+
+    // Размер тайла в пикселях (и на экране, и в спрайтшите)
+    glm::ivec2 tile_size_;
+
+    std::shared_ptr<Texture> spritesheet_;
+
+    // Число тайлов в строке спрайтшита
+    i32 spritesheet_columns_;
+
+    // Тайлы по строкам
+    std::vector<Tile> tiles_;
+
+    // Число кусков по горизонтали и вертикали
+    glm::ivec2 num_chunks_;
+
+    // Куски по строкам
+    std::vector<Chunk> chunks_;
+
+    // Общий для всех кусков (у всех кусков одинаковый порядок вершин)
+    std::unique_ptr<IndexBuffer> index_buffer_;
+
+    ShaderProgram* shader_program_;
+
+    // Используется при построении кусков, чтобы не выделять память каждый раз
+    std::vector<TileVertex> vertices_;
+
+    // Статистика последнего вызова draw()
+    i32 num_drawn_chunks_ = 0;
+    i32 num_rebuilt_chunks_ = 0;
+
+    void rebuild_chunk(glm::ivec2 chunk_index);
+
+public:
+    // Все клетки пустые
+    TileMap(glm::ivec2 size, glm::ivec2 tile_size, std::shared_ptr<Texture> spritesheet);
+
+    glm::ivec2 size() const { return size_; }
+    glm::ivec2 tile_size() const { return tile_size_; }
+
+    // Размер карты в пикселях
+    glm::ivec2 pixel_size() const { return size_ * tile_size_; }
+
+    // pos - координаты клетки в тайлах. Для клеток за пределами карты возвращает empty_tile
+    Tile get_tile(glm::ivec2 pos) const;
+
+    // Помечает кусок с этой клеткой устаревшим. Клетки за пределами карты игнорируются
+    void set_tile(glm::ivec2 pos, Tile tile);
+
+    // Рисует видимую часть карты. camera_pos - координаты карты (в пикселях),
+    // которые окажутся в левом верхнем углу viewport.
+    // Перед вызовом нужно настроить смешение (например с помощью SpriteBatch::prepare_ogl()).
+    // Если в SpriteBatch есть ненарисованная геометрия, то её нужно вывести до вызова (flush())
+    void draw(glm::vec2 camera_pos, bool flip_vertically = false);
+
+    // Сколько кусков нарисовано и сколько перестроено при последнем вызове draw()
+    i32 num_drawn_chunks() const { return num_drawn_chunks_; }
+    i32 num_rebuilt_chunks() const { return num_rebuilt_chunks_; }
+};
+
+} // namespace dviglo
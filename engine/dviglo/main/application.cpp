@@ -6,8 +6,13 @@
 
 #include "engine_params.hpp"
 
+#include "../fs/file_base.hpp"
+
 #include <glad/gl.h>
 
+#include <algorithm>
+#include <thread>
+
 using namespace std;
 
 
@@ -36,10 +41,57 @@ Application::Application(const vector<StrUtf8>& args)
                 ++i;
             }
 #endif
+
+            if (argument == "profile" && !value.empty())
+            {
+                profile_path_ = value;
+                ++i;
+            }
+            else if (argument == "render_stats" && !value.empty())
+            {
+                render_stats_path_ = value;
+                ++i;
+            }
+            else if (argument == "hot_reload")
+            {
+                // Параметр без значения. setup() вызывается позже и может переопределить
+                engine_params::hot_reload = true;
+            }
         }
     }
 }
 
+Application::~Application()
+{
+    // Поток должен быть остановлен раньше, но на всякий случай
+    stop_update_thread();
+
+    if (!profile_path_.empty() && profiler_)
+        profiler_->save_chrome_trace(profile_path_);
+
+    if (!render_stats_path_.empty())
+        save_render_stats();
+}
+
+void Application::save_render_stats() const
+{
+    FILE* stream = file_open(render_stats_path_, "wb");
+
+    if (!stream)
+    {
+        DV_LOG->writef_error("Application::save_render_stats() | !stream | {}", render_stats_path_);
+        return;
+    }
+
+    StrUtf8 csv = "frame," + RenderStats::csv_header() + "\n";
+
+    for (size_t i = 0; i < render_stats_history_.size(); ++i)
+        csv += to_string(i + 1) + "," + render_stats_history_[i].to_csv_row() + "\n";
+
+    file_write(csv.data(), 1, (i32)csv.size(), stream);
+    file_close(stream);
+}
+
 void Application::handle_sdl_event(const SDL_Event& event)
 {
     switch (event.type)
@@ -50,6 +102,11 @@ void Application::handle_sdl_event(const SDL_Event& event)
 
     case SDL_EVENT_WINDOW_RESIZED:
         {
+            // При threaded_update_ это событие уже обработано в главном потоке,
+            // а OpenGL нельзя использовать в потоке симуляции
+            if (threaded_update_)
+                return;
+
             i32 width = event.window.data1;
             i32 height = event.window.data2;
             glViewport(0, 0, width, height);
@@ -68,14 +125,32 @@ SDL_AppResult Application::main_init()
         return SDL_APP_FAILURE;
 
     os_window_ = make_unique<OsWindow>();
+    profiler_ = make_unique<Profiler>(engine_params::profiler_max_frames, engine_params::profiler_gpu_timing);
+    job_system_ = make_unique<JobSystem>(engine_params::num_worker_threads);
+
+    if (engine_params::hot_reload)
+        file_watcher_ = make_unique<FileWatcher>();
+
     shader_cache_ = make_unique<ShaderCache>();
     texture_cache_ = make_unique<TextureCache>();
+    fbo_pool_ = make_unique<FboPool>();
     audio_ = make_unique<Audio>();
     freetype_ = make_unique<FreeType>();
 
     start();
     new_frame();
 
+    prev_ticks_ = SDL_GetTicksNS();
+    state_ticks_ = prev_ticks_;
+
+    threaded_update_ = engine_params::threaded_update;
+
+    if (threaded_update_)
+    {
+        update_thread_running_ = true;
+        update_thread_ = thread(&Application::update_thread_func, this);
+    }
+
     return SDL_APP_CONTINUE;
 }
 
@@ -87,25 +162,74 @@ SDL_AppResult Application::main_iterate()
         should_exit_ = true;
 #endif
 
-    static u64 old_ticks = SDL_GetTicksNS();
-    u64 new_ticks = SDL_GetTicksNS();
-    u64 ns = new_ticks - old_ticks;
-    old_ticks = new_ticks;
+    // Сбрасываем до update() и подмены ресурсов, чтобы учитывались сделанные там привязки и загрузки
+    // (при threaded_update_ update() не должен работать с OpenGL)
+    current_render_stats = RenderStats();
+
+    // Ресурсы подменяются в главном потоке до начала рендеринга кадра
+    if (file_watcher_)
+        apply_hot_reload();
 
-    // Если точности SDL_GetTicksNS() не хватает
-    if (ns == 0)
+    if (threaded_update_)
     {
-        // Ждём полмиллисекунды
-        SDL_DelayNS(SDL_NS_PER_MS / 2);
-        return SDL_APP_CONTINUE;
+        profiler_->begin_frame();
+
+        // Без фиксированного шага будим поток симуляции. Он подготовит состояние к следующему кадру,
+        // пока этот кадр рендерится
+        ++started_frames_;
+        started_frames_.notify_one();
+
+        if (engine_params::fixed_update_hz > 0)
+        {
+            // Доля шага, прошедшая с момента последнего состояния симуляции
+            f32 step = f32(SDL_NS_PER_SECOND / engine_params::fixed_update_hz);
+            f32 alpha = (f32)((i64)SDL_GetTicksNS() - (i64)state_ticks_.load()) / step;
+            interpolation_alpha_ = clamp(alpha, 0.f, 1.f);
+        }
+    }
+    else
+    {
+        u64 new_ticks = SDL_GetTicksNS();
+        u64 ns = new_ticks - prev_ticks_;
+
+        // Если точности SDL_GetTicksNS() не хватает
+        if (ns == 0)
+        {
+            // Ждём полмиллисекунды
+            SDL_DelayNS(SDL_NS_PER_MS / 2);
+            return SDL_APP_CONTINUE;
+        }
+
+        prev_ticks_ = new_ticks;
+
+        profiler_->begin_frame();
+
+        DV_PROFILE_SCOPE("update");
+        run_updates(ns);
     }
 
-    update(ns);
-    draw();
-    SDL_GL_SwapWindow(DV_OS_WINDOW->window());
+    {
+        DV_PROFILE_SCOPE("draw");
+        draw();
+    }
+
+    {
+        DV_PROFILE_SCOPE("SDL_GL_SwapWindow");
+        SDL_GL_SwapWindow(DV_OS_WINDOW->window());
+    }
+
+    pace_frame();
+
+    fbo_pool_->end_frame();
+    profiler_->end_frame();
+    last_render_stats_ = current_render_stats;
+
+    if (!render_stats_path_.empty())
+        render_stats_history_.push_back(last_render_stats_);
 
     if (should_exit_)
     {
+        stop_update_thread();
         return SDL_APP_SUCCESS;
     }
     else
@@ -115,14 +239,191 @@ SDL_AppResult Application::main_iterate()
     }
 }
 
+void Application::apply_hot_reload()
+{
+    vector<StrUtf8> changed_files = file_watcher_->take_changes();
+
+    // Кэши вызываются и без изменений, чтобы подменить ресурсы, которые загружались в фоне
+    shader_cache_->hot_reload(changed_files);
+    texture_cache_->hot_reload(changed_files);
+}
+
+void Application::run_updates(u64 ns)
+{
+    if (engine_params::fixed_update_hz <= 0)
+    {
+        if (threaded_update_)
+            dispatch_events(prev_ticks_);
+
+        update(ns);
+        state_ticks_ = prev_ticks_;
+        return;
+    }
+
+    const u64 step = SDL_NS_PER_SECOND / engine_params::fixed_update_hz;
+    accumulator_ += ns;
+
+    for (i32 num_updates = 0; accumulator_ >= step; ++num_updates)
+    {
+        // Не успеваем. Отбрасываем отставание, оставляя только дробную часть шага
+        if (num_updates >= engine_params::max_updates_per_frame)
+        {
+            accumulator_ %= step;
+            break;
+        }
+
+        // Каждый шаг получает только те события, которые произошли до его окончания
+        if (threaded_update_)
+            dispatch_events(prev_ticks_ - accumulator_ + step);
+
+        update(step);
+        accumulator_ -= step;
+    }
+
+    state_ticks_ = prev_ticks_ - accumulator_;
+    interpolation_alpha_ = (f32)accumulator_ / (f32)step;
+}
+
+void Application::update_thread_func()
+{
+    u64 processed_frames = 0;
+    prev_ticks_ = SDL_GetTicksNS();
+
+    while (update_thread_running_)
+    {
+        if (engine_params::fixed_update_hz <= 0)
+        {
+            // Ждём начала следующего кадра в главном потоке
+            started_frames_.wait(processed_frames);
+            processed_frames = started_frames_;
+
+            if (!update_thread_running_)
+                break;
+        }
+
+        u64 new_ticks = SDL_GetTicksNS();
+        u64 ns = new_ticks - prev_ticks_;
+
+        // Если точности SDL_GetTicksNS() не хватает
+        if (ns == 0)
+        {
+            SDL_DelayNS(SDL_NS_PER_MS / 2);
+            continue;
+        }
+
+        prev_ticks_ = new_ticks;
+
+        {
+            DV_PROFILE_SCOPE("update");
+            run_updates(ns);
+        }
+
+        // При фиксированном шаге спим до следующего шага
+        if (engine_params::fixed_update_hz > 0)
+        {
+            const u64 step = SDL_NS_PER_SECOND / engine_params::fixed_update_hz;
+
+            if (accumulator_ < step)
+                SDL_DelayNS(step - accumulator_);
+        }
+    }
+}
+
+void Application::stop_update_thread()
+{
+    if (!update_thread_.joinable())
+        return;
+
+    update_thread_running_ = false;
+
+    // Будим поток, если он ждёт кадр
+    ++started_frames_;
+    started_frames_.notify_one();
+
+    update_thread_.join();
+}
+
+void Application::dispatch_events(u64 until_ticks)
+{
+    {
+        lock_guard lock(pending_events_mutex_);
+
+        // События приходят в порядке возрастания времени
+        auto end = find_if(pending_events_.begin(), pending_events_.end(),
+                           [until_ticks](const SDL_Event& event) { return event.common.timestamp > until_ticks; });
+
+        dispatched_events_.assign(pending_events_.begin(), end);
+        pending_events_.erase(pending_events_.begin(), end);
+    }
+
+    for (const SDL_Event& event : dispatched_events_)
+        handle_sdl_event(event);
+}
+
+void Application::pace_frame()
+{
+    if (engine_params::target_fps <= 0)
+        return;
+
+    DV_PROFILE_SCOPE("pace_frame");
+
+    // SDL_DelayNS() может проспать дольше, чем нужно,
+    // поэтому последние миллисекунды ждём в активном цикле
+    constexpr u64 spin_ns = SDL_NS_PER_MS * 2;
+
+    const u64 frame_ns = SDL_NS_PER_SECOND / engine_params::target_fps;
+    u64 now = SDL_GetTicksNS();
+
+    if (now >= frame_deadline_)
+    {
+        // Кадр длился дольше, чем нужно. Если отстали больше чем на кадр, то не пытаемся наверстать
+        if (now - frame_deadline_ > frame_ns)
+            frame_deadline_ = now + frame_ns;
+        else
+            frame_deadline_ += frame_ns;
+
+        return;
+    }
+
+    u64 remaining = frame_deadline_ - now;
+
+    if (remaining > spin_ns)
+        SDL_DelayNS(remaining - spin_ns);
+
+    while (SDL_GetTicksNS() < frame_deadline_)
+        this_thread::yield();
+
+    frame_deadline_ += frame_ns;
+}
+
 SDL_AppResult Application::main_event(SDL_Event* event)
 {
-    handle_sdl_event(*event);
+    if (threaded_update_)
+    {
+        // События, которые требуют главного потока, обрабатываем сразу
+        if (event->type == SDL_EVENT_QUIT)
+            should_exit_ = true;
+        else if (event->type == SDL_EVENT_WINDOW_RESIZED)
+            glViewport(0, 0, event->window.data1, event->window.data2);
+
+        // Остальное передаём потоку симуляции вместе с временем события
+        lock_guard lock(pending_events_mutex_);
+        pending_events_.push_back(*event);
+    }
+    else
+    {
+        handle_sdl_event(*event);
+    }
 
     if (should_exit_)
+    {
+        stop_update_thread();
         return SDL_APP_SUCCESS;
+    }
     else
+    {
         return SDL_APP_CONTINUE;
+    }
 }
 
 } // namespace dviglo
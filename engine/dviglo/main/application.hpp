@@ -6,15 +6,23 @@
 #include "os_window.hpp"
 
 #include "../audio/audio.hpp"
+#include "../debug/profiler.hpp"
+#include "../fs/file_watcher.hpp"
 #include "../fs/log.hpp"
+#include "../gl_utils/fbo_pool.hpp"
+#include "../gl_utils/render_stats.hpp"
 #include "../gl_utils/shader_cache.hpp"
 #include "../gl_utils/texture_cache.hpp"
 #include "../res/freetype.hpp"
 #include "../std_utils/scope_guard.hpp"
+#include "../threading/job_system.hpp"
 
 #include <SDL3/SDL.h>
 
+#include <atomic>
 #include <memory>
+#include <mutex>
+#include <thread>
 
 
 namespace dviglo
@@ -29,8 +37,12 @@ private:
     // Порядок подсистем важен, так как влияет на очерёдность вызовов деструкторов
     std::unique_ptr<Log> log_;
     std::unique_ptr<OsWindow> os_window_;
+    std::unique_ptr<Profiler> profiler_;
+    std::unique_ptr<JobSystem> job_system_;
+    std::unique_ptr<FileWatcher> file_watcher_; // Только при engine_params::hot_reload
     std::unique_ptr<ShaderCache> shader_cache_;
     std::unique_ptr<TextureCache> texture_cache_;
+    std::unique_ptr<FboPool> fbo_pool_;
     std::unique_ptr<Audio> audio_;
     std::unique_ptr<FreeType> freetype_;
 
@@ -41,26 +53,105 @@ private:
     u64 duration_ = 0;
 #endif
 
+    // Если не пустой, то при закрытии приложения профайлер сохранит в этот файл
+    // последние кадры в формате Chrome Trace Event.
+    // Задаётся с помощью параметра -profile path
+    StrUtf8 profile_path_;
+
+    // Статистика рендеринга предыдущего кадра
+    RenderStats last_render_stats_;
+
+    // Если не пустой, то при закрытии приложения в этот файл будет сохранена
+    // статистика рендеринга всех кадров в формате CSV.
+    // Задаётся с помощью параметра -render_stats path
+    StrUtf8 render_stats_path_;
+
+    // Статистика всех кадров. Заполняется, только если задан render_stats_path_
+    std::vector<RenderStats> render_stats_history_;
+
+    // Сохраняет render_stats_history_ в render_stats_path_
+    void save_render_stats() const;
+
+    // Время начала предыдущего кадра
+    u64 prev_ticks_ = 0;
+
+    // Накопленное время, которое ещё не обработано в update() при фиксированном шаге
+    u64 accumulator_ = 0;
+
+    // См. interpolation_alpha()
+    std::atomic<f32> interpolation_alpha_ = 1.f;
+
+    // До какого момента должен длиться текущий кадр при ограничении частоты кадров
+    u64 frame_deadline_ = 0;
+
+    // Передаёт кэшам файлы, изменённые с прошлого кадра, и подменяет перезагруженные ресурсы
+    void apply_hot_reload();
+
+    // Вызывает update() один или несколько раз в зависимости от engine_params::fixed_update_hz
+    void run_updates(u64 ns);
+
+    // Ждёт до конца кадра, если задан engine_params::target_fps
+    void pace_frame();
+
+    // Копия engine_params::threaded_update на момент инициализации
+    bool threaded_update_ = false;
+
+    // Поток, в котором вызывается update() при threaded_update_
+    std::thread update_thread_;
+    std::atomic<bool> update_thread_running_ = false;
+
+    // Число кадров, начатых в главном потоке. Без фиксированного шага
+    // поток симуляции ждёт изменения этого значения перед каждым update()
+    std::atomic<u64> started_frames_ = 0;
+
+    // Момент времени, которому соответствует последнее состояние симуляции
+    std::atomic<u64> state_ticks_ = 0;
+
+    // События, которые главный поток передал потоку симуляции.
+    // У каждого события есть event.common.timestamp
+    std::mutex pending_events_mutex_;
+    std::vector<SDL_Event> pending_events_;
+
+    // Используется только в потоке симуляции, чтобы не выделять память каждый раз
+    std::vector<SDL_Event> dispatched_events_;
+
+    void update_thread_func();
+    void stop_update_thread();
+
+    // Передаёт в handle_sdl_event() события, которые произошли не позже until_ticks
+    void dispatch_events(u64 until_ticks);
+
 protected:
-    // Пользователь желает прервать главный цикл
-    bool should_exit_ = false;
+    // Пользователь желает прервать главный цикл.
+    // Атомарный, так как при threaded_update изменяется в потоке симуляции
+    std::atomic<bool> should_exit_ = false;
 
     Application(const std::vector<StrUtf8>& args);
-    virtual ~Application() = default;
+    virtual ~Application();
 
     virtual void setup() {}
     virtual void start() {}
     virtual void new_frame() {}
 
-    // Обработчики событий вызываются перед update()
+    // Обработчики событий вызываются перед update().
+    // При threaded_update вызываются в потоке симуляции. Закрытие приложения и изменение размера окна
+    // в этом режиме обрабатываются в главном потоке ещё до вызова handle_sdl_event()
     virtual void handle_sdl_event(const SDL_Event& event);
 
     virtual void update(u64 ns) { (void)ns; }
     virtual void draw() {}
 
+    // При фиксированном шаге - доля шага, которая накопилась после последнего update() (от 0 до 1).
+    // В draw() позволяет интерполировать положения объектов между двумя последними
+    // состояниями симуляции. Без фиксированного шага всегда 1
+    f32 interpolation_alpha() const { return interpolation_alpha_; }
+
 public:
     const std::vector<StrUtf8>& args() const { return args_; }
 
+    // Статистика рендеринга последнего завершённого кадра
+    const RenderStats& render_stats() const { return last_render_stats_; }
+
     // Методы ниже должны быть публичными, чтобы SDL мог их вызвать.
     // Пользователь не должен их вызывать
 
@@ -12,6 +12,13 @@ namespace dviglo
 namespace engine_params
 {
     StrUtf8 log_path = get_pref_path("", "dviglo2d") + "default.log";
+
+    // Если get_pref_path() вернула пустую строку, то кэш на диске выключается
+    StrUtf8 shader_cache_dir = []
+    {
+        StrUtf8 pref_path = get_pref_path("", "dviglo2d");
+        return pref_path.empty() ? pref_path : pref_path + "shader_cache/";
+    }();
 }
 
 } // namespace dviglo
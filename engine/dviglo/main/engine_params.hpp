@@ -25,6 +25,10 @@ namespace engine_params
 {
     extern StrUtf8 log_path;
 
+    // Папка для бинарников шейдерных программ (см. ShaderCache).
+    // Пустая строка выключает кэш шейдеров на диске
+    extern StrUtf8 shader_cache_dir;
+
     inline StrUtf8 window_title{"Игра"};
     inline glm::ivec2 window_size{800, 600};
     inline WindowMode window_mode = WindowMode::windowed;
@@ -38,6 +42,41 @@ namespace engine_params
     // другое значение - число сэмплов (рекомендуется 4 или 8).
     // Подробнее: https://habr.com/ru/articles/351706/
     inline i32 msaa_samples = 0;
+
+    // 0 - update() вызывается один раз за кадр с реальным временем кадра,
+    // другое значение - update() вызывается с фиксированным шагом (столько раз в секунду)
+    inline i32 fixed_update_hz = 0;
+
+    // Максимальное число вызовов update() за кадр при фиксированном шаге.
+    // Если компьютер не успевает, то лишнее время отбрасывается и игра замедляется,
+    // иначе каждый следующий кадр будет длиться всё дольше (spiral of death)
+    inline i32 max_updates_per_frame = 8;
+
+    // 0 - частота кадров не ограничивается,
+    // другое значение - желаемое число кадров в секунду (имеет смысл при выключенной vsync)
+    inline i32 target_fps = 0;
+
+    // Вызывать ли update() и обработчики событий в отдельном потоке.
+    // draw() при этом выполняется в главном потоке параллельно с update(), поэтому
+    // update() должен передавать в draw() неизменяемый снимок состояния игры
+    // (например через TripleBuffer), а не общие данные.
+    // Без фиксированного шага update() вызывается один раз на каждый отрендеренный кадр
+    inline bool threaded_update = false;
+
+    // Число рабочих потоков JobSystem (главный поток не учитывается).
+    // -1 - по числу логических ядер процессора, 0 - задачи выполняются только в главном потоке
+    inline i32 num_worker_threads = -1;
+
+    // Перезагружать ли шейдеры и текстуры, когда их файлы меняются на диске (см. FileWatcher).
+    // Удобно при настройке графики, так как не нужно перезапускать игру.
+    // Включается и параметром командной строки -hot_reload
+    inline bool hot_reload = false;
+
+    // Сколько последних кадров хранит профайлер
+    inline i32 profiler_max_frames = 300;
+
+    // Замерять ли время кадров на видеокарте (GL_TIME_ELAPSED)
+    inline bool profiler_gpu_timing = true;
 }
 
 } // namespace dviglo
@@ -6,6 +6,7 @@
 #include "engine_params.hpp"
 
 #include "../fs/log.hpp"
+#include "../gl_utils/gl_extensions.hpp"
 
 #include <glad/gl.h>
 
@@ -107,6 +108,8 @@ OsWindow::OsWindow()
     DV_LOG->writef_info("GL_RENDERER: {}", reinterpret_cast<const char*>(glGetString(GL_RENDERER)));
     DV_LOG->writef_info("GL_VERSION: {}", reinterpret_cast<const char*>(glGetString(GL_VERSION)));
 
+    gl_ext::load((GLADloadfunc)SDL_GL_GetProcAddress);
+
     instance_ = this;
     DV_LOG->write_debug("OsWindow constructed");
 }
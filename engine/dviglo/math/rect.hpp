@@ -66,6 +66,8 @@ struct Rect
     Rect operator+(const glm::vec2 offset) const { return Rect(pos + offset, size); }
     Rect operator-(const glm::vec2 offset) const { return Rect(pos - offset, size); }
 
+    bool operator==(const Rect& other) const = default;
+
     static const Rect zero;
 };
 
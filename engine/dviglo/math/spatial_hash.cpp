@@ -0,0 +1,274 @@
+// Copyright (c) the Dviglo project
+// License: MIT
+
+#include "spatial_hash.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+using namespace glm;
+using namespace std;
+
+
+namespace dviglo
+{
+
+SpatialHash::SpatialHash(f32 cell_size)
+    : cell_size_(cell_size)
+    , inv_cell_size_(1.f / cell_size)
+{
+    assert(cell_size > 0.f);
+}
+
+u32 SpatialHash::find_slot(u32 id) const
+{
+    u32 mask = (u32)id_slots_.size() - 1;
+
+    // Фибоначчиево хеширование перемешивает последовательные id
+    u32 pos = (u32)((id * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+
+    // Линейное пробирование. Таблица заполнена не более чем наполовину, поэтому свободная ячейка есть
+    while (id_slots_[pos].index != empty_slot && id_slots_[pos].id != id)
+        pos = (pos + 1) & mask;
+
+    return pos;
+}
+
+void SpatialHash::grow_id_slots()
+{
+    vector<IdSlot> old_slots = std::move(id_slots_);
+    id_slots_.assign(old_slots.empty() ? 64 : old_slots.size() * 2, {0, empty_slot});
+
+    for (const IdSlot& slot : old_slots)
+    {
+        if (slot.index != empty_slot)
+            id_slots_[find_slot(slot.id)] = slot;
+    }
+}
+
+void SpatialHash::insert_id(u32 id, u32 index)
+{
+    if ((items_.size() + 1) * 2 > id_slots_.size())
+        grow_id_slots();
+
+    id_slots_[find_slot(id)] = {id, index};
+}
+
+void SpatialHash::erase_id(u32 id)
+{
+    u32 mask = (u32)id_slots_.size() - 1;
+    u32 hole = find_slot(id);
+    assert(id_slots_[hole].index != empty_slot);
+
+    // Сдвигаем назад следующие элементы цепочки, чтобы поиск не оборвался на дыре
+    u32 pos = hole;
+
+    while (true)
+    {
+        pos = (pos + 1) & mask;
+
+        if (id_slots_[pos].index == empty_slot)
+            break;
+
+        u32 home = (u32)((id_slots_[pos].id * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+
+        // Элемент можно переместить в дыру, если его домашняя ячейка не лежит между дырой и им
+        if (((pos - home) & mask) >= ((pos - hole) & mask))
+        {
+            id_slots_[hole] = id_slots_[pos];
+            hole = pos;
+        }
+    }
+
+    id_slots_[hole].index = empty_slot;
+}
+
+bool SpatialHash::contains(u32 id) const
+{
+    return !id_slots_.empty() && id_slots_[find_slot(id)].index != empty_slot;
+}
+
+ivec2 SpatialHash::to_cell(vec2 point) const
+{
+    return ivec2((i32)floor(point.x * inv_cell_size_), (i32)floor(point.y * inv_cell_size_));
+}
+
+void SpatialHash::add_to_cells(u32 index)
+{
+    const Item& item = items_[index];
+
+    for (i32 y = item.min_cell.y; y <= item.max_cell.y; ++y)
+    {
+        for (i32 x = item.min_cell.x; x <= item.max_cell.x; ++x)
+            cells_[cell_key(x, y)].push_back(index);
+    }
+}
+
+void SpatialHash::remove_from_cells(u32 index)
+{
+    const Item& item = items_[index];
+
+    for (i32 y = item.min_cell.y; y <= item.max_cell.y; ++y)
+    {
+        for (i32 x = item.min_cell.x; x <= item.max_cell.x; ++x)
+        {
+            vector<u32>& cell = cells_[cell_key(x, y)];
+            auto it = find(cell.begin(), cell.end(), index);
+            assert(it != cell.end());
+
+            // Порядок в ячейке не важен
+            *it = cell.back();
+            cell.pop_back();
+        }
+    }
+}
+
+void SpatialHash::reindex_in_cells(u32 old_index, u32 new_index)
+{
+    const Item& item = items_[old_index];
+
+    for (i32 y = item.min_cell.y; y <= item.max_cell.y; ++y)
+    {
+        for (i32 x = item.min_cell.x; x <= item.max_cell.x; ++x)
+        {
+            vector<u32>& cell = cells_[cell_key(x, y)];
+            auto it = find(cell.begin(), cell.end(), old_index);
+            assert(it != cell.end());
+            *it = new_index;
+        }
+    }
+}
+
+void SpatialHash::remove_at(u32 index)
+{
+    remove_from_cells(index);
+    erase_id(items_[index].id);
+
+    u32 last_index = (u32)items_.size() - 1;
+
+    if (index != last_index)
+    {
+        reindex_in_cells(last_index, index);
+        items_[index] = items_[last_index];
+        id_slots_[find_slot(items_[index].id)].index = index;
+    }
+
+    items_.pop_back();
+}
+
+void SpatialHash::clear()
+{
+    items_.clear();
+    id_slots_.clear();
+    cells_.clear();
+}
+
+void SpatialHash::reserve(const Aabb& area, u32 num_items)
+{
+    items_.reserve(num_items);
+
+    while (num_items * 2 > id_slots_.size())
+        grow_id_slots();
+
+    ivec2 min_cell = to_cell(area.min);
+    ivec2 max_cell = to_cell(area.max);
+
+    for (i32 y = min_cell.y; y <= max_cell.y; ++y)
+    {
+        for (i32 x = min_cell.x; x <= max_cell.x; ++x)
+            cells_[cell_key(x, y)];
+    }
+}
+
+void SpatialHash::begin_update()
+{
+    ++update_stamp_;
+}
+
+void SpatialHash::update(u32 id, const Aabb& bounds, u32 category)
+{
+    ivec2 min_cell = to_cell(bounds.min);
+    ivec2 max_cell = to_cell(bounds.max);
+
+    u32 slot = id_slots_.empty() ? empty_slot : find_slot(id);
+
+    if (slot == empty_slot || id_slots_[slot].index == empty_slot)
+    {
+        u32 index = (u32)items_.size();
+        insert_id(id, index);
+        items_.push_back({id, category, bounds, min_cell, max_cell, update_stamp_});
+        add_to_cells(index);
+        return;
+    }
+
+    u32 index = id_slots_[slot].index;
+    Item& item = items_[index];
+    item.category = category;
+    item.bounds = bounds;
+    item.stamp = update_stamp_;
+
+    // Обычно объект за тик не покидает свои ячейки
+    if (item.min_cell == min_cell && item.max_cell == max_cell)
+        return;
+
+    remove_from_cells(index);
+    item.min_cell = min_cell;
+    item.max_cell = max_cell;
+    add_to_cells(index);
+}
+
+void SpatialHash::end_update()
+{
+    // Идём с конца, так как remove_at() перемещает последний элемент
+    for (i32 i = (i32)items_.size() - 1; i >= 0; --i)
+    {
+        if (items_[i].stamp != update_stamp_)
+            remove_at((u32)i);
+    }
+}
+
+void SpatialHash::remove(u32 id)
+{
+    if (id_slots_.empty())
+        return;
+
+    u32 index = id_slots_[find_slot(id)].index;
+
+    if (index != empty_slot)
+        remove_at(index);
+}
+
+void SpatialHash::query(const Aabb& area, u32 category_mask, vector<u32>& out) const
+{
+    ivec2 area_min_cell = to_cell(area.min);
+    ivec2 area_max_cell = to_cell(area.max);
+
+    for (i32 y = area_min_cell.y; y <= area_max_cell.y; ++y)
+    {
+        for (i32 x = area_min_cell.x; x <= area_max_cell.x; ++x)
+        {
+            auto it = cells_.find(cell_key(x, y));
+
+            if (it == cells_.end())
+                continue;
+
+            for (u32 index : it->second)
+            {
+                const Item& item = items_[index];
+
+                if (!(item.category & category_mask))
+                    continue;
+
+                // Объект добавляется только в первой ячейке, общей с area
+                if (x != std::max(area_min_cell.x, item.min_cell.x) || y != std::max(area_min_cell.y, item.min_cell.y))
+                    continue;
+
+                if (intersects(area, item.bounds))
+                    out.push_back(item.id);
+            }
+        }
+    }
+}
+
+} // namespace dviglo
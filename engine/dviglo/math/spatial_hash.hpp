@@ -0,0 +1,194 @@
+// Copyright (c) the Dviglo project
+// License: MIT
+
+/*
+
+Широкая фаза поиска столкновений: равномерная сетка, ячейки которой хранятся в хеш-таблице
+(поэтому размер мира не ограничен). Вместо проверки всех пар объектов (N * M) проверяются
+только объекты из общих ячеек.
+
+Пример использования (каждый тик):
+hash.begin_update();
+for (...)
+    hash.update(id, bounds, category);
+hash.end_update(); // Удаляет объекты, которые не были обновлены
+
+hash.query_pairs(cat_bullet, cat_enemy, [](u32 bullet_id, u32 enemy_id)
+{
+    // Точная проверка столкновения
+});
+
+Объекты, которые не сменили ячейки, обновляются без перестройки ячеек.
+
+*/
+
+#pragma once
+
+#include "rect.hpp"
+
+#include <unordered_map>
+#include <vector>
+
+
+namespace dviglo
+{
+
+class SpatialHash
+{
+private:
+    struct Item
+    {
+        u32 id;
+
+        // Маска категорий (например 1 << 0 - снаряды игрока, 1 << 1 - враги)
+        u32 category;
+
+        Aabb bounds;
+
+        // Диапазон ячеек, в которых находится объект (включительно)
+        glm::ivec2 min_cell;
+        glm::ivec2 max_cell;
+
+        // Значение update_stamp_ при последнем обновлении
+        u32 stamp;
+    };
+
+    f32 cell_size_;
+    f32 inv_cell_size_;
+
+    // Элементы хранятся плотно. При удалении на место удалённого перемещается последний
+    std::vector<Item> items_;
+
+    // Ячейка хеш-таблицы с открытой адресацией (id -> индекс в items_).
+    // В отличие от std::unordered_map, не выделяет память при каждой вставке
+    struct IdSlot
+    {
+        u32 id;
+        u32 index; // empty_slot - ячейка свободна
+    };
+
+    static constexpr u32 empty_slot = 0xFFFFFFFF;
+
+    // Размер - степень двойки
+    std::vector<IdSlot> id_slots_;
+
+    // Индексы элементов в items_, находящихся в ячейке.
+    // Пустые ячейки не удаляются, чтобы не выделять память повторно
+    std::unordered_map<u64, std::vector<u32>> cells_;
+
+    // Увеличивается в begin_update()
+    u32 update_stamp_ = 0;
+
+    static u64 cell_key(i32 x, i32 y) { return ((u64)(u32)x << 32) | (u32)y; }
+
+    // Возвращает позицию id в id_slots_ или позицию свободной ячейки, куда его можно вставить
+    u32 find_slot(u32 id) const;
+
+    void insert_id(u32 id, u32 index);
+    void erase_id(u32 id);
+
+    // Увеличивает id_slots_ вдвое
+    void grow_id_slots();
+
+    glm::ivec2 to_cell(glm::vec2 point) const;
+
+    void add_to_cells(u32 index);
+    void remove_from_cells(u32 index);
+
+    // Заменяет индекс элемента в его ячейках
+    void reindex_in_cells(u32 old_index, u32 new_index);
+
+    void remove_at(u32 index);
+
+    // Касание считается пересечением, чтобы не пропустить кандидатов
+    static bool intersects(const Aabb& a, const Aabb& b)
+    {
+        return a.min.x <= b.max.x && b.min.x <= a.max.x && a.min.y <= b.max.y && b.min.y <= a.max.y;
+    }
+
+public:
+    // cell_size желательно выбирать порядка размера типичного объекта
+    SpatialHash(f32 cell_size = 64.f);
+
+    f32 cell_size() const { return cell_size_; }
+
+    // Число объектов
+    u32 size() const { return (u32)items_.size(); }
+
+    bool contains(u32 id) const;
+
+    // Удаляет все объекты и освобождает память ячеек
+    void clear();
+
+    // Заранее создаёт ячейки в области и выделяет память под num_items объектов,
+    // чтобы в процессе игры память не выделялась
+    void reserve(const Aabb& area, u32 num_items);
+
+    void begin_update();
+
+    // Добавляет объект или обновляет его положение
+    void update(u32 id, const Aabb& bounds, u32 category);
+
+    // Удаляет объекты, для которых не был вызван update() после begin_update()
+    void end_update();
+
+    void remove(u32 id);
+
+    // Добавляет в out (не очищая его) id объектов из категорий category_mask,
+    // прямоугольники которых пересекаются с area. Каждый объект добавляется один раз
+    void query(const Aabb& area, u32 category_mask, std::vector<u32>& out) const;
+
+    // Вызывает func(a_id, b_id) для каждой пары объектов с пересекающимися прямоугольниками,
+    // где a из категорий mask_a, а b из категорий mask_b. Каждая пара передаётся один раз.
+    // Внутри func нельзя менять SpatialHash
+    template<typename Func>
+    void query_pairs(u32 mask_a, u32 mask_b, Func&& func) const;
+};
+
+template<typename Func>
+void SpatialHash::query_pairs(u32 mask_a, u32 mask_b, Func&& func) const
+{
+    for (u32 a_index = 0; a_index < (u32)items_.size(); ++a_index)
+    {
+        const Item& a = items_[a_index];
+
+        if (!(a.category & mask_a))
+            continue;
+
+        for (i32 y = a.min_cell.y; y <= a.max_cell.y; ++y)
+        {
+            for (i32 x = a.min_cell.x; x <= a.max_cell.x; ++x)
+            {
+                auto it = cells_.find(cell_key(x, y));
+
+                if (it == cells_.end())
+                    continue;
+
+                for (u32 b_index : it->second)
+                {
+                    if (b_index == a_index)
+                        continue;
+
+                    const Item& b = items_[b_index];
+
+                    if (!(b.category & mask_b))
+                        continue;
+
+                    // Если a и b подходят под обе маски, то пара встретится дважды
+                    if ((a.category & mask_b) && (b.category & mask_a) && b_index < a_index)
+                        continue;
+
+                    // Объекты могут делить несколько ячеек. Пару обрабатываем только
+                    // в первой общей ячейке
+                    if (x != std::max(a.min_cell.x, b.min_cell.x) || y != std::max(a.min_cell.y, b.min_cell.y))
+                        continue;
+
+                    if (intersects(a.bounds, b.bounds))
+                        func(a.id, b.id);
+                }
+            }
+        }
+    }
+}
+
+} // namespace dviglo
@@ -3,9 +3,11 @@
 
 #include "image.hpp"
 
+#include "../debug/profiler.hpp"
 #include "../fs/file_base.hpp"
 #include "../fs/log.hpp"
 #include "../math/rect.hpp"
+#include "../threading/job_system.hpp"
 
 // Miniz сжимает PNG сильнее и быстрее, чем stb_image_write
 #define DV_USE_MINIZ 1
@@ -113,6 +115,8 @@ Image::~Image()
 
 Image::Image(const StrUtf8& file_path, bool use_error_image)
 {
+    DV_PROFILE_SCOPE("Image::Image(file_path)");
+
     data_ = (u8*)stbi_load(file_path.c_str(), &size_.x, &size_.y, &num_components_, 0);
 
     if (!data_)
@@ -235,7 +239,8 @@ Image Image::to_rgba(u32 color)
     return ret;
 }
 
-// TODO: Сделать многопоточным, SIMD или на видеокарте размывать
+// Проходы распараллеливаются с помощью DV_JOB_SYSTEM, если он есть.
+// TODO: SIMD или размывать на видеокарте
 void Image::blur_triangle(i32 radius)
 {
     if (!radius)
@@ -263,60 +268,78 @@ void Image::blur_triangle(i32 radius)
 
     Image tmp(size_, num_components_);
 
+    // Столбцы обрабатываются независимо, поэтому проходы можно распараллелить
+    auto for_columns = [this](const auto& func)
+    {
+        // Меньшие части не окупают накладные расходы на запуск задач
+        const i32 min_columns_per_job = 16;
+
+        if (DV_JOB_SYSTEM)
+            DV_JOB_SYSTEM->parallel_for(0, size_.x, min_columns_per_job, func);
+        else
+            func(0, size_.x);
+    };
+
     // Размываем по вертикали и сохраняем результат в tmp
-    for (i32 x = 0; x < size_.x; ++x)
+    for_columns([&](i32 begin_x, i32 end_x)
     {
-        for (i32 y = 0; y < size_.y; ++y)
+        for (i32 x = begin_x; x < end_x; ++x)
         {
-            // Сразу записываем вклад центрального пикселя.
-            // Его вес равен radius + 1
-            u32 sum = (u32)pixel_ptr(x, y)[0] * (radius + 1);
-            i32 dist = 1;
-
-            while (dist <= radius)
+            for (i32 y = 0; y < size_.y; ++y)
             {
-                i32 weight = 1 + radius - dist;
+                // Сразу записываем вклад центрального пикселя.
+                // Его вес равен radius + 1
+                u32 sum = (u32)pixel_ptr(x, y)[0] * (radius + 1);
+                i32 dist = 1;
 
-                // Пиксель вне изображения черный, ноль можно не плюсовать.
-                // Так что тут все корректно
-                if (is_inside(x, y + dist))
-                    sum += (u32)pixel_ptr(x, y + dist)[0] * weight;
+                while (dist <= radius)
+                {
+                    i32 weight = 1 + radius - dist;
 
-                if (is_inside(x, y - dist))
-                    sum += (u32)pixel_ptr(x, y - dist)[0] * weight;
+                    // Пиксель вне изображения черный, ноль можно не плюсовать.
+                    // Так что тут все корректно
+                    if (is_inside(x, y + dist))
+                        sum += (u32)pixel_ptr(x, y + dist)[0] * weight;
 
-                ++dist;
-            }
+                    if (is_inside(x, y - dist))
+                        sum += (u32)pixel_ptr(x, y - dist)[0] * weight;
+
+                    ++dist;
+                }
 
-            // Сумму нужно поделить на общий вес, иначе изменится яркость изображения
-            tmp.pixel_ptr(x, y)[0] = u8(sum / total_weight);
+                // Сумму нужно поделить на общий вес, иначе изменится яркость изображения
+                tmp.pixel_ptr(x, y)[0] = u8(sum / total_weight);
+            }
         }
-    }
+    });
 
     // Размываем по горизонтали и сохраняем результат назад в структуру.
-    for (i32 x = 0; x < size_.x; ++x)
+    for_columns([&](i32 begin_x, i32 end_x)
     {
-        for (i32 y = 0; y < size_.y; ++y)
+        for (i32 x = begin_x; x < end_x; ++x)
         {
-            u32 sum = (u32)tmp.pixel_ptr(x, y)[0] * (radius + 1);
-            i32 dist = 1;
-
-            while (dist <= radius)
+            for (i32 y = 0; y < size_.y; ++y)
             {
-                i32 weight = 1 + radius - dist;
+                u32 sum = (u32)tmp.pixel_ptr(x, y)[0] * (radius + 1);
+                i32 dist = 1;
 
-                if (tmp.is_inside(x + dist, y))
-                    sum += (u32)tmp.pixel_ptr(x + dist, y)[0] * weight;
+                while (dist <= radius)
+                {
+                    i32 weight = 1 + radius - dist;
 
-                if (tmp.is_inside(x - dist, y))
-                    sum += (u32)tmp.pixel_ptr(x - dist, y)[0] * weight;
+                    if (tmp.is_inside(x + dist, y))
+                        sum += (u32)tmp.pixel_ptr(x + dist, y)[0] * weight;
 
-                ++dist;
-            }
+                    if (tmp.is_inside(x - dist, y))
+                        sum += (u32)tmp.pixel_ptr(x - dist, y)[0] * weight;
 
-            pixel_ptr(x, y)[0] = u8(sum / total_weight);
+                    ++dist;
+                }
+
+                pixel_ptr(x, y)[0] = u8(sum / total_weight);
+            }
         }
-    }
+    });
 }
 
 const Image error_image = []
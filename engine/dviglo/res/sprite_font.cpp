@@ -5,6 +5,7 @@
 
 #include "freetype.hpp"
 
+#include "../debug/profiler.hpp"
 #include "../fs/file.hpp"
 #include "../fs/log.hpp"
 #include "../fs/path.hpp"
@@ -33,6 +34,8 @@ namespace dviglo
 
 SpriteFont::SpriteFont(const StrUtf8& file_path)
 {
+    DV_PROFILE_SCOPE("SpriteFont::SpriteFont(file_path)");
+
     xml_document doc;
     xml_parse_result result = doc.load_file(file_path.c_str());
     if (!result)
@@ -377,6 +380,7 @@ RenderedGlyph render_glyph_simpe(FT_Face face, const SFSettingsSimple& font_sett
 
 SpriteFont::SpriteFont(const SFSettingsSimple& settings)
 {
+    DV_PROFILE_SCOPE("SpriteFont::SpriteFont(SFSettingsSimple)");
     auto begin_time = chrono::high_resolution_clock::now();
 
     FreeTypeFace face(settings);
@@ -557,6 +561,7 @@ RenderedGlyph render_glyph_contour(FT_Face face, const SFSettingsContour& font_s
 
 SpriteFont::SpriteFont(const SFSettingsContour& settings)
 {
+    DV_PROFILE_SCOPE("SpriteFont::SpriteFont(SFSettingsContour)");
     auto begin_time = chrono::high_resolution_clock::now();
 
     FreeTypeFace face(settings);
@@ -772,6 +777,7 @@ RenderedGlyph render_glyph_outlined(FT_Face face, const SFSettingsOutlined& sett
 
 SpriteFont::SpriteFont(const SFSettingsOutlined& settings)
 {
+    DV_PROFILE_SCOPE("SpriteFont::SpriteFont(SFSettingsOutlined)");
     auto begin_time = chrono::high_resolution_clock::now();
 
     FreeTypeFace face(settings);
@@ -127,9 +127,14 @@ public:
 
     const std::vector<std::shared_ptr<Texture>>& textures() const { return textures_; }
 
-    const Glyph& glyph(u32 code_point)
+    // Не изменяет шрифт, поэтому может вызываться из разных потоков.
+    // Если символа нет в шрифте, то возвращает пустой глиф с некорректным номером текстуры
+    const Glyph& glyph(u32 code_point) const
     {
-        return glyphs_[code_point];
+        static const Glyph empty_glyph{};
+
+        auto it = glyphs_.find(code_point);
+        return it != glyphs_.end() ? it->second : empty_glyph;
     }
 
     i32 line_height() const { return line_height_; }
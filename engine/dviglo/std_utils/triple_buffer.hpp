@@ -0,0 +1,85 @@
+// Copyright (c) the Dviglo project
+// License: MIT
+
+/*
+
+Тройная буферизация без блокировок для передачи данных от одного потока-писателя
+одному потоку-читателю. Писатель никогда не ждёт читателя, а читатель всегда
+получает последнюю полностью записанную версию данных.
+
+Пример использования:
+TripleBuffer<vector<Sprite>> snapshots;
+
+// Поток симуляции
+vector<Sprite>& sprites = snapshots.write_buffer();
+sprites.clear(); // Буфер содержит старые данные
+...
+snapshots.publish();
+
+// Поток рендеринга
+snapshots.acquire();
+for (const Sprite& sprite : snapshots.read_buffer())
+    ...
+
+*/
+
+#pragma once
+
+#include "../common/primitive_types.hpp"
+
+#include <atomic>
+
+
+namespace dviglo
+{
+
+template<typename T>
+class TripleBuffer
+{
+private:
+    // Бит в middle_, который означает, что писатель опубликовал новые данные,
+    // а читатель их ещё не забрал
+    static constexpr u32 fresh_bit = 1 << 2;
+    static constexpr u32 index_mask = fresh_bit - 1;
+
+    T buffers_[3];
+
+    // Индекс буфера, в который сейчас пишет писатель
+    u32 write_index_ = 0;
+
+    // Индекс буфера, который не используется ни писателем, ни читателем (+ fresh_bit)
+    std::atomic<u32> middle_{1};
+
+    // Индекс буфера, из которого сейчас читает читатель
+    u32 read_index_ = 2;
+
+public:
+    // Вызывается только в потоке-писателе
+    T& write_buffer() { return buffers_[write_index_]; }
+
+    // Делает записанный буфер доступным читателю и выдаёт писателю другой буфер.
+    // Вызывается только в потоке-писателе
+    void publish()
+    {
+        u32 prev = middle_.exchange(write_index_ | fresh_bit, std::memory_order_acq_rel);
+        write_index_ = prev & index_mask;
+    }
+
+    // Забирает последний опубликованный буфер, если он есть.
+    // Возвращает false, если новых данных нет (read_buffer() при этом не меняется).
+    // Вызывается только в потоке-читателе
+    bool acquire()
+    {
+        if (!(middle_.load(std::memory_order_relaxed) & fresh_bit))
+            return false;
+
+        u32 prev = middle_.exchange(read_index_, std::memory_order_acq_rel);
+        read_index_ = prev & index_mask;
+        return true;
+    }
+
+    // Вызывается только в потоке-читателе
+    const T& read_buffer() const { return buffers_[read_index_]; }
+};
+
+} // namespace dviglo
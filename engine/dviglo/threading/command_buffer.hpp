@@ -0,0 +1,132 @@
+// Copyright (c) the Dviglo project
+// License: MIT
+
+/*
+
+Очередь отложенных команд. Системы, которые выполняются параллельно, не могут
+создавать и удалять объекты (это меняет общие контейнеры), поэтому записывают
+такие изменения в свой CommandBuffer, а команды выполняются позже в одном потоке.
+
+Пример использования:
+commands.push([pos] { create_laser(pos); });
+...
+commands.execute(); // В главном потоке
+
+Команды хранятся в одном непрерывном буфере, ёмкость которого только растёт,
+поэтому после прогрева запись команд не выделяет память.
+Команда должна быть тривиально копируемой (например лямбда, которая захватывает
+по значению числа, векторы и идентификаторы объектов).
+Класс не потокобезопасный.
+
+*/
+
+#pragma once
+
+#include "../common/primitive_types.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+
+namespace dviglo
+{
+
+class CommandBuffer
+{
+private:
+    // Выравнивание всех записей в буфере
+    static constexpr size_t alignment = alignof(std::max_align_t);
+
+    struct Header
+    {
+        void (*invoke)(const void* command);
+
+        // Размер записи вместе с заголовком
+        u32 size;
+    };
+
+    static constexpr size_t align_up(size_t size) { return (size + alignment - 1) / alignment * alignment; }
+
+    static constexpr size_t payload_offset = (sizeof(Header) + alignment - 1) / alignment * alignment;
+
+    // Буфер из std::max_align_t, чтобы данные были выровнены
+    std::vector<std::max_align_t> data_;
+
+    // Занятый размер буфера в байтах
+    size_t size_ = 0;
+
+    u32 num_commands_ = 0;
+
+    bool executing_ = false;
+
+    std::byte* bytes() { return reinterpret_cast<std::byte*>(data_.data()); }
+
+public:
+    u32 num_commands() const { return num_commands_; }
+    bool empty() const { return num_commands_ == 0; }
+
+    template<typename Command>
+    void push(const Command& command)
+    {
+        static_assert(std::is_trivially_copyable_v<Command> && std::is_trivially_destructible_v<Command>,
+                      "Команда должна быть тривиально копируемой");
+        static_assert(alignof(Command) <= alignment);
+
+        // Команды не могут добавлять команды в тот же буфер во время выполнения
+        assert(!executing_);
+
+        size_t record_size = payload_offset + align_up(sizeof(Command));
+        size_t new_size = size_ + record_size;
+
+        if (new_size > data_.size() * sizeof(std::max_align_t))
+        {
+            size_t min_elements = (new_size + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t);
+            data_.resize(std::max(data_.size() * 2, min_elements));
+        }
+
+        Header header;
+        header.invoke = [](const void* ptr) { (*static_cast<const Command*>(ptr))(); };
+        header.size = (u32)record_size;
+
+        std::byte* record = bytes() + size_;
+        std::memcpy(record, &header, sizeof(header));
+        new (record + payload_offset) Command(command);
+
+        size_ = new_size;
+        ++num_commands_;
+    }
+
+    // Выполняет команды в порядке записи и очищает буфер (память сохраняется)
+    void execute()
+    {
+        executing_ = true;
+
+        for (size_t offset = 0; offset < size_;)
+        {
+            std::byte* record = bytes() + offset;
+
+            Header header;
+            std::memcpy(&header, record, sizeof(header));
+            header.invoke(record + payload_offset);
+
+            offset += header.size;
+        }
+
+        executing_ = false;
+        clear();
+    }
+
+    // Удаляет команды без выполнения
+    void clear()
+    {
+        size_ = 0;
+        num_commands_ = 0;
+    }
+};
+
+} // namespace dviglo
@@ -0,0 +1,248 @@
+// Copyright (c) the Dviglo project
+// License: MIT
+
+#include "job_system.hpp"
+
+#include "../fs/log.hpp"
+
+#include <SDL3/SDL.h>
+
+#include <algorithm>
+#include <cassert>
+
+using namespace std;
+
+
+namespace dviglo
+{
+
+// Индекс очереди текущего потока. 0 - главный поток или поток, не принадлежащий JobSystem
+static thread_local u32 current_queue_index = 0;
+
+void JobSystem::WorkerQueue::push_back(Job&& job)
+{
+    if (count == jobs.size())
+    {
+        // Переносим задачи в буфер вдвое большего размера
+        vector<Job> new_jobs(jobs.empty() ? 64 : jobs.size() * 2);
+
+        for (u32 i = 0; i < count; ++i)
+            new_jobs[i] = std::move(jobs[(head + i) & (jobs.size() - 1)]);
+
+        jobs.swap(new_jobs);
+        head = 0;
+    }
+
+    jobs[(head + count) & (jobs.size() - 1)] = std::move(job);
+    ++count;
+}
+
+bool JobSystem::WorkerQueue::pop_back(Job& out_job)
+{
+    if (!count)
+        return false;
+
+    --count;
+    out_job = std::move(jobs[(head + count) & (jobs.size() - 1)]);
+    return true;
+}
+
+bool JobSystem::WorkerQueue::pop_front(Job& out_job)
+{
+    if (!count)
+        return false;
+
+    out_job = std::move(jobs[head]);
+    head = (head + 1) & (jobs.size() - 1);
+    --count;
+    return true;
+}
+
+JobSystem::JobSystem(i32 num_worker_threads)
+{
+    // Главный поток тоже выполняет задачи, поэтому одно ядро оставляем ему
+    if (num_worker_threads < 0)
+        num_worker_threads = max(SDL_GetNumLogicalCPUCores() - 1, 1);
+
+    for (i32 i = 0; i < num_worker_threads + 1; ++i)
+        queues_.push_back(make_unique<WorkerQueue>());
+
+    for (i32 i = 0; i < num_worker_threads; ++i)
+        workers_.emplace_back(&JobSystem::worker_func, this, (u32)i + 1);
+
+    assert(!instance_);
+    instance_ = this;
+    DV_LOG->writef_debug("JobSystem constructed | {} worker threads", num_worker_threads);
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        lock_guard lock(sleep_mutex_);
+        stopping_ = true;
+    }
+
+    wake_up_.notify_all();
+
+    // Перед завершением потоки выполняют оставшиеся задачи
+    for (thread& worker : workers_)
+        worker.join();
+
+    instance_ = nullptr;
+    DV_LOG->write_debug("JobSystem destructed");
+}
+
+void JobSystem::worker_func(u32 queue_index)
+{
+    current_queue_index = queue_index;
+
+    while (true)
+    {
+        Job job;
+
+        if (try_pop(job))
+        {
+            execute(job);
+            continue;
+        }
+
+        unique_lock lock(sleep_mutex_);
+        wake_up_.wait(lock, [this] { return stopping_ || num_queued_jobs_ > 0; });
+
+        if (stopping_ && num_queued_jobs_ == 0)
+            return;
+    }
+}
+
+void JobSystem::push(Job&& job)
+{
+    // Поток мог быть создан другим JobSystem
+    u32 queue_index = current_queue_index < queues_.size() ? current_queue_index : 0;
+
+    {
+        WorkerQueue& queue = *queues_[queue_index];
+        lock_guard lock(queue.mutex);
+        queue.push_back(std::move(job));
+    }
+
+    ++num_queued_jobs_;
+
+    // Захват мьютекса гарантирует, что поток не пропустит пробуждение между
+    // проверкой num_queued_jobs_ и засыпанием
+    {
+        lock_guard lock(sleep_mutex_);
+    }
+
+    wake_up_.notify_one();
+}
+
+bool JobSystem::try_pop(Job& out_job)
+{
+    u32 own_index = current_queue_index < queues_.size() ? current_queue_index : 0;
+
+    // Свои задачи берём с конца (последние добавленные задачи скорее всего ещё в кэше)
+    {
+        WorkerQueue& queue = *queues_[own_index];
+        lock_guard lock(queue.mutex);
+
+        if (queue.pop_back(out_job))
+        {
+            --num_queued_jobs_;
+            return true;
+        }
+    }
+
+    // Чужие задачи воруем с начала
+    for (u32 i = 1; i < queues_.size(); ++i)
+    {
+        WorkerQueue& queue = *queues_[(own_index + i) % queues_.size()];
+        lock_guard lock(queue.mutex);
+
+        if (queue.pop_front(out_job))
+        {
+            --num_queued_jobs_;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void JobSystem::execute(Job& job)
+{
+    job.func();
+
+    JobCounter* counter = job.counter;
+
+    if (!counter)
+        return;
+
+    // Пока счётчик не обнуляется, мьютекс не нужен
+    i32 value = counter->value_.load(memory_order_relaxed);
+
+    while (value > 1)
+    {
+        if (counter->value_.compare_exchange_weak(value, value - 1, memory_order_acq_rel))
+            return;
+    }
+
+    vector<Job> continuations;
+
+    {
+        // Обнуление под мьютексом: деструктор счётчика захватывает этот же мьютекс,
+        // поэтому ожидающий поток не уничтожит счётчик, пока мы с ним работаем
+        lock_guard lock(counter->continuations_mutex_);
+
+        if (counter->value_.fetch_sub(1, memory_order_acq_rel) != 1)
+            return;
+
+        // Счётчик обнулился. Запускаем задачи, которые его ждали
+        continuations.swap(counter->continuations_);
+    }
+
+    for (Job& continuation : continuations)
+        push(std::move(continuation));
+}
+
+void JobSystem::run(function<void()> func, JobCounter* counter)
+{
+    if (counter)
+        counter->value_.fetch_add(1, memory_order_relaxed);
+
+    push({std::move(func), counter});
+}
+
+void JobSystem::run_after(JobCounter& dependency, function<void()> func, JobCounter* counter)
+{
+    if (counter)
+        counter->value_.fetch_add(1, memory_order_relaxed);
+
+    {
+        // Значение проверяется под мьютексом, иначе задача может быть добавлена
+        // уже после того, как execute() забрал список ожидающих задач
+        lock_guard lock(dependency.continuations_mutex_);
+
+        if (!dependency.is_done())
+        {
+            dependency.continuations_.push_back({std::move(func), counter});
+            return;
+        }
+    }
+
+    push({std::move(func), counter});
+}
+
+void JobSystem::wait(JobCounter& counter)
+{
+    while (!counter.is_done())
+    {
+        Job job;
+
+        if (try_pop(job))
+            execute(job);
+        else
+            this_thread::yield(); // Задачи выполняются в других потоках
+    }
+}
+
+} // namespace dviglo
@@ -0,0 +1,174 @@
+// Copyright (c) the Dviglo project
+// License: MIT
+
+#pragma once
+
+#include "../common/primitive_types.hpp"
+#include "../debug/profiler.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace dviglo
+{
+
+class JobCounter;
+
+// Задача для JobSystem
+struct Job
+{
+    std::function<void()> func;
+
+    // Уменьшается, когда задача выполнена. Может быть nullptr
+    JobCounter* counter = nullptr;
+};
+
+// Число незавершённых задач. Используется для ожидания и зависимостей между задачами.
+// Счётчик должен существовать, пока все связанные с ним задачи не будут выполнены
+class JobCounter
+{
+    friend class JobSystem;
+
+private:
+    std::atomic<i32> value_{0};
+
+    // Задачи, которые будут запущены, когда счётчик обнулится
+    std::mutex continuations_mutex_;
+    std::vector<Job> continuations_;
+
+public:
+    JobCounter() = default;
+
+    // Ждёт, пока JobSystem::execute() закончит работу со счётчиком
+    ~JobCounter() { std::lock_guard lock(continuations_mutex_); }
+
+    JobCounter(const JobCounter&) = delete;
+    JobCounter& operator=(const JobCounter&) = delete;
+
+    bool is_done() const { return value_.load(std::memory_order_acquire) == 0; }
+};
+
+// Пул потоков. У каждого потока своя очередь задач. Поток берёт задачи из конца своей очереди,
+// а когда она пуста - ворует задачи из начала чужих очередей (work stealing).
+// Главный поток тоже имеет очередь и выполняет задачи, пока ждёт в wait()
+class JobSystem
+{
+private:
+    // Инициализируется в конструкторе
+    inline static JobSystem* instance_ = nullptr;
+
+    // Двусторонняя очередь на кольцевом буфере. Ёмкость только растёт,
+    // поэтому после прогрева очередь не выделяет память (в отличие от std::deque)
+    struct WorkerQueue
+    {
+        std::mutex mutex;
+
+        // Размер - степень двойки
+        std::vector<Job> jobs;
+
+        // Индекс первой задачи
+        u32 head = 0;
+
+        u32 count = 0;
+
+        void push_back(Job&& job);
+        bool pop_back(Job& out_job);
+        bool pop_front(Job& out_job);
+    };
+
+    // Очередь 0 принадлежит главному потоку и потокам, которые не являются рабочими.
+    // Очередь i принадлежит рабочему потоку i
+    std::vector<std::unique_ptr<WorkerQueue>> queues_;
+
+    std::vector<std::thread> workers_;
+
+    // Число задач в очередях. Рабочие потоки спят, пока оно равно нулю
+    std::atomic<i32> num_queued_jobs_{0};
+
+    std::mutex sleep_mutex_;
+    std::condition_variable wake_up_;
+    bool stopping_ = false;
+
+    void worker_func(u32 queue_index);
+
+    // Кладёт задачу в очередь текущего потока
+    void push(Job&& job);
+
+    // Берёт задачу из своей очереди или ворует из чужой
+    bool try_pop(Job& out_job);
+
+    // Выполняет задачу и обновляет её счётчик
+    void execute(Job& job);
+
+public:
+    static JobSystem* instance() { return instance_; }
+
+    // num_worker_threads - число дополнительных потоков (главный поток не учитывается).
+    // -1 - по числу логических ядер процессора
+    JobSystem(i32 num_worker_threads = -1);
+    ~JobSystem();
+
+    // Число потоков, которые выполняют задачи, включая главный
+    i32 num_threads() const { return (i32)workers_.size() + 1; }
+
+    // Запускает задачу. Если counter != nullptr, то он увеличивается сейчас и уменьшается по завершении
+    void run(std::function<void()> func, JobCounter* counter = nullptr);
+
+    // Запускает задачу, когда dependency обнулится
+    void run_after(JobCounter& dependency, std::function<void()> func, JobCounter* counter = nullptr);
+
+    // Выполняет задачи (любые, не только связанные со счётчиком), пока счётчик не обнулится
+    void wait(JobCounter& counter);
+
+    // Делит диапазон [begin, end) на части не меньше min_chunk_size и вызывает
+    // func(chunk_begin, chunk_end) для каждой части параллельно. Возвращает управление,
+    // когда все части обработаны.
+    // Шаблон, а не std::function, чтобы лямбда с большим числом захваченных переменных
+    // не выделяла память: в задачу попадает только указатель на неё
+    template<typename Func>
+    void parallel_for(i32 begin, i32 end, i32 min_chunk_size, const Func& func);
+};
+
+template<typename Func>
+void JobSystem::parallel_for(i32 begin, i32 end, i32 min_chunk_size, const Func& func)
+{
+    if (begin >= end)
+        return;
+
+    DV_PROFILE_SCOPE("JobSystem::parallel_for");
+
+    i32 count = end - begin;
+    min_chunk_size = std::max(min_chunk_size, 1);
+
+    // Частей больше, чем потоков, чтобы потоки могли воровать друг у друга
+    i32 num_chunks = std::clamp(count / min_chunk_size, 1, num_threads() * 4);
+
+    if (num_chunks == 1)
+    {
+        func(begin, end);
+        return;
+    }
+
+    JobCounter counter;
+
+    for (i32 i = 0; i < num_chunks; ++i)
+    {
+        // Распределяем остаток от деления равномерно
+        i32 chunk_begin = begin + (i32)((i64)count * i / num_chunks);
+        i32 chunk_end = begin + (i32)((i64)count * (i + 1) / num_chunks);
+        run([&func, chunk_begin, chunk_end] { func(chunk_begin, chunk_end); }, &counter);
+    }
+
+    wait(counter);
+}
+
+#define DV_JOB_SYSTEM (dviglo::JobSystem::instance())
+
+} // namespace dviglo
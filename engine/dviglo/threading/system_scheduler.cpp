@@ -0,0 +1,155 @@
+// Copyright (c) the Dviglo project
+// License: MIT
+
+#include "system_scheduler.hpp"
+
+#include "../debug/profiler.hpp"
+
+#include <algorithm>
+
+using namespace std;
+
+
+namespace dviglo
+{
+
+namespace internal
+{
+    u32 next_access_type_id()
+    {
+        static atomic<u32> counter{0};
+        return counter++;
+    }
+}
+
+static bool intersects(const SystemAccess& a, const SystemAccess& b)
+{
+    for (u32 id : a.type_ids)
+    {
+        if (find(b.type_ids.begin(), b.type_ids.end(), id) != b.type_ids.end())
+            return true;
+    }
+
+    return false;
+}
+
+bool SystemScheduler::conflicts(const System& a, const System& b)
+{
+    return intersects(a.writes, b.reads) || intersects(a.writes, b.writes) || intersects(a.reads, b.writes);
+}
+
+void SystemScheduler::add(const char* name, SystemAccess reads, SystemAccess writes, SystemFunc func)
+{
+    unique_ptr<System> system = make_unique<System>();
+    system->name = name;
+    system->func = std::move(func);
+    system->reads = std::move(reads);
+    system->writes = std::move(writes);
+    system->exclusive = false;
+
+    u32 index = (u32)systems_.size();
+
+    // Зависимости ищем только среди параллельных систем после последней эксклюзивной,
+    // так как эксклюзивная система и так разделяет группы
+    for (i32 i = (i32)index - 1; i >= 0 && !systems_[i]->exclusive; --i)
+    {
+        if (conflicts(*systems_[i], *system))
+        {
+            systems_[i]->successors.push_back(index);
+            ++system->num_dependencies;
+        }
+    }
+
+    systems_.push_back(std::move(system));
+}
+
+void SystemScheduler::add_exclusive(const char* name, SystemFunc func)
+{
+    unique_ptr<System> system = make_unique<System>();
+    system->name = name;
+    system->func = std::move(func);
+    system->exclusive = true;
+    systems_.push_back(std::move(system));
+}
+
+void SystemScheduler::execute(System& system)
+{
+    ProfilerScope profiler_scope(system.name);
+    system.func(ns_, system.commands);
+}
+
+void SystemScheduler::schedule(System& system)
+{
+    // Лямбда из двух указателей помещается в std::function без выделения памяти
+    System* system_ptr = &system;
+
+    DV_JOB_SYSTEM->run([this, system_ptr]
+    {
+        execute(*system_ptr);
+
+        for (u32 successor_index : system_ptr->successors)
+        {
+            System& successor = *systems_[successor_index];
+
+            // Последняя завершившаяся зависимость запускает систему
+            if (successor.pending_dependencies.fetch_sub(1, memory_order_acq_rel) == 1)
+                schedule(successor);
+        }
+    }, &counter_);
+}
+
+void SystemScheduler::run_group(u32 begin, u32 end)
+{
+    if (begin == end)
+        return;
+
+    if (DV_JOB_SYSTEM)
+    {
+        for (u32 i = begin; i < end; ++i)
+            systems_[i]->pending_dependencies.store(systems_[i]->num_dependencies, memory_order_relaxed);
+
+        for (u32 i = begin; i < end; ++i)
+        {
+            if (systems_[i]->num_dependencies == 0)
+                schedule(*systems_[i]);
+        }
+
+        DV_JOB_SYSTEM->wait(counter_);
+    }
+    else
+    {
+        // Порядок добавления не нарушает зависимости
+        for (u32 i = begin; i < end; ++i)
+            execute(*systems_[i]);
+    }
+
+    // Команды выполняются в порядке добавления систем, поэтому результат не зависит
+    // от того, в каком порядке системы завершились
+    for (u32 i = begin; i < end; ++i)
+        systems_[i]->commands.execute();
+}
+
+void SystemScheduler::run(u64 ns)
+{
+    ns_ = ns;
+    u32 group_begin = 0;
+
+    for (u32 i = 0; i < (u32)systems_.size(); ++i)
+    {
+        System& system = *systems_[i];
+
+        if (!system.exclusive)
+            continue;
+
+        run_group(group_begin, i);
+
+        execute(system);
+        system.commands.execute();
+
+        group_begin = i + 1;
+    }
+
+    run_group(group_begin, (u32)systems_.size());
+}
+
+} // namespace dviglo
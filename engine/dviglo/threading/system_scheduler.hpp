@@ -0,0 +1,132 @@
+// Copyright (c) the Dviglo project
+// License: MIT
+
+/*
+
+Планировщик систем (функций апдейта). Для каждой системы указывается, какие типы данных
+(например компоненты ECS) она читает и какие меняет. Системы без конфликтов выполняются
+параллельно в JobSystem, а конфликтующие - в порядке добавления.
+Две системы конфликтуют, если одна из них меняет тип, который другая читает или меняет.
+
+Создавать и удалять объекты параллельные системы должны через CommandBuffer, который
+передаётся в систему. Команды выполняются в главном потоке, когда завершатся все
+параллельные системы перед ближайшей эксклюзивной системой (или в конце run()).
+Эксклюзивная система выполняется в главном потоке одна и может менять что угодно.
+
+Пример использования:
+scheduler.add("s_move", reads<CVelocity>(), writes<CObject>(), [](u64 ns, CommandBuffer& commands) { ... });
+scheduler.add_exclusive("s_remove_destroyed", [](u64 ns, CommandBuffer& commands) { ... });
+...
+scheduler.run(ns); // Каждый тик
+
+Если JobSystem не создан, то системы выполняются последовательно.
+
+*/
+
+#pragma once
+
+#include "command_buffer.hpp"
+#include "job_system.hpp"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+
+namespace dviglo
+{
+
+namespace internal
+{
+    u32 next_access_type_id();
+
+    // Уникальный номер типа
+    template<typename T>
+    u32 access_type_id()
+    {
+        static const u32 id = next_access_type_id();
+        return id;
+    }
+}
+
+// Список типов, к которым обращается система
+struct SystemAccess
+{
+    std::vector<u32> type_ids;
+};
+
+template<typename... Types>
+SystemAccess reads()
+{
+    return SystemAccess{{internal::access_type_id<Types>()...}};
+}
+
+template<typename... Types>
+SystemAccess writes()
+{
+    return SystemAccess{{internal::access_type_id<Types>()...}};
+}
+
+class SystemScheduler
+{
+public:
+    using SystemFunc = std::function<void(u64 ns, CommandBuffer& commands)>;
+
+private:
+    struct System
+    {
+        // Строковый литерал. Используется как имя зоны профайлера
+        const char* name;
+
+        SystemFunc func;
+        SystemAccess reads;
+        SystemAccess writes;
+        bool exclusive;
+
+        // Системы, которые ждут завершения этой
+        std::vector<u32> successors;
+
+        // Число систем, которые должны завершиться перед этой
+        i32 num_dependencies = 0;
+
+        // Сколько зависимостей ещё не завершилось в текущем run()
+        std::atomic<i32> pending_dependencies{0};
+
+        CommandBuffer commands;
+    };
+
+    std::vector<std::unique_ptr<System>> systems_;
+
+    u64 ns_ = 0;
+
+    // Счётчик задач текущей группы параллельных систем
+    JobCounter counter_;
+
+    static bool conflicts(const System& a, const System& b);
+
+    void execute(System& system);
+
+    // Запускает систему в JobSystem
+    void schedule(System& system);
+
+    // Выполняет параллельные системы [begin, end), а затем их команды
+    void run_group(u32 begin, u32 end);
+
+public:
+    SystemScheduler() = default;
+    SystemScheduler(const SystemScheduler&) = delete;
+    SystemScheduler& operator=(const SystemScheduler&) = delete;
+
+    // name должен быть строковым литералом
+    void add(const char* name, SystemAccess reads, SystemAccess writes, SystemFunc func);
+
+    // Система выполняется в главном потоке, когда все предыдущие системы завершены
+    // и их команды выполнены
+    void add_exclusive(const char* name, SystemFunc func);
+
+    // Выполняет все системы и возвращает управление, когда они завершены
+    void run(u64 ns);
+};
+
+} // namespace dviglo
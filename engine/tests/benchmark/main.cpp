@@ -0,0 +1,31 @@
+// Copyright (c) the Dviglo project
+// License: MIT
+
+// Замеры производительности подсистем движка
+
+#include <dviglo/fs/fs_base.hpp>
+#include <dviglo/fs/log.hpp>
+
+#include <iostream>
+
+using namespace dviglo;
+using namespace std;
+
+
+void benchmark_math_spatial_hash();
+void benchmark_threading_job_system();
+
+int main(int argc, char* argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    setlocale(LC_CTYPE, "en_US.UTF-8");
+
+    Log log(get_pref_path("", "dviglo2d") + "benchmark.log");
+
+    benchmark_math_spatial_hash();
+    benchmark_threading_job_system();
+
+    return 0;
+}
@@ -0,0 +1,151 @@
+// Copyright (c) the Dviglo project
+// License: MIT
+
+#include <dviglo/math/spatial_hash.hpp>
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace dviglo;
+using namespace glm;
+using namespace std;
+
+
+namespace
+{
+
+// Сколько тиков симулируется в каждом замере
+constexpr i32 num_ticks = 20;
+
+constexpr u32 cat_laser = 1 << 0;
+constexpr u32 cat_projectile = 1 << 1;
+
+struct BenchObject
+{
+    vec2 pos;
+    vec2 velocity;
+    vec2 half_size;
+    u32 category;
+};
+
+Aabb bounds(const BenchObject& object)
+{
+    return Aabb(object.pos - object.half_size, object.pos + object.half_size);
+}
+
+bool intersects(const Aabb& a, const Aabb& b)
+{
+    return a.min.x <= b.max.x && b.min.x <= a.max.x && a.min.y <= b.max.y && b.min.y <= a.max.y;
+}
+
+// Объекты летают по полю размером с поле леталки
+vector<BenchObject> spawn(i32 count)
+{
+    mt19937 generator(42);
+    uniform_real_distribution<f32> x_dist(0.f, 900.f);
+    uniform_real_distribution<f32> y_dist(0.f, 700.f);
+    uniform_real_distribution<f32> speed_dist(-300.f, 300.f);
+
+    vector<BenchObject> ret(count);
+
+    for (i32 i = 0; i < count; ++i)
+    {
+        BenchObject& object = ret[i];
+        object.pos = vec2(x_dist(generator), y_dist(generator));
+        object.velocity = vec2(speed_dist(generator), speed_dist(generator));
+
+        // Половина объектов - лазеры игрока, половина - снаряды врагов
+        object.category = i % 2 ? cat_laser : cat_projectile;
+        object.half_size = object.category == cat_laser ? vec2(2.f, 8.f) : vec2(5.f, 5.f);
+    }
+
+    return ret;
+}
+
+void move(vector<BenchObject>& objects)
+{
+    const f32 time_step = 1.f / 60.f;
+
+    for (BenchObject& object : objects)
+        object.pos += object.velocity * time_step;
+}
+
+// Возвращает время одного тика в миллисекундах и число найденных пар
+pair<f64, u64> measure_brute_force(i32 count)
+{
+    vector<BenchObject> objects = spawn(count);
+    u64 num_pairs = 0;
+    auto begin = chrono::steady_clock::now();
+
+    for (i32 tick = 0; tick < num_ticks; ++tick)
+    {
+        move(objects);
+
+        for (const BenchObject& a : objects)
+        {
+            if (a.category != cat_laser)
+                continue;
+
+            for (const BenchObject& b : objects)
+            {
+                if (b.category == cat_projectile && intersects(bounds(a), bounds(b)))
+                    ++num_pairs;
+            }
+        }
+    }
+
+    chrono::duration<f64, milli> duration = chrono::steady_clock::now() - begin;
+    return {duration.count() / num_ticks, num_pairs};
+}
+
+pair<f64, u64> measure_spatial_hash(i32 count)
+{
+    vector<BenchObject> objects = spawn(count);
+    SpatialHash hash(32.f);
+    u64 num_pairs = 0;
+    auto begin = chrono::steady_clock::now();
+
+    for (i32 tick = 0; tick < num_ticks; ++tick)
+    {
+        move(objects);
+
+        hash.begin_update();
+
+        for (u32 i = 0; i < (u32)objects.size(); ++i)
+            hash.update(i, bounds(objects[i]), objects[i].category);
+
+        hash.end_update();
+
+        hash.query_pairs(cat_laser, cat_projectile, [&num_pairs](u32, u32) { ++num_pairs; });
+    }
+
+    chrono::duration<f64, milli> duration = chrono::steady_clock::now() - begin;
+    return {duration.count() / num_ticks, num_pairs};
+}
+
+} // namespace
+
+void benchmark_math_spatial_hash()
+{
+    cout << "SpatialHash (время одного тика)" << endl;
+
+    for (i32 count : {500, 1000, 2000, 4000, 8000})
+    {
+        auto [brute_force_ms, brute_force_pairs] = measure_brute_force(count);
+        auto [hash_ms, hash_pairs] = measure_spatial_hash(count);
+
+        cout << "    объектов: " << setw(5) << count
+             << " | перебор: " << fixed << setprecision(3) << setw(9) << brute_force_ms << " мс"
+             << " | SpatialHash: " << setw(7) << hash_ms << " мс"
+             << " | пар: " << hash_pairs;
+
+        // Широкая фаза не должна терять пары
+        if (brute_force_pairs != hash_pairs)
+            cout << " | ОШИБКА: перебор нашёл " << brute_force_pairs;
+
+        cout << endl;
+    }
+}
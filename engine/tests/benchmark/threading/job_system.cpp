@@ -0,0 +1,74 @@
+// Copyright (c) the Dviglo project
+// License: MIT
+
+#include <dviglo/threading/job_system.hpp>
+
+#include <SDL3/SDL.h>
+
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+using namespace dviglo;
+using namespace std;
+
+
+// Сколько раз повторяется каждый замер (берётся лучший результат)
+static constexpr i32 num_runs = 5;
+
+// Нагрузка, которая упирается в процессор, а не в память
+static f32 heavy_work(i32 index)
+{
+    f32 value = (f32)index;
+
+    for (i32 i = 0; i < 200; ++i)
+        value = sqrt(value * value + 1.f);
+
+    return value;
+}
+
+// Возвращает лучшее время в миллисекундах
+static f64 measure(i32 num_worker_threads, vector<f32>& results)
+{
+    JobSystem job_system(num_worker_threads);
+    f64 best_ms = 1e100;
+
+    for (i32 run = 0; run < num_runs; ++run)
+    {
+        auto begin = chrono::steady_clock::now();
+
+        job_system.parallel_for(0, (i32)results.size(), 1024, [&results](i32 begin_index, i32 end_index)
+        {
+            for (i32 i = begin_index; i < end_index; ++i)
+                results[i] = heavy_work(i);
+        });
+
+        chrono::duration<f64, milli> duration = chrono::steady_clock::now() - begin;
+        best_ms = min(best_ms, duration.count());
+    }
+
+    return best_ms;
+}
+
+void benchmark_threading_job_system()
+{
+    cout << "JobSystem::parallel_for" << endl;
+
+    vector<f32> results(1 << 20);
+    i32 num_cores = SDL_GetNumLogicalCPUCores();
+    f64 single_thread_ms = 0.0;
+
+    for (i32 num_threads = 1; num_threads <= num_cores; ++num_threads)
+    {
+        f64 ms = measure(num_threads - 1, results);
+
+        if (num_threads == 1)
+            single_thread_ms = ms;
+
+        cout << "    потоков: " << setw(2) << num_threads
+             << " | " << fixed << setprecision(2) << setw(8) << ms << " мс"
+             << " | ускорение: " << single_thread_ms / ms << endl;
+    }
+}
@@ -4,7 +4,7 @@
 #include "app.hpp"
 
 #include <dviglo/fs/fs_base.hpp>
-#include <dviglo/gl_utils/fbo.hpp>
+#include <dviglo/gl_utils/fbo_pool.hpp>
 #include <dviglo/gl_utils/texture_cache.hpp>
 #include <dviglo/main/engine_params.hpp>
 #include <dviglo/main/os_window.hpp>
@@ -25,6 +25,14 @@ void App::setup()
     engine_params::window_size = ivec2(800, 800);
     engine_params::window_mode = WindowMode::resizable;
     engine_params::msaa_samples = 4; // При значении 8 крэшится на сервере ГитХаба в Линуксе
+
+    // Параметр -threaded_update вызывает update() в отдельном потоке
+    for (const StrUtf8& arg : args())
+    {
+        if (arg == "-threaded_update")
+            engine_params::threaded_update = true;
+    }
+
     Texture::default_params.min_filter = GL_LINEAR_MIPMAP_LINEAR;
     Texture::default_params.mag_filter = GL_LINEAR;
 }
@@ -56,15 +64,20 @@ void App::start()
     if (!Mix_PlayMusic(music_, -1))
         DV_LOG->writef_error("App::start(): !Mix_PlayMusic(...) | {}", SDL_GetError());
 
-    // Рендерим в текстуру
-    Fbo fbo(ivec2(256, 256));
-    fbo.bind();
-    glViewport(0, 0, fbo.texture()->size().x, fbo.texture()->size().y);
+    // Рендерим в текстуру с MSAA
+    Fbo* msaa_fbo = DV_FBO_POOL->acquire({.size = ivec2(256, 256), .samples = 4});
+    msaa_fbo->bind();
+    glViewport(0, 0, msaa_fbo->size().x, msaa_fbo->size().y);
     glClearColor(1.f, 1.f, 0.f, 1.f); // Жёлтый фон
     glClear(GL_COLOR_BUFFER_BIT);
     sprite_batch_->prepare_ogl(true, true); // Отражаем вертикально
     sprite_batch_->draw_string("Отрендеренная сцена", font_.get(), vec2{4.f, 1.f}, 0xFF000000);
     sprite_batch_->flush();
+
+    // Усредняем сэмплы в обычный Fbo. Текстуру забираем себе, поэтому Fbo не из пула
+    Fbo fbo(msaa_fbo->size());
+    msaa_fbo->resolve(fbo);
+    DV_FBO_POOL->release(msaa_fbo);
     rendered_scene_ = fbo.move_texture();
     rendered_scene_->bind();
     glGenerateMipmap(GL_TEXTURE_2D);
@@ -101,42 +114,44 @@ void App::on_key(const SDL_KeyboardEvent& event_data)
     }
 }
 
-static f32 rotation = 0.f;
-static StrUtf8 fps_text = "FPS: ?";
-static f32 scale = 1.f;
-static f32 scale_sign = 1.f;
-
 void App::update(u64 ns)
 {
-    static u64 frame_counter = 0;
-    static u64 time_counter = 0;
-
-    ++frame_counter;
-    time_counter += ns;
+    ++frame_counter_;
+    time_counter_ += ns;
 
     // Обновляем fps_text каждые пол секунды
-    if (time_counter >= SDL_NS_PER_SECOND / 2)
+    if (time_counter_ >= SDL_NS_PER_SECOND / 2)
     {
-        u64 fps = frame_counter * SDL_NS_PER_SECOND / time_counter;
-        fps_text = format("FPS: {}", fps);
-        frame_counter = 0;
-        time_counter = 0;
+        u64 fps = frame_counter_ * SDL_NS_PER_SECOND / time_counter_;
+        state_.fps_text = format("FPS: {}", fps);
+        frame_counter_ = 0;
+        time_counter_ = 0;
     }
 
-    rotation += ns * 0.000'000'000'1f;
-    while (rotation >= 360.f)
-        rotation -= 360.f;
+    state_.rotation += ns * 0.000'000'000'1f;
+    while (state_.rotation >= 360.f)
+        state_.rotation -= 360.f;
 
-    if (scale >= 2.f)
-        scale_sign = -1.f;
-    else if (scale <= 0.5f)
-        scale_sign = 1.f;
+    if (state_.scale >= 2.f)
+        scale_sign_ = -1.f;
+    else if (state_.scale <= 0.5f)
+        scale_sign_ = 1.f;
 
-    scale += scale_sign * ns * 0.0000000005f;
+    state_.scale += scale_sign_ * ns * 0.0000000005f;
+
+    snapshots_.write_buffer() = state_;
+    snapshots_.publish();
 }
 
 void App::draw()
 {
+    // Если новых данных нет, то рисуем предыдущее состояние
+    snapshots_.acquire();
+    const Snapshot& snapshot = snapshots_.read_buffer();
+    f32 rotation = snapshot.rotation;
+    f32 scale = snapshot.scale;
+    const StrUtf8& fps_text = snapshot.fps_text;
+
     ivec2 screen_size;
     SDL_GetWindowSizeInPixels(DV_OS_WINDOW->window(), &screen_size.x, &screen_size.y);
 
@@ -5,6 +5,7 @@
 
 #include <dviglo/graphics/sprite_batch.hpp>
 #include <dviglo/main/application.hpp>
+#include <dviglo/std_utils/triple_buffer.hpp>
 
 #include <SDL3_mixer/SDL_mixer.h>
 
@@ -12,6 +13,14 @@ using namespace dviglo;
 using namespace std;
 
 
+// Состояние, которое update() передаёт в draw()
+struct Snapshot
+{
+    f32 rotation = 0.f;
+    f32 scale = 1.f;
+    StrUtf8 fps_text = "FPS: ?";
+};
+
 class App : public Application
 {
 private:
@@ -23,6 +32,16 @@ private:
     /// Отрендеренная в текстуру сцена
     unique_ptr<Texture> rendered_scene_;
 
+    // Состояние симуляции. Используется только в update() (при -threaded_update - в потоке симуляции)
+    Snapshot state_;
+    f32 scale_sign_ = 1.f;
+    u64 frame_counter_ = 0;
+    u64 time_counter_ = 0;
+
+    // update() публикует копию state_, а draw() забирает последнюю опубликованную.
+    // Так draw() не читает данные, которые в этот момент меняет поток симуляции
+    TripleBuffer<Snapshot> snapshots_;
+
 public:
     App(const vector<StrUtf8>& args);
     ~App() override;
@@ -0,0 +1,70 @@
+// Copyright (c) the Dviglo project
+// License: MIT
+
+#include "../force_assert.hpp"
+
+#include <dviglo/debug/profiler.hpp>
+#include <dviglo/fs/fs_base.hpp>
+#include <dviglo/fs/log.hpp>
+
+#include <thread>
+
+using namespace dviglo;
+using namespace std;
+
+
+void test_debug_profiler()
+{
+    Log log(get_pref_path("", "dviglo2d") + "tester.log");
+
+    // Без профайлера зоны ничего не делают
+    {
+        DV_PROFILE_SCOPE("без профайлера");
+    }
+
+    {
+        // Без OpenGL-контекста
+        Profiler profiler(3, false);
+
+        for (i32 i = 0; i < 5; ++i)
+        {
+            profiler.begin_frame();
+
+            {
+                DV_PROFILE_SCOPE("внешняя");
+
+                {
+                    DV_PROFILE_SCOPE("внутренняя");
+                }
+            }
+
+            thread worker([] { DV_PROFILE_SCOPE("поток"); });
+            worker.join();
+
+            profiler.end_frame();
+        }
+
+        // Хранятся только последние кадры
+        vector<ProfilerFrame> frames = profiler.frames();
+        assert(frames.size() == 3);
+        assert(frames.front().index == 3);
+        assert(frames.back().index == 5);
+
+        // Вложенная зона завершается раньше внешней
+        const vector<ProfilerZone>& zones = frames.back().zones;
+        assert(zones.size() == 3);
+        assert(StrViewUtf8(zones[0].name) == "внутренняя" && zones[0].depth == 1);
+        assert(StrViewUtf8(zones[1].name) == "внешняя" && zones[1].depth == 0);
+        assert(zones[0].thread_index == 0);
+        assert(StrViewUtf8(zones[2].name) == "поток" && zones[2].thread_index != 0 && zones[2].depth == 0);
+
+        assert(profiler.summary().starts_with("frame: "));
+        assert(profiler.save_chrome_trace(get_pref_path("", "dviglo2d") + "tester_trace.json"));
+
+        // Выключенный профайлер не записывает кадры
+        profiler.set_enabled(false);
+        profiler.begin_frame();
+        profiler.end_frame();
+        assert(profiler.frames().back().index == 5);
+    }
+}
@@ -0,0 +1,101 @@
+// Copyright (c) the Dviglo project
+// License: MIT
+
+#include "../force_assert.hpp"
+
+#include <dviglo/fs/file_base.hpp>
+#include <dviglo/fs/file_watcher.hpp>
+#include <dviglo/fs/fs_base.hpp>
+#include <dviglo/fs/log.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio> // rename(), remove()
+#include <thread>
+
+using namespace dviglo;
+using namespace std;
+
+
+// Записывает в файл строку
+static void write_file(const StrUtf8& path, StrViewUtf8 content)
+{
+    FILE* stream = file_open(path, "wb");
+    assert(stream);
+    assert(file_write(content.data(), 1, (i32)content.size(), stream) == (i32)content.size());
+    file_close(stream);
+}
+
+// Собирает изменения, пока их не станет не меньше expected_count (или пока не пройдёт 2 секунды).
+// Изменения приходят из фонового потока, поэтому сразу после записи файла их может ещё не быть
+static vector<StrUtf8> wait_changes(FileWatcher& watcher, size_t expected_count)
+{
+    vector<StrUtf8> ret;
+    auto deadline = chrono::steady_clock::now() + chrono::seconds(2);
+
+    while (ret.size() < expected_count && chrono::steady_clock::now() < deadline)
+    {
+        for (StrUtf8& path : watcher.take_changes())
+            ret.push_back(std::move(path));
+
+        this_thread::sleep_for(chrono::milliseconds(10));
+    }
+
+    // Даём время лишним событиям, чтобы проверить, что их нет
+    this_thread::sleep_for(chrono::milliseconds(50));
+
+    for (StrUtf8& path : watcher.take_changes())
+        ret.push_back(std::move(path));
+
+    return ret;
+}
+
+void test_fs_file_watcher()
+{
+#ifndef _WIN32 // В Windows FileWatcher пока ничего не отслеживает
+    Log log(get_pref_path("", "dviglo2d") + "tester.log");
+
+    StrUtf8 dir = get_pref_path("", "dviglo2d") + "file_watcher_test/";
+    create_dir_silent(dir);
+
+    StrUtf8 a_path = dir + "a.txt";
+    StrUtf8 b_path = dir + "b.txt";
+    StrUtf8 tmp_path = dir + "tmp.txt";
+    StrUtf8 other_path = dir + "other.txt";
+
+    remove(b_path.c_str());
+    write_file(a_path, "1");
+
+    {
+        FileWatcher watcher;
+        watcher.add(a_path);
+        watcher.add(a_path); // Повторная регистрация не дублирует изменения
+        watcher.add(b_path); // Файла ещё нет
+        assert(watcher.take_changes().empty());
+
+        // Запись и затем замена через переименование (так сохраняют многие редакторы).
+        // Незарегистрированные файлы в той же папке игнорируются
+        write_file(a_path, "2");
+        write_file(tmp_path, "3");
+        assert(rename(tmp_path.c_str(), a_path.c_str()) == 0);
+        write_file(other_path, "4");
+
+        vector<StrUtf8> changes = wait_changes(watcher, 1);
+        assert(changes.size() == 1 && changes[0] == a_path);
+
+        // Файл, которого не было при регистрации, появляется через переименование
+        write_file(tmp_path, "5");
+        assert(rename(tmp_path.c_str(), b_path.c_str()) == 0);
+
+        changes = wait_changes(watcher, 1);
+        assert(changes.size() == 1 && changes[0] == b_path);
+
+        // Изменения забираются один раз
+        assert(watcher.take_changes().empty());
+    }
+
+    remove(a_path.c_str());
+    remove(b_path.c_str());
+    remove(other_path.c_str());
+#endif
+}
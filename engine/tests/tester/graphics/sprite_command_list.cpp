@@ -0,0 +1,53 @@
+// Copyright (c) the Dviglo project
+// License: MIT
+
+#include "../force_assert.hpp"
+
+#include <dviglo/graphics/sprite_command_list.hpp>
+
+#include <thread>
+
+using namespace dviglo;
+using namespace glm;
+using namespace std;
+
+
+void test_graphics_sprite_command_list()
+{
+    {
+        SpriteCommandList list;
+        assert(list.empty());
+
+        list.set_shape_color(0xFF0000FF);
+        list.draw_rect(Rect(0.f, 0.f, 10.f, 20.f));
+        list.draw_triangle({0.f, 0.f}, {1.f, 0.f}, {0.f, 1.f});
+
+        // Подряд идущие треугольники попадают в одну порцию
+        assert(list.batches().size() == 1);
+        assert(list.batches()[0].num_vertices == 9);
+        assert(list.t_vertices()[0].color == 0xFF0000FF);
+        assert(list.t_vertices()[1].position == vec2(10.f, 0.f));
+
+        list.clear();
+        assert(list.empty() && list.t_vertices().empty());
+    }
+
+    // Списки можно заполнять в разных потоках, а потом объединить
+    {
+        SpriteCommandList lists[2];
+
+        thread worker([&lists] { lists[1].draw_disk({0.f, 0.f}, 5.f, 8); });
+        lists[0].draw_rect(Rect(0.f, 0.f, 1.f, 1.f));
+        worker.join();
+
+        SpriteCommandList merged;
+        merged.append(lists[0]);
+        merged.append(lists[1]);
+
+        // Порции с одинаковыми настройками объединились
+        assert(merged.batches().size() == 1);
+        assert(merged.batches()[0].first_vertex == 0);
+        assert(merged.batches()[0].num_vertices == 6 + 8 * 3);
+        assert(merged.t_vertices().size() == 6 + 8 * 3);
+    }
+}
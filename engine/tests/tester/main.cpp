@@ -6,13 +6,29 @@
 using namespace std;
 
 
+void test_debug_profiler();
+void test_fs_file_watcher();
+void test_graphics_sprite_command_list();
 void test_io_path();
+void test_math_spatial_hash();
 void test_std_utils_str();
+void test_std_utils_triple_buffer();
+void test_threading_command_buffer();
+void test_threading_job_system();
+void test_threading_system_scheduler();
 
 void run()
 {
+    test_debug_profiler();
+    test_fs_file_watcher();
+    test_graphics_sprite_command_list();
     test_io_path();
+    test_math_spatial_hash();
     test_std_utils_str();
+    test_std_utils_triple_buffer();
+    test_threading_command_buffer();
+    test_threading_job_system();
+    test_threading_system_scheduler();
 }
 
 int main(int argc, char* argv[])
@@ -0,0 +1,166 @@
+// Copyright (c) the Dviglo project
+// License: MIT
+
+#include "../force_assert.hpp"
+
+#include <dviglo/math/spatial_hash.hpp>
+
+#include <algorithm>
+#include <random>
+#include <set>
+#include <utility>
+
+using namespace dviglo;
+using namespace glm;
+using namespace std;
+
+
+namespace
+{
+
+struct TestObject
+{
+    u32 id;
+    u32 category;
+    Aabb bounds;
+};
+
+bool intersects(const Aabb& a, const Aabb& b)
+{
+    return a.min.x <= b.max.x && b.min.x <= a.max.x && a.min.y <= b.max.y && b.min.y <= a.max.y;
+}
+
+// Пары, найденные перебором. Первый элемент пары - из mask_a
+set<pair<u32, u32>> brute_force_pairs(const vector<TestObject>& objects, u32 mask_a, u32 mask_b)
+{
+    set<pair<u32, u32>> ret;
+
+    for (const TestObject& a : objects)
+    {
+        for (const TestObject& b : objects)
+        {
+            if (a.id == b.id || !(a.category & mask_a) || !(b.category & mask_b) || !intersects(a.bounds, b.bounds))
+                continue;
+
+            // Если оба объекта подходят под обе маски, то пару учитываем один раз
+            if ((a.category & mask_b) && (b.category & mask_a) && ret.contains({b.id, a.id}))
+                continue;
+
+            ret.insert({a.id, b.id});
+        }
+    }
+
+    return ret;
+}
+
+set<pair<u32, u32>> hash_pairs(const SpatialHash& hash, u32 mask_a, u32 mask_b)
+{
+    set<pair<u32, u32>> ret;
+
+    hash.query_pairs(mask_a, mask_b, [&](u32 a_id, u32 b_id)
+    {
+        // Каждая пара передаётся один раз
+        assert(!ret.contains({a_id, b_id}) && !ret.contains({b_id, a_id}));
+        ret.insert({a_id, b_id});
+    });
+
+    return ret;
+}
+
+// Сравнивает без учёта порядка внутри пар
+bool same_pairs(const set<pair<u32, u32>>& a, const set<pair<u32, u32>>& b)
+{
+    if (a.size() != b.size())
+        return false;
+
+    for (const pair<u32, u32>& p : a)
+    {
+        if (!b.contains(p) && !b.contains({p.second, p.first}))
+            return false;
+    }
+
+    return true;
+}
+
+} // namespace
+
+void test_math_spatial_hash()
+{
+    // Объект в нескольких ячейках находится один раз
+    {
+        SpatialHash hash(10.f);
+        hash.update(1, Aabb(-15.f, -15.f, 25.f, 25.f), 1);
+        hash.update(2, Aabb(0.f, 0.f, 1.f, 1.f), 2);
+        assert(hash.size() == 2);
+
+        vector<u32> found;
+        hash.query(Aabb(-100.f, -100.f, 100.f, 100.f), 0xFFFFFFFF, found);
+        sort(found.begin(), found.end());
+        assert(found == vector<u32>({1, 2}));
+
+        found.clear();
+        hash.query(Aabb(20.f, 20.f, 30.f, 30.f), 0xFFFFFFFF, found);
+        assert(found == vector<u32>({1}));
+
+        found.clear();
+        hash.query(Aabb(-100.f, -100.f, 100.f, 100.f), 2, found);
+        assert(found == vector<u32>({2}));
+
+        u32 num_pairs = 0;
+        hash.query_pairs(1, 2, [&](u32 a, u32 b) { assert(a == 1 && b == 2); ++num_pairs; });
+        assert(num_pairs == 1);
+
+        // Объекты, не обновлённые после begin_update(), удаляются
+        hash.begin_update();
+        hash.update(2, Aabb(50.f, 50.f, 51.f, 51.f), 2);
+        hash.end_update();
+        assert(hash.size() == 1);
+        assert(!hash.contains(1) && hash.contains(2));
+
+        hash.remove(2);
+        assert(hash.size() == 0);
+    }
+
+    // Случайные объекты сравниваются с перебором, в том числе после перемещений
+    {
+        mt19937 generator(12345);
+        uniform_real_distribution<f32> pos_dist(-200.f, 200.f);
+        uniform_real_distribution<f32> size_dist(1.f, 40.f);
+        uniform_int_distribution<u32> category_dist(0, 2);
+
+        vector<TestObject> objects;
+
+        for (u32 i = 0; i < 300; ++i)
+        {
+            vec2 pos(pos_dist(generator), pos_dist(generator));
+            vec2 size(size_dist(generator), size_dist(generator));
+            objects.push_back({i * 7 + 3, 1u << category_dist(generator), Aabb(pos, pos + size)});
+        }
+
+        SpatialHash hash(16.f);
+
+        for (i32 tick = 0; tick < 5; ++tick)
+        {
+            // Часть объектов исчезает
+            if (tick > 0)
+                objects.erase(objects.begin(), objects.begin() + 10);
+
+            hash.begin_update();
+
+            for (TestObject& object : objects)
+            {
+                vec2 offset(pos_dist(generator) * 0.05f, pos_dist(generator) * 0.05f);
+                object.bounds = Aabb(object.bounds.min + offset, object.bounds.max + offset);
+                hash.update(object.id, object.bounds, object.category);
+            }
+
+            hash.end_update();
+
+            assert(hash.size() == objects.size());
+
+            assert(same_pairs(hash_pairs(hash, 1, 2), brute_force_pairs(objects, 1, 2)));
+            assert(same_pairs(hash_pairs(hash, 1 | 2, 2 | 4), brute_force_pairs(objects, 1 | 2, 2 | 4)));
+            assert(same_pairs(hash_pairs(hash, 4, 4), brute_force_pairs(objects, 4, 4)));
+        }
+    }
+}
@@ -0,0 +1,67 @@
+// Copyright (c) the Dviglo project
+// License: MIT
+
+#include "../force_assert.hpp"
+
+#include <dviglo/std_utils/triple_buffer.hpp>
+
+#include <thread>
+
+using namespace dviglo;
+using namespace std;
+
+
+void test_std_utils_triple_buffer()
+{
+    {
+        TripleBuffer<i32> buffer;
+        assert(!buffer.acquire());
+
+        buffer.write_buffer() = 1;
+        buffer.publish();
+        buffer.write_buffer() = 2;
+        buffer.publish();
+
+        // Читатель получает только последнюю версию
+        assert(buffer.acquire());
+        assert(buffer.read_buffer() == 2);
+        assert(!buffer.acquire());
+        assert(buffer.read_buffer() == 2);
+    }
+
+    {
+        struct Pair
+        {
+            i64 a = 0;
+            i64 b = 0;
+        };
+
+        TripleBuffer<Pair> buffer;
+        const i64 count = 100000;
+
+        thread writer([&buffer]
+        {
+            for (i64 i = 1; i <= count; ++i)
+            {
+                buffer.write_buffer() = {i, -i};
+                buffer.publish();
+            }
+        });
+
+        // Читатель никогда не видит частично записанные данные и не возвращается в прошлое
+        i64 last = 0;
+
+        while (last != count)
+        {
+            if (!buffer.acquire())
+                continue;
+
+            const Pair& pair = buffer.read_buffer();
+            assert(pair.a == -pair.b);
+            assert(pair.a > last);
+            last = pair.a;
+        }
+
+        writer.join();
+    }
+}
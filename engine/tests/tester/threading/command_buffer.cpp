@@ -0,0 +1,59 @@
+// Copyright (c) the Dviglo project
+// License: MIT
+
+#include "../force_assert.hpp"
+
+#include <dviglo/threading/command_buffer.hpp>
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+using namespace dviglo;
+using namespace glm;
+using namespace std;
+
+
+void test_threading_command_buffer()
+{
+    CommandBuffer commands;
+    assert(commands.empty());
+
+    vector<i32> log;
+    vector<i32>* log_ptr = &log;
+
+    // Команды разного размера выполняются в порядке записи
+    for (i32 round = 0; round < 3; ++round)
+    {
+        for (i32 i = 0; i < 100; ++i)
+        {
+            if (i % 2)
+            {
+                commands.push([log_ptr, i] { log_ptr->push_back(i); });
+            }
+            else
+            {
+                vec4 big(1.f, 2.f, 3.f, (f32)i);
+                commands.push([log_ptr, big] { log_ptr->push_back((i32)big.w); });
+            }
+        }
+
+        assert(commands.num_commands() == 100);
+
+        log.clear();
+        commands.execute();
+        assert(commands.empty());
+        assert(log.size() == 100);
+
+        for (i32 i = 0; i < 100; ++i)
+            assert(log[i] == i);
+    }
+
+    // clear() удаляет команды без выполнения
+    bool executed = false;
+    bool* executed_ptr = &executed;
+    commands.push([executed_ptr] { *executed_ptr = true; });
+    commands.clear();
+    commands.execute();
+    assert(!executed);
+}
@@ -0,0 +1,99 @@
+// Copyright (c) the Dviglo project
+// License: MIT
+
+#include "../force_assert.hpp"
+
+#include <dviglo/fs/fs_base.hpp>
+#include <dviglo/fs/log.hpp>
+#include <dviglo/threading/job_system.hpp>
+
+#include <vector>
+
+using namespace dviglo;
+using namespace std;
+
+
+void test_threading_job_system()
+{
+    Log log(get_pref_path("", "dviglo2d") + "tester.log");
+
+    // Без рабочих потоков задачи выполняются в wait()
+    for (i32 num_worker_threads : {0, 3})
+    {
+        JobSystem job_system(num_worker_threads);
+        assert(job_system.num_threads() == num_worker_threads + 1);
+
+        {
+            atomic<i32> sum{0};
+            JobCounter counter;
+
+            for (i32 i = 1; i <= 100; ++i)
+                job_system.run([&sum, i] { sum += i; }, &counter);
+
+            job_system.wait(counter);
+            assert(counter.is_done());
+            assert(sum == 5050);
+        }
+
+        {
+            // Задачи, запущенные из задач
+            atomic<i32> count{0};
+            JobCounter counter;
+
+            for (i32 i = 0; i < 10; ++i)
+            {
+                job_system.run([&]
+                {
+                    for (i32 j = 0; j < 10; ++j)
+                        job_system.run([&count] { ++count; }, &counter);
+                }, &counter);
+            }
+
+            job_system.wait(counter);
+            assert(count == 100);
+        }
+
+        {
+            // Зависимости: b выполняется только после всех задач a
+            atomic<i32> a_count{0};
+            i32 a_count_seen_by_b = -1;
+            JobCounter a_counter;
+            JobCounter b_counter;
+
+            for (i32 i = 0; i < 50; ++i)
+                job_system.run([&a_count] { ++a_count; }, &a_counter);
+
+            job_system.run_after(a_counter, [&] { a_count_seen_by_b = a_count; }, &b_counter);
+            job_system.wait(b_counter);
+            assert(a_count_seen_by_b == 50);
+
+            // Зависимость уже выполнена
+            bool c_done = false;
+            JobCounter c_counter;
+            job_system.run_after(a_counter, [&c_done] { c_done = true; }, &c_counter);
+            job_system.wait(c_counter);
+            assert(c_done);
+        }
+
+        {
+            // Каждый элемент обрабатывается ровно один раз
+            vector<i32> values(10007, 0);
+
+            job_system.parallel_for(0, (i32)values.size(), 100, [&values](i32 begin, i32 end)
+            {
+                for (i32 i = begin; i < end; ++i)
+                    values[i] += i;
+            });
+
+            for (i32 i = 0; i < (i32)values.size(); ++i)
+                assert(values[i] == i);
+
+            // Пустой диапазон
+            bool called = false;
+            job_system.parallel_for(5, 5, 1, [&called](i32, i32) { called = true; });
+            assert(!called);
+        }
+    }
+
+    assert(!DV_JOB_SYSTEM);
+}
@@ -0,0 +1,114 @@
+// Copyright (c) the Dviglo project
+// License: MIT
+
+#include "../force_assert.hpp"
+
+#include <dviglo/fs/fs_base.hpp>
+#include <dviglo/fs/log.hpp>
+#include <dviglo/threading/system_scheduler.hpp>
+
+#include <atomic>
+#include <vector>
+
+using namespace dviglo;
+using namespace std;
+
+
+namespace
+{
+
+// Типы данных, к которым обращаются системы
+struct Positions
+{
+    vector<i32> values;
+};
+
+struct Velocities
+{
+    vector<i32> values;
+};
+
+struct Stats
+{
+    i64 sum = 0;
+};
+
+void run_scheduler_test()
+{
+    Positions positions;
+    Velocities velocities;
+    Stats stats;
+
+    // Объекты, созданные через команды
+    vector<i32> created;
+
+    // Сколько раз эксклюзивная система видела созданные объекты
+    i32 num_created_seen = 0;
+
+    atomic<i32> num_independent_runs{0};
+
+    SystemScheduler scheduler;
+
+    scheduler.add("s_set_velocities", reads<>(), writes<Velocities>(), [&](u64, CommandBuffer&)
+    {
+        velocities.values.assign(1000, 2);
+    });
+
+    // Не конфликтует с другими системами
+    scheduler.add("s_independent", reads<>(), writes<>(), [&](u64, CommandBuffer&)
+    {
+        ++num_independent_runs;
+    });
+
+    scheduler.add("s_move", reads<Velocities>(), writes<Positions>(), [&](u64 ns, CommandBuffer& commands)
+    {
+        // Должна выполниться после s_set_velocities
+        assert(velocities.values.size() == 1000);
+
+        positions.values.resize(1000, 0);
+
+        for (size_t i = 0; i < positions.values.size(); ++i)
+            positions.values[i] += velocities.values[i] * (i32)ns;
+
+        vector<i32>* created_ptr = &created;
+        commands.push([created_ptr] { created_ptr->push_back(1); });
+    });
+
+    scheduler.add("s_sum", reads<Positions>(), writes<Stats>(), [&](u64, CommandBuffer&)
+    {
+        // Должна выполниться после s_move
+        stats.sum = 0;
+
+        for (i32 value : positions.values)
+            stats.sum += value;
+    });
+
+    scheduler.add_exclusive("s_check_created", [&](u64, CommandBuffer&)
+    {
+        // Команды предыдущих систем уже выполнены
+        num_created_seen = (i32)created.size();
+    });
+
+    for (i32 tick = 1; tick <= 10; ++tick)
+    {
+        scheduler.run(1);
+        assert(stats.sum == 1000 * 2 * tick);
+        assert(num_created_seen == tick);
+        assert(num_independent_runs == tick);
+    }
+}
+
+} // namespace
+
+void test_threading_system_scheduler()
+{
+    Log log(get_pref_path("", "dviglo2d") + "tester.log");
+
+    // Без JobSystem системы выполняются последовательно
+    run_scheduler_test();
+
+    {
+        JobSystem job_system(3);
+        run_scheduler_test();
+    }
+}
@@ -0,0 +1,195 @@
+// Copyright (c) the Dviglo project
+// License: MIT
+
+/*
+
+Бенчмарк TileMap: карта 1024x1024 тайлов прокручивается с постоянной скоростью,
+и несколько раз в секунду в видимой области меняются тайлы.
+Vsync выключена, поэтому FPS показывает реальную производительность.
+Раз в секунду в лог пишутся FPS, максимальное время кадра и число перестроенных кусков,
+а при выходе - доля кадров, не уложившихся в бюджет target_fps.
+
+*/
+
+#include "app.hpp"
+
+#include <dviglo/fs/fs_base.hpp>
+#include <dviglo/gl_utils/texture_cache.hpp>
+#include <dviglo/main/engine_params.hpp>
+#include <dviglo/main/os_window.hpp>
+
+#include <random>
+
+using namespace glm;
+
+
+// Размер карты в тайлах
+static const ivec2 map_size{1024, 1024};
+
+// Размер тайла в пикселях. Спрайтшит 128x128, т.е. 16 разных тайлов
+static const ivec2 tile_size{32, 32};
+static constexpr i32 num_tile_kinds = 16;
+
+// Скорость прокрутки в пикселях в секунду
+static constexpr f32 scroll_speed = 600.f;
+
+// Как часто меняются тайлы и сколько тайлов меняется за раз
+static constexpr u64 edit_interval_ns = SDL_NS_PER_SECOND / 10;
+static constexpr i32 tiles_per_edit = 64;
+
+// Частота кадров, которую нужно выдерживать
+static constexpr u64 target_fps = 60;
+static constexpr u64 frame_budget_ns = SDL_NS_PER_SECOND / target_fps;
+
+static mt19937 random_engine(1); // Фиксированный seed, чтобы запуски были сравнимы
+
+App::App(const vector<StrUtf8>& args)
+    : Application(args)
+{
+}
+
+void App::setup()
+{
+    engine_params::log_path = get_pref_path("dviglo2d", "apps") + "tile_map_benchmark.log";
+    engine_params::window_size = ivec2(1280, 720);
+    engine_params::window_mode = WindowMode::resizable;
+    engine_params::vsync = 0;
+
+    // Без фильтрации по краям тайлов не видны соседние тайлы спрайтшита
+    Texture::default_params.min_filter = GL_NEAREST;
+    Texture::default_params.mag_filter = GL_NEAREST;
+}
+
+void App::start()
+{
+    StrUtf8 base_path = get_base_path();
+
+    shared_ptr<Texture> spritesheet = DV_TEXTURE_CACHE->get(base_path + "engine_test_data/textures/tile128.png");
+    tile_map_ = make_unique<TileMap>(map_size, tile_size, spritesheet);
+
+    uniform_int_distribution<i32> tile_dist(0, num_tile_kinds - 1);
+
+    for (i32 y = 0; y < map_size.y; ++y)
+    {
+        for (i32 x = 0; x < map_size.x; ++x)
+            tile_map_->set_tile({x, y}, (TileMap::Tile)tile_dist(random_engine));
+    }
+
+    sprite_batch_ = make_unique<SpriteBatch>();
+    font_ = make_unique<SpriteFont>(SFSettingsSimple(base_path + "engine_test_data/fonts/ubuntu/Ubuntu-R.ttf", 20));
+}
+
+void App::handle_sdl_event(const SDL_Event& event)
+{
+    if (event.type == SDL_EVENT_KEY_DOWN && event.key.repeat == false && event.key.scancode == SDL_SCANCODE_ESCAPE)
+        should_exit_ = true;
+    else
+        Application::handle_sdl_event(event); // Реагируем на закрытие приложения и изменение размера окна
+}
+
+void App::edit_tiles()
+{
+    ivec2 screen_size;
+    SDL_GetWindowSizeInPixels(DV_OS_WINDOW->window(), &screen_size.x, &screen_size.y);
+
+    // Меняем тайлы в видимой области, чтобы перестроенные куски сразу рисовались
+    ivec2 begin = ivec2(camera_pos_) / tile_size;
+    ivec2 visible_tiles = screen_size / tile_size + 1;
+    uniform_int_distribution<i32> x_dist(0, visible_tiles.x - 1);
+    uniform_int_distribution<i32> y_dist(0, visible_tiles.y - 1);
+    uniform_int_distribution<i32> tile_dist(0, num_tile_kinds - 1);
+
+    for (i32 i = 0; i < tiles_per_edit; ++i)
+    {
+        ivec2 pos = begin + ivec2(x_dist(random_engine), y_dist(random_engine));
+        tile_map_->set_tile(pos, (TileMap::Tile)tile_dist(random_engine));
+    }
+}
+
+void App::update(u64 ns)
+{
+    ++frame_counter_;
+    time_counter_ns_ += ns;
+    max_frame_ns_ = std::max(max_frame_ns_, ns);
+
+    ++total_frames_;
+    total_time_ns_ += ns;
+
+    if (ns > frame_budget_ns)
+        ++slow_frames_;
+
+    if (time_counter_ns_ >= SDL_NS_PER_SECOND)
+    {
+        u64 fps = frame_counter_ * SDL_NS_PER_SECOND / time_counter_ns_;
+        f64 max_frame_ms = max_frame_ns_ / 1'000'000.0;
+
+        stats_text_ = format("FPS: {} | max frame: {:.2f} ms | rebuilt chunks: {}",
+                             fps, max_frame_ms, rebuilt_chunks_counter_);
+        DV_LOG->write_info(stats_text_);
+
+        frame_counter_ = 0;
+        time_counter_ns_ = 0;
+        max_frame_ns_ = 0;
+        rebuilt_chunks_counter_ = 0;
+    }
+
+    // Прокручиваем карту по диагонали и отражаемся от краёв
+    ivec2 screen_size;
+    SDL_GetWindowSizeInPixels(DV_OS_WINDOW->window(), &screen_size.x, &screen_size.y);
+    vec2 max_camera_pos = glm::max(vec2(tile_map_->pixel_size() - screen_size), vec2(0.f, 0.f));
+
+    camera_pos_ += camera_dir_ * (scroll_speed * ns / SDL_NS_PER_SECOND);
+
+    for (i32 i = 0; i < 2; ++i)
+    {
+        if (camera_pos_[i] < 0.f)
+        {
+            camera_pos_[i] = 0.f;
+            camera_dir_[i] = 1.f;
+        }
+        else if (camera_pos_[i] > max_camera_pos[i])
+        {
+            camera_pos_[i] = max_camera_pos[i];
+            camera_dir_[i] = -1.f;
+        }
+    }
+
+    if (edit_timer_ns_ <= ns)
+    {
+        edit_tiles();
+        edit_timer_ns_ = edit_interval_ns;
+    }
+    else
+    {
+        edit_timer_ns_ -= ns;
+    }
+}
+
+void App::draw()
+{
+    glClearColor(0.f, 0.f, 0.f, 1.f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    sprite_batch_->prepare_ogl(true, false);
+
+    // Округляем позицию камеры, чтобы тайлы не дрожали
+    tile_map_->draw(glm::floor(camera_pos_));
+    rebuilt_chunks_counter_ += tile_map_->num_rebuilt_chunks();
+
+    StrUtf8 chunks_text = format("Drawn chunks: {}", tile_map_->num_drawn_chunks());
+    sprite_batch_->draw_string(stats_text_, font_.get(), vec2{4.f, 1.f}, 0xFF000000);
+    sprite_batch_->draw_string(stats_text_, font_.get(), vec2{3.f, 0.f}, 0xFFFFFFFF);
+    sprite_batch_->draw_string(chunks_text, font_.get(), vec2{4.f, 25.f}, 0xFF000000);
+    sprite_batch_->draw_string(chunks_text, font_.get(), vec2{3.f, 24.f}, 0xFFFFFFFF);
+    sprite_batch_->flush();
+}
+
+App::~App()
+{
+    if (total_frames_ && total_time_ns_)
+    {
+        DV_LOG->writef_info("Средний FPS: {}, кадров дольше {} мс ({} FPS): {} из {}",
+                            total_frames_ * SDL_NS_PER_SECOND / total_time_ns_, frame_budget_ns / 1'000'000,
+                            target_fps, slow_frames_, total_frames_);
+    }
+}
@@ -0,0 +1,54 @@
+// Copyright (c) the Dviglo project
+// License: MIT
+
+#pragma once
+
+#include <dviglo/graphics/sprite_batch.hpp>
+#include <dviglo/graphics/tile_map.hpp>
+#include <dviglo/main/application.hpp>
+
+using namespace dviglo;
+using namespace std;
+
+
+class App : public Application
+{
+private:
+    unique_ptr<TileMap> tile_map_;
+    unique_ptr<SpriteBatch> sprite_batch_;
+    unique_ptr<SpriteFont> font_;
+
+    // Позиция камеры в пикселях
+    glm::vec2 camera_pos_{0.f, 0.f};
+
+    // Направление прокрутки (меняется при достижении края карты)
+    glm::vec2 camera_dir_{1.f, 1.f};
+
+    // Время до следующего изменения тайлов
+    u64 edit_timer_ns_ = 0;
+
+    StrUtf8 stats_text_ = "FPS: ?";
+
+    // Статистика за текущую секунду
+    u64 frame_counter_ = 0;
+    u64 time_counter_ns_ = 0;
+    u64 max_frame_ns_ = 0;
+    u64 rebuilt_chunks_counter_ = 0;
+
+    // Статистика за всё время
+    u64 total_frames_ = 0;
+    u64 total_time_ns_ = 0;
+    u64 slow_frames_ = 0; // Кадры, не уложившиеся в бюджет target_fps
+
+    void edit_tiles();
+
+public:
+    App(const vector<StrUtf8>& args);
+    ~App() override;
+
+    void setup() override;
+    void start() override;
+    void handle_sdl_event(const SDL_Event& event) override;
+    void update(u64 ns) override;
+    void draw() override;
+};
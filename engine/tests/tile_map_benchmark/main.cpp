@@ -0,0 +1,12 @@
+// Copyright (c) the Dviglo project
+// License: MIT
+
+#include "app.hpp"
+
+#include <dviglo/main/main.hpp>
+
+#define SDL_MAIN_USE_CALLBACKS
+#include <SDL3/SDL_main.h>
+
+
+DV_DEFINE_APP(App);
@@ -0,0 +1,175 @@
+// Замер скорости решателя пятнашек на наборе случайных расстановок
+// и скорости генерации расстановок (расстановок в секунду).
+// Набор одинаковый при одинаковом seed, поэтому результаты можно сравнивать между версиями.
+// Параметры:
+// -count x - число расстановок (по умолчанию 100)
+// -seed x - seed генератора расстановок (по умолчанию 1)
+// -threads x - число рабочих потоков JobSystem (по умолчанию 0 - поиск в главном потоке)
+// -pdb path - файл базы шаблонов (по умолчанию тот же, что у игры)
+// -generator_seconds x - сколько секунд замерять каждый режим генератора (по умолчанию 1, 0 - не замерять)
+
+#include "../src/puzzle_generator.hpp"
+
+#include <dviglo/fs/fs_base.hpp>
+#include <dviglo/fs/log.hpp>
+#include <dviglo/threading/job_system.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <random>
+
+
+struct Options
+{
+    i32 count = 100;
+    u32 seed = 1;
+    i32 threads = 0;
+    StrUtf8 pdb_path = get_pref_path("dviglo2d", "mini_games") + "15_puzzle_pdb.bin";
+    f64 generator_seconds = 1.0;
+};
+
+static Options parse_args(i32 argc, char* argv[])
+{
+    Options ret;
+
+    for (i32 i = 1; i < argc; ++i)
+    {
+        StrUtf8 arg = argv[i];
+        bool has_value = i + 1 < argc;
+
+        if (arg == "-count" && has_value)
+            ret.count = stoi(argv[++i]);
+        else if (arg == "-seed" && has_value)
+            ret.seed = (u32)stoul(argv[++i]);
+        else if (arg == "-threads" && has_value)
+            ret.threads = stoi(argv[++i]);
+        else if (arg == "-pdb" && has_value)
+            ret.pdb_path = argv[++i];
+        else if (arg == "-generator_seconds" && has_value)
+            ret.generator_seconds = stod(argv[++i]);
+    }
+
+    return ret;
+}
+
+// Вызывает generate, пока не пройдёт seconds секунд. Возвращает число расстановок в секунду
+template<typename Func>
+static f64 measure_generator(f64 seconds, Func generate)
+{
+    auto begin = chrono::steady_clock::now();
+    u64 count = 0;
+    chrono::duration<f64> duration{0.0};
+
+    do
+    {
+        generate();
+        ++count;
+        duration = chrono::steady_clock::now() - begin;
+    }
+    while (duration.count() < seconds);
+
+    return count / duration.count();
+}
+
+// Проверяет, что ходы допустимы и собирают головоломку
+static bool check_solution(PuzzleSolver::Board board, const vector<u8>& moves)
+{
+    array<u8, 16> tiles = PuzzleSolver::decode(board);
+    i32 hole = (i32)(find(tiles.begin(), tiles.end(), 0) - tiles.begin());
+
+    for (u8 cell : moves)
+    {
+        if (abs(cell % 4 - hole % 4) + abs(cell / 4 - hole / 4) != 1)
+            return false;
+
+        swap(tiles[cell], tiles[hole]);
+        hole = cell;
+    }
+
+    return PuzzleSolver::encode(tiles) == PuzzleSolver::goal_board;
+}
+
+int main(int argc, char* argv[])
+{
+    setlocale(LC_CTYPE, "en_US.UTF-8");
+
+    Options options = parse_args(argc, argv);
+
+    Log log(get_pref_path("dviglo2d", "mini_games") + "15_puzzle_solver_benchmark.log");
+
+    unique_ptr<JobSystem> job_system;
+    if (options.threads > 0)
+        job_system = make_unique<JobSystem>(options.threads);
+
+    auto begin = chrono::steady_clock::now();
+    PuzzleSolver solver(options.pdb_path);
+    chrono::duration<f64> load_duration = chrono::steady_clock::now() - begin;
+
+    cout << "Загрузка (или построение) базы шаблонов: " << load_duration.count() << " с" << endl;
+    cout << "Расстановок: " << options.count << ", seed " << options.seed
+         << ", рабочих потоков " << options.threads << endl;
+
+    PuzzleGenerator generator(options.seed);
+    vector<PuzzleSolver::Board> boards;
+
+    for (i32 i = 0; i < options.count; ++i)
+        boards.push_back(generator.random_board());
+
+    u64 total_nodes = 0;
+    u64 total_moves = 0;
+    f64 max_seconds = 0.0;
+    bool all_correct = true;
+
+    begin = chrono::steady_clock::now();
+
+    for (size_t i = 0; i < boards.size(); ++i)
+    {
+        auto board_begin = chrono::steady_clock::now();
+        PuzzleSolver::Solution solution = solver.solve(boards[i]);
+        chrono::duration<f64> board_duration = chrono::steady_clock::now() - board_begin;
+
+        bool correct = check_solution(boards[i], solution.moves);
+        all_correct = all_correct && correct;
+
+        total_nodes += solution.num_nodes;
+        total_moves += solution.moves.size();
+        max_seconds = max(max_seconds, board_duration.count());
+
+        cout << i + 1 << ": ходов " << solution.moves.size() << ", оценка " << solver.estimate(boards[i])
+             << ", узлов " << solution.num_nodes << ", " << board_duration.count() * 1000.0 << " мс"
+             << (correct ? "" : " - ОШИБКА") << endl;
+    }
+
+    chrono::duration<f64> duration = chrono::steady_clock::now() - begin;
+
+    cout << "Общее время: " << duration.count() << " с, максимум на расстановку " << max_seconds << " с" << endl;
+    cout << "Средняя длина решения: " << (f64)total_moves / boards.size() << endl;
+    cout << "Узлов: " << total_nodes << ", узлов в секунду: " << (u64)(total_nodes / duration.count()) << endl;
+
+    if (options.generator_seconds > 0.0)
+    {
+        cout << "Генератор (расстановок в секунду):" << endl;
+
+        f64 speed = measure_generator(options.generator_seconds, [&] { generator.random_board(); });
+        cout << "random_board(): " << speed << endl;
+
+        for (i32 target : {20, 40, 55})
+        {
+            speed = measure_generator(options.generator_seconds, [&] { generator.board_with_estimate(solver, target); });
+            cout << "board_with_estimate(" << target << "): " << speed << endl;
+        }
+
+        for (i32 target : {20, 35, 45})
+        {
+            PuzzleSolver::Board board{};
+            speed = measure_generator(options.generator_seconds, [&] { board = generator.board_with_length(solver, target); });
+            bool correct = (i32)solver.solve(board).moves.size() == target;
+            all_correct = all_correct && correct;
+            cout << "board_with_length(" << target << "): " << speed << (correct ? "" : " - ОШИБКА") << endl;
+        }
+    }
+
+    return all_correct ? 0 : 1;
+}
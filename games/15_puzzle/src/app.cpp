@@ -27,6 +27,25 @@ void App::start()
     my_font_ = make_unique<SpriteFont>(SFSettingsSimple(base_path + "engine_test_data/fonts/ubuntu/Ubuntu-R.ttf", 60));
     puzzle_logic_ = make_shared<PuzzleLogic>();
     puzzle_interface_ = make_shared<PuzzleInterface>(puzzle_logic_);
+
+    // Загружаем или строим базу шаблонов в фоне, чтобы не задерживать первый кадр
+    DV_JOB_SYSTEM->run([this]
+    {
+        auto solver = make_unique<PuzzleSolver>(get_pref_path("dviglo2d", "mini_games") + "15_puzzle_pdb.bin",
+                                                &cancel_solver_build_);
+
+        if (solver->is_ready())
+            puzzle_solver_ = std::move(solver);
+    }, &solver_counter_);
+}
+
+App::~App()
+{
+    // Задачи обращаются к членам App, поэтому дожидаемся их завершения.
+    // Построение базы прерывается, а поиск решения занимает не больше нескольких секунд
+    cancel_solver_build_ = true;
+    DV_JOB_SYSTEM->wait(solver_counter_);
+    DV_JOB_SYSTEM->wait(task_counter_);
 }
 
 void App::handle_sdl_event(const SDL_Event& event)
@@ -57,6 +76,106 @@ void App::on_key(const SDL_KeyboardEvent& event_data)
     {
         should_exit_ = true;
     }
+
+    if (event_data.type != SDL_EVENT_KEY_DOWN)
+        return;
+
+    switch (event_data.scancode)
+    {
+    case SDL_SCANCODE_H:
+        request_hint();
+        return;
+
+    // Новая игра заданной сложности (длина кратчайшего решения)
+    case SDL_SCANCODE_1:
+        request_new_game(20);
+        return;
+
+    case SDL_SCANCODE_2:
+        request_new_game(35);
+        return;
+
+    case SDL_SCANCODE_3:
+        request_new_game(50);
+        return;
+
+    default:
+        return;
+    }
+}
+
+void App::request_hint()
+{
+    if (puzzle_logic_->check_win())
+        return;
+
+    pending_task_ = SolverTask::hint;
+    start_pending_task();
+}
+
+void App::request_new_game(i32 length)
+{
+    pending_task_ = SolverTask::new_game;
+    pending_new_game_length_ = length;
+    start_pending_task();
+}
+
+void App::start_pending_task()
+{
+    if (pending_task_ == SolverTask::none || running_task_ != SolverTask::none || !solver_counter_.is_done())
+        return;
+
+    if (!puzzle_solver_) // База не загрузилась и не построилась
+    {
+        pending_task_ = SolverTask::none;
+        return;
+    }
+
+    running_task_ = pending_task_;
+    pending_task_ = SolverTask::none;
+    task_revision_ = puzzle_logic_->get_revision();
+
+    if (running_task_ == SolverTask::hint)
+    {
+        PuzzleSolver::Board board = PuzzleSolver::encode(puzzle_logic_->get_tiles());
+
+        DV_JOB_SYSTEM->run([this, board]
+        {
+            PuzzleSolver::Solution solution = puzzle_solver_->solve(board);
+            hint_cell_ = solution.moves.empty() ? 255 : solution.moves[0];
+        }, &task_counter_);
+    }
+    else
+    {
+        i32 length = pending_new_game_length_;
+
+        DV_JOB_SYSTEM->run([this, length]
+        {
+            new_game_board_ = generator_.board_with_length(*puzzle_solver_, length);
+        }, &task_counter_);
+    }
+}
+
+void App::finish_running_task()
+{
+    if (running_task_ == SolverTask::none || !task_counter_.is_done())
+        return;
+
+    SolverTask task = running_task_;
+    running_task_ = SolverTask::none;
+
+    if (puzzle_logic_->get_revision() != task_revision_)
+        return;
+
+    if (task == SolverTask::hint)
+    {
+        if (hint_cell_ != 255)
+            puzzle_interface_->move_tile({hint_cell_ % 4, hint_cell_ / 4});
+    }
+    else
+    {
+        puzzle_logic_->new_game(new_game_board_);
+    }
 }
 
 static constexpr vec2 new_game_size{238, 59}; // Размер кнопки "Новая игра"
@@ -84,6 +203,9 @@ void App::on_mouse_button(const SDL_MouseButtonEvent& event_data)
 void App::update(u64 ns)
 {
     (void)ns;
+
+    finish_running_task();
+    start_pending_task();
 }
 
 void App::draw()
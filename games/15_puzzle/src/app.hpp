@@ -2,7 +2,11 @@
 
 #include <dviglo/main/application.hpp>
 
+#include "puzzle_generator.hpp"
 #include "puzzle_interface.hpp"
+#include "puzzle_solver.hpp"
+
+#include <dviglo/threading/job_system.hpp>
 
 
 class App : public Application
@@ -13,8 +17,55 @@ class App : public Application
     shared_ptr<PuzzleLogic> puzzle_logic_;
     shared_ptr<PuzzleInterface> puzzle_interface_;
 
+    // Создаётся в фоне при запуске: при первом запуске строится база шаблонов (около 15 секунд).
+    // Пока solver_counter_ не обнулился, из главного потока не используется
+    unique_ptr<PuzzleSolver> puzzle_solver_;
+    JobCounter solver_counter_;
+
+    // Прерывает построение базы при выходе
+    atomic<bool> cancel_solver_build_{false};
+
+    // Задача для решателя. Поиск решения может занять несколько секунд, поэтому выполняется в фоне,
+    // а результат применяется в update()
+    enum class SolverTask
+    {
+        none,
+        hint,     // Один ход оптимального решения
+        new_game, // Расстановка с кратчайшим решением из new_game_length_ ходов
+    };
+
+    // Запрошенная задача, которая ещё не запущена (ждёт базу или завершения предыдущей задачи).
+    // Новый запрос заменяет старый
+    SolverTask pending_task_ = SolverTask::none;
+    i32 pending_new_game_length_ = 0;
+
+    // Выполняемая задача
+    SolverTask running_task_ = SolverTask::none;
+    JobCounter task_counter_;
+
+    // Ревизия поля на момент запуска задачи. Если поле успело измениться (игрок походил
+    // или начал новую игру кнопкой), то результат задачи устарел и отбрасывается
+    u64 task_revision_ = 0;
+
+    // Результаты задачи (пишутся в фоне, читаются после обнуления task_counter_)
+    u8 hint_cell_ = 255;
+    PuzzleSolver::Board new_game_board_ = 0;
+
+    // Используется только в фоновых задачах (и не более чем одной одновременно)
+    PuzzleGenerator generator_;
+
+    // Запускает pending_task_, если решатель свободен
+    void start_pending_task();
+
+    // Применяет результат running_task_, если задача завершена
+    void finish_running_task();
+
+    void request_hint();
+    void request_new_game(i32 length);
+
 public:
     App(const vector<StrUtf8>& args);
+    ~App() override;
 
     void setup() override;
     void start() override;
@@ -0,0 +1,132 @@
+#include "puzzle_generator.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+
+// Наибольшая оценка, которую имеет смысл запрашивать. У самых сложных расстановок решение
+// состоит из 80 ходов, но расстановки с оценкой больше 60 встречаются очень редко
+static constexpr i32 max_estimate = 60;
+
+// Клетка с дыркой
+static i32 find_hole(PuzzleSolver::Board board)
+{
+    for (i32 cell = 0; cell < 16; ++cell)
+    {
+        if (((board >> (cell * 4)) & 15) == 0)
+            return cell;
+    }
+
+    assert(false);
+    return 0;
+}
+
+// Сдвигает костяшку из клетки cell в дырку
+static PuzzleSolver::Board move_tile(PuzzleSolver::Board board, i32 hole, i32 cell)
+{
+    PuzzleSolver::Board tile = (board >> (cell * 4)) & 15;
+    return board ^ (tile << (cell * 4)) ^ (tile << (hole * 4));
+}
+
+PuzzleGenerator::PuzzleGenerator(u32 seed)
+    : random_(seed ? seed : random_device()())
+{
+}
+
+PuzzleSolver::Board PuzzleGenerator::random_board()
+{
+    array<u8, 16> tiles;
+
+    for (u8 i = 0; i < 16; ++i)
+        tiles[i] = i;
+
+    shuffle(tiles.begin(), tiles.end(), random_);
+    PuzzleSolver::Board ret = PuzzleSolver::encode(tiles);
+
+    if (PuzzleSolver::is_solvable(ret))
+        return ret;
+
+    // Меняем местами две первые костяшки (не дырку)
+    i32 first = tiles[0] == 0 ? 1 : 0;
+    i32 second = tiles[first + 1] == 0 ? first + 2 : first + 1;
+    swap(tiles[first], tiles[second]);
+
+    return PuzzleSolver::encode(tiles);
+}
+
+PuzzleSolver::Board PuzzleGenerator::board_with_estimate(const PuzzleSolver& solver, i32 target)
+{
+    target = clamp(target, 0, max_estimate);
+
+    // Случайное блуждание дырки от случайной расстановки. Ход меняет оценку не больше чем на 1,
+    // поэтому блуждание не перепрыгнет target. Ходы в сторону target принимаются всегда,
+    // остальные - с вероятностью 1/4, чтобы расстановки перемешивались
+    PuzzleSolver::Board board = random_board();
+    i32 hole = find_hole(board);
+    i32 prev_hole = -1;
+    i32 estimate = solver.estimate(board);
+    uniform_int_distribution<i32> random_dir(0, 3);
+    uniform_int_distribution<i32> random_accept(0, 3);
+
+    while (estimate != target)
+    {
+        i32 dir = random_dir(random_);
+        i32 x = hole % 4 + (dir == 0) - (dir == 1);
+        i32 y = hole / 4 + (dir == 2) - (dir == 3);
+
+        if (x < 0 || x > 3 || y < 0 || y > 3)
+            continue;
+
+        i32 cell = y * 4 + x;
+
+        if (cell == prev_hole)
+            continue;
+
+        PuzzleSolver::Board new_board = move_tile(board, hole, cell);
+        i32 new_estimate = solver.estimate(new_board);
+
+        bool toward_target = abs(new_estimate - target) < abs(estimate - target);
+
+        if (!toward_target && random_accept(random_) != 0)
+            continue;
+
+        board = new_board;
+        estimate = new_estimate;
+        prev_hole = hole;
+        hole = cell;
+    }
+
+    return board;
+}
+
+PuzzleSolver::Board PuzzleGenerator::board_with_length(const PuzzleSolver& solver, i32 target)
+{
+    target = clamp(target, 0, max_estimate);
+
+    while (true)
+    {
+        // Решение не короче оценки. Запрашиваем оценку чуть меньше target с учётом того,
+        // насколько решения обычно длиннее оценок, чтобы решение редко оказывалось короче target
+        i32 gap = max(0, (i32)lround(average_gap_) - 2);
+        PuzzleSolver::Board board = board_with_estimate(solver, target - gap);
+
+        vector<u8> moves = solver.solve(board).moves;
+        i32 length = (i32)moves.size();
+        average_gap_ = average_gap_ * 0.75 + (length - solver.estimate(board)) * 0.25;
+
+        if (length < target)
+            continue;
+
+        // Каждый ход кратчайшего решения сокращает его ровно на 1
+        i32 hole = find_hole(board);
+
+        for (i32 i = 0; i < length - target; ++i)
+        {
+            board = move_tile(board, hole, moves[i]);
+            hole = moves[i];
+        }
+
+        return board;
+    }
+}
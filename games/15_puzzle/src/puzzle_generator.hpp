@@ -0,0 +1,35 @@
+#pragma once
+
+#include "puzzle_solver.hpp"
+
+#include <random>
+
+
+// Генерирует расстановки пятнашек: равномерно случайные или заданной сложности
+class PuzzleGenerator
+{
+private:
+    mt19937 random_;
+
+    // Средняя разница между длиной решения и оценкой решателя (для board_with_length())
+    f64 average_gap_ = 0.0;
+
+public:
+    // seed == 0 - случайный seed
+    explicit PuzzleGenerator(u32 seed = 0);
+
+    // Равномерно случайная решаемая расстановка за O(16): случайная перестановка, а если она
+    // нерешаемая - обмен двух костяшек (это взаимно однозначно переводит нерешаемые расстановки в решаемые)
+    PuzzleSolver::Board random_board();
+
+    // Расстановка, у которой оценка решателя (нижняя граница длины решения) равна target.
+    // Быстро, так как поиск не выполняется. Годится, когда точная длина решения не важна.
+    // Слишком большие target ограничиваются
+    PuzzleSolver::Board board_with_estimate(const PuzzleSolver& solver, i32 target);
+
+    // Расстановка, кратчайшее решение которой состоит ровно из target ходов.
+    // Кандидат подбирается по оценке и решается, а затем по решению делается столько ходов,
+    // чтобы до сборки осталось ровно target. Из-за поиска длинные решения генерируются медленнее
+    // (для target = 45 - порядка 50 мс). target ограничивается диапазоном [0, 60]
+    PuzzleSolver::Board board_with_length(const PuzzleSolver& solver, i32 target);
+};
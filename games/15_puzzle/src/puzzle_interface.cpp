@@ -35,8 +35,15 @@ static Rect calc_tile_uv(u8 value)
     return {{u, v}, {tile_size, tile_size}}; // Правая и нижняя граница включаются в Rect
 }
 
+// Верхний левый угол костяшки
+static vec2 calc_tile_pos(ivec2 index)
+{
+    return puzzle_pos + vec2(border_size, border_size) + vec2(index) * (tile_size + tile_gap);
+}
+
 PuzzleInterface::PuzzleInterface(weak_ptr<PuzzleLogic> logic)
     : logic_(logic)
+    , board_layer_(IntRect(ivec2(puzzle_pos), ivec2((i32)box_size, (i32)box_size)))
 {
     StrUtf8 base_path = get_base_path();
     spritesheet_ = DV_TEXTURE_CACHE->get(base_path + "15_puzzle_data/textures/spritesheet.png");
@@ -60,15 +67,22 @@ void PuzzleInterface::on_click(vec2 mouse_pos)
     // Пусть щелчок по горизонтальному зазору относится к верхней клетке
     i32 index_y = (i32)floor(local_pos.y / (tile_size + tile_gap));
 
-    shared_ptr<PuzzleLogic> logic = logic_.lock();
-    if (logic->move({index_x, index_y}))
-        Mix_PlayChannel(-1, tile_move_sound_, 0);
+    move_tile({index_x, index_y});
 }
 
-void PuzzleInterface::draw(SpriteBatch* sprite_batch)
+bool PuzzleInterface::move_tile(ivec2 pos)
 {
     shared_ptr<PuzzleLogic> logic = logic_.lock();
 
+    if (!logic->move(pos))
+        return false;
+
+    Mix_PlayChannel(-1, tile_move_sound_, 0);
+    return true;
+}
+
+void PuzzleInterface::draw_board(SpriteBatch* sprite_batch, const PuzzleLogic& logic)
+{
     // Рисуем коробку
     Rect box_uv{{0.f, 0.f}, {box_size, box_size}};
     sprite_batch->draw_sprite(spritesheet_.get(), puzzle_pos, &box_uv);
@@ -78,10 +92,36 @@ void PuzzleInterface::draw(SpriteBatch* sprite_batch)
     {
         for (i32 index_x = 0; index_x < 4; ++index_x)
         {
-            f32 tile_pos_x = puzzle_pos.x + border_size + tile_size * index_x + tile_gap * index_x;
-            f32 tile_pos_y = puzzle_pos.y + border_size + tile_size * index_y + tile_gap * index_y;
-            Rect tile_uv = calc_tile_uv(logic->get_tile({index_x, index_y}));
-            sprite_batch->draw_sprite(spritesheet_.get(), {tile_pos_x, tile_pos_y}, &tile_uv);
+            Rect tile_uv = calc_tile_uv(logic.get_tile({index_x, index_y}));
+            sprite_batch->draw_sprite(spritesheet_.get(), calc_tile_pos({index_x, index_y}), &tile_uv);
         }
     }
 }
+
+void PuzzleInterface::draw(SpriteBatch* sprite_batch)
+{
+    shared_ptr<PuzzleLogic> logic = logic_.lock();
+
+    if (spritesheet_->revision() != drawn_spritesheet_revision_)
+    {
+        board_layer_.set_dirty();
+        drawn_spritesheet_revision_ = spritesheet_->revision();
+    }
+
+    // Перерисовываем только клетки, которые изменились
+    if (logic->get_revision() != drawn_revision_)
+    {
+        const array<u8, 16>& tiles = logic->get_tiles();
+
+        for (i32 i = 0; i < 16; ++i)
+        {
+            if (tiles[i] != drawn_tiles_[i])
+                board_layer_.set_dirty(IntRect(ivec2(calc_tile_pos({i % 4, i / 4})), ivec2((i32)tile_size, (i32)tile_size)));
+        }
+
+        drawn_tiles_ = tiles;
+        drawn_revision_ = logic->get_revision();
+    }
+
+    board_layer_.draw(sprite_batch, [this, &logic](SpriteBatch* batch) { draw_board(batch, *logic); });
+}
@@ -3,6 +3,7 @@
 #include "puzzle_logic.hpp"
 
 #include <dviglo/gl_utils/texture.hpp>
+#include <dviglo/graphics/cached_layer.hpp>
 #include <dviglo/graphics/sprite_batch.hpp>
 
 #include <SDL3_mixer/SDL_mixer.h>
@@ -16,10 +17,24 @@ private:
     weak_ptr<PuzzleLogic> logic_;
     Mix_Chunk* tile_move_sound_ = nullptr;
 
+    // Коробка с костяшками меняется редко, поэтому рендерится в текстуру
+    CachedLayer board_layer_;
+
+    // Что было нарисовано в board_layer_
+    u64 drawn_revision_ = 0;
+    array<u8, 16> drawn_tiles_{};
+    u32 drawn_spritesheet_revision_ = 0; // Текстура меняется при горячей перезагрузке
+
+    // Рисует коробку и костяшки
+    void draw_board(SpriteBatch* sprite_batch, const PuzzleLogic& logic);
+
 public:
     PuzzleInterface(weak_ptr<PuzzleLogic> logic);
     ~PuzzleInterface();
 
     void on_click(vec2 mouse_pos);
+
+    // Двигает костяшку в дырку со звуком. Возвращает false, если костяшку сдвинуть нельзя
+    bool move_tile(ivec2 pos);
     void draw(SpriteBatch* sprite_batch);
 };
@@ -1,13 +1,12 @@
 #include "puzzle_logic.hpp"
 
+#include "puzzle_generator.hpp"
+
 #include <cassert>
-#include <random>
 
 
-// Генератор случайных чисел от 0 до 3 (включительно)
-static random_device rand_device;
-static default_random_engine rand_generator(rand_device());
-static uniform_int_distribution<> distrib(0, 3);
+// Генератор расстановок со случайным seed
+static PuzzleGenerator generator;
 
 // Проверяет, что координаты находятся в допустимых пределах
 static constexpr bool check_tile_pos(ivec2 pos)
@@ -20,68 +19,21 @@ PuzzleLogic::PuzzleLogic()
     new_game();
 }
 
-// Если просто расставить костяшки случайным образом, то может сгенерироваться
-// нерешаемая последовательность. Есть методы оценки решаемости, но это сделает код менее читаемым.
-// Поэтому просто двигаем дырку много раз
+// Если просто расставить костяшки случайным образом, то в половине случаев головоломку нельзя собрать.
+// Генератор исправляет такие расстановки, меняя местами две костяшки
 void PuzzleLogic::new_game()
 {
-    for (u8 i = 0; i <= 14; ++i)
-        tiles_[i] = i + 1; // Нумерация костяшек начинается с 1
-
-    tiles_[15] = 0; // Последняя клетка - пустая
-
-    vec2 hole_pos{3, 3}; // Позиция дырки
+    tiles_ = PuzzleSolver::decode(generator.random_board());
+    ++revision_;
+}
 
-    // Двигаем дырку много раз.
-    // Если двигать дырку мало раз, то верх поля может быть плохо перемешан
-    for (i32 i = 0; i < 1000; ++i)
-    {
-        i32 dir = distrib(rand_generator);
-
-        if (dir == 0) // Двигаем дырку вверх
-        {
-            if (hole_pos.y == 0) // Вверху - край коробки
-                continue;
-
-            // Меняем местами костяшку и дырку
-            vec2 other_pos{hole_pos.x, hole_pos.y - 1};
-            swap_tiles(hole_pos, other_pos);
-            hole_pos = other_pos;
-        }
-        else if (dir == 1) // Двигаем дырку вниз
-        {
-            if (hole_pos.y == 3) // Внизу - край коробки
-                continue;
-
-            // Меняем местами костяшку и дырку
-            vec2 other_pos{hole_pos.x, hole_pos.y + 1};
-            swap_tiles(hole_pos, other_pos);
-            hole_pos = other_pos;
-        }
-        else if (dir == 2) // Двигаем дырку влево
-        {
-            if (hole_pos.x == 0) // Слева - край коробки
-                continue;
-
-            // Меняем местами костяшку и дырку
-            vec2 other_pos{hole_pos.x - 1 , hole_pos.y};
-            swap_tiles(hole_pos, other_pos);
-            hole_pos = other_pos;
-        }
-        else // Двигаем дырку вправо
-        {
-            if (hole_pos.x == 3) // Справа - край коробки
-                continue;
-
-            // Меняем местами костяшку и дырку
-            vec2 other_pos{hole_pos.x + 1 , hole_pos.y};
-            swap_tiles(hole_pos, other_pos);
-            hole_pos = other_pos;
-        }
-    }
+void PuzzleLogic::new_game(PuzzleSolver::Board board)
+{
+    tiles_ = PuzzleSolver::decode(board);
+    ++revision_;
 }
 
-void PuzzleLogic::swap_tiles(ivec2 pos1, vec2 pos2)
+void PuzzleLogic::swap_tiles(ivec2 pos1, ivec2 pos2)
 {
     assert(check_tile_pos(pos1) && check_tile_pos(pos2));
     u8 temp = get_tile(pos1);
@@ -94,6 +46,7 @@ void PuzzleLogic::set_tile(ivec2 pos, u8 value)
     assert(check_tile_pos(pos) && value <= 15);
 
     tiles_[pos.y * 4 + pos.x] = value;
+    ++revision_;
 }
 
 u8 PuzzleLogic::get_tile(ivec2 pos) const
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "puzzle_solver.hpp"
+
 #include <dviglo/common/primitive_types.hpp>
 
 #include <glm/glm.hpp>
@@ -18,11 +20,14 @@ private:
     // Массив костяшек. 0 - дырка
     array<u8, 16> tiles_;
 
+    // Увеличивается при каждом изменении tiles_
+    u64 revision_ = 0;
+
     // Устанавливает число на костяшке
     void set_tile(ivec2 pos, u8 value);
 
     // Меняет местами два тайла
-    void swap_tiles(ivec2 pos1, vec2 pos2);
+    void swap_tiles(ivec2 pos1, ivec2 pos2);
 
 public:
     PuzzleLogic();
@@ -30,9 +35,18 @@ public:
     // Возвращает номер на костяшке. 0 - пустое поле
     u8 get_tile(ivec2 pos) const;
 
-    // Заполняет и перемешивает игровое поле случайным образом
+    // Все костяшки по строкам (индекс - pos.y * 4 + pos.x)
+    const array<u8, 16>& get_tiles() const { return tiles_; }
+
+    // Позволяет дёшево узнать, изменилось ли поле (например, чтобы не перерисовывать его)
+    u64 get_revision() const { return revision_; }
+
+    // Заполняет поле случайной решаемой расстановкой (все расстановки равновероятны)
     void new_game();
 
+    // Заполняет поле заданной расстановкой (например, от PuzzleGenerator::board_with_length())
+    void new_game(PuzzleSolver::Board board);
+
     // Перемещает указанную костяшку в пустое поле.
     // Возвращает false, если рядом с костяшкой нет пустого поля
     // или если позиция выходит за пределы поля
@@ -0,0 +1,589 @@
+#include "puzzle_solver.hpp"
+
+#include <dviglo/fs/file_base.hpp>
+#include <dviglo/fs/log.hpp>
+#include <dviglo/threading/job_system.hpp>
+
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <chrono>
+#include <climits>
+#include <mutex>
+
+
+// ============================ Поле и ходы ============================
+
+// Соседние клетки (до 4 штук). 255 - нет соседа
+static constexpr array<array<u8, 4>, 16> neighbors = []
+{
+    array<array<u8, 4>, 16> ret{};
+
+    for (i32 cell = 0; cell < 16; ++cell)
+    {
+        i32 x = cell % 4;
+        i32 y = cell / 4;
+        i32 count = 0;
+        ret[cell] = {255, 255, 255, 255};
+
+        if (y > 0) ret[cell][count++] = (u8)(cell - 4);
+        if (x > 0) ret[cell][count++] = (u8)(cell - 1);
+        if (x < 3) ret[cell][count++] = (u8)(cell + 1);
+        if (y < 3) ret[cell][count++] = (u8)(cell + 4);
+    }
+
+    return ret;
+}();
+
+static u8 get_tile(PuzzleSolver::Board board, i32 cell)
+{
+    return (u8)((board >> (cell * 4)) & 15);
+}
+
+PuzzleSolver::Board PuzzleSolver::encode(const array<u8, 16>& tiles)
+{
+    Board ret = 0;
+
+    for (i32 cell = 0; cell < 16; ++cell)
+    {
+        assert(tiles[cell] <= 15);
+        ret |= (Board)tiles[cell] << (cell * 4);
+    }
+
+    return ret;
+}
+
+array<u8, 16> PuzzleSolver::decode(Board board)
+{
+    array<u8, 16> ret;
+
+    for (i32 cell = 0; cell < 16; ++cell)
+        ret[cell] = get_tile(board, cell);
+
+    return ret;
+}
+
+// Горизонтальный ход не меняет ни число инверсий, ни строку дырки.
+// Вертикальный ход меняет число инверсий на нечётное число (1 или 3) и строку дырки на 1.
+// Поэтому чётность суммы сохраняется, а у собранной головоломки она нечётная (0 + 3)
+bool PuzzleSolver::is_solvable(Board board)
+{
+    array<u8, 16> tiles = decode(board);
+    i32 inversions = 0;
+    i32 hole_row = 0;
+
+    for (i32 i = 0; i < 16; ++i)
+    {
+        if (tiles[i] == 0)
+        {
+            hole_row = i / 4;
+            continue;
+        }
+
+        for (i32 j = i + 1; j < 16; ++j)
+        {
+            if (tiles[j] != 0 && tiles[j] < tiles[i])
+                ++inversions;
+        }
+    }
+
+    return (inversions + hole_row) % 2 == 1;
+}
+
+// ============================ База шаблонов ============================
+
+// Разбиение 6-6-3 (Korf, Felner. Disjoint pattern database heuristics)
+static constexpr u8 pattern_1[] = {1, 5, 6, 9, 10, 13};
+static constexpr u8 pattern_2[] = {7, 8, 11, 12, 14, 15};
+static constexpr u8 pattern_3[] = {2, 3, 4};
+
+struct Pattern
+{
+    const u8* tiles;
+    i32 size;
+};
+
+static constexpr Pattern patterns[3] =
+{
+    {pattern_1, (i32)size(pattern_1)},
+    {pattern_2, (i32)size(pattern_2)},
+    {pattern_3, (i32)size(pattern_3)},
+};
+
+// Группа, к которой относится костяшка
+static constexpr array<u8, 16> tile_pattern = []
+{
+    array<u8, 16> ret{};
+
+    for (u8 pattern_index = 0; pattern_index < 3; ++pattern_index)
+    {
+        for (i32 i = 0; i < patterns[pattern_index].size; ++i)
+            ret[patterns[pattern_index].tiles[i]] = pattern_index;
+    }
+
+    return ret;
+}();
+
+// Число расстановок k костяшек по 16 клеткам
+static constexpr u32 num_arrangements(i32 k)
+{
+    u32 ret = 1;
+
+    for (i32 i = 0; i < k; ++i)
+        ret *= 16 - i;
+
+    return ret;
+}
+
+// Номер расстановки (позиций костяшек группы) в диапазоне [0, num_arrangements(size)).
+// Позиция каждой следующей костяшки считается только среди свободных клеток
+static u32 rank_arrangement(const u8* positions, i32 size)
+{
+    u32 ret = 0;
+    u32 used = 0;
+
+    for (i32 i = 0; i < size; ++i)
+    {
+        u32 pos = positions[i];
+        u32 free_before = pos - (u32)popcount(used & ((1u << pos) - 1));
+        ret = ret * (16 - i) + free_before;
+        used |= 1u << pos;
+    }
+
+    return ret;
+}
+
+// Обратная к rank_arrangement() функция
+static void unrank_arrangement(u32 rank, i32 size, u8* out_positions)
+{
+    u32 free_before[6];
+
+    for (i32 i = size - 1; i >= 0; --i)
+    {
+        free_before[i] = rank % (16 - i);
+        rank /= 16 - i;
+    }
+
+    u32 free = 0xFFFF;
+
+    for (i32 i = 0; i < size; ++i)
+    {
+        // Пропускаем free_before[i] младших свободных клеток
+        u32 mask = free;
+
+        for (u32 j = 0; j < free_before[i]; ++j)
+            mask &= mask - 1;
+
+        u8 pos = (u8)countr_zero(mask);
+        out_positions[i] = pos;
+        free &= ~(1u << pos);
+    }
+}
+
+// Обход в ширину от собранной головоломки. Ходы костяшками группы стоят 1, остальными костяшками - 0.
+// Во время обхода расстановка хранится не номером, а позициями костяшек по 4 бита (так быстрее, хотя номеров
+// в 16^size / num_arrangements(size) раз больше). Состояние - расстановка * 16 + позиция дырки
+// Если cancel != nullptr и флаг поднят, то возвращает пустую базу
+static vector<u8> build_database(const Pattern& pattern, const atomic<bool>* cancel)
+{
+    const u32 num_packed = u32(1) << (pattern.size * 4);
+    vector<u8> distances(num_packed, 255);
+    vector<u64> visited((size_t)num_packed * 16 / 64, 0);
+
+    auto visit = [&visited](u32 state)
+    {
+        u64& word = visited[state / 64];
+        u64 bit = u64(1) << (state % 64);
+
+        if (word & bit)
+            return false;
+
+        word |= bit;
+        return true;
+    };
+
+    u32 goal_packed = 0;
+
+    for (i32 i = 0; i < pattern.size; ++i)
+        goal_packed |= u32(pattern.tiles[i] - 1) << (i * 4); // Костяшка t стоит в клетке t - 1
+
+    vector<u32> layer{goal_packed * 16 + 15};
+    visit(layer[0]);
+    vector<u32> next_layer;
+
+    for (u8 distance = 0; !layer.empty(); ++distance)
+    {
+        if (cancel && cancel->load(memory_order_relaxed))
+            return {};
+
+        // Бесплатные ходы не меняют расстановку группы, двигают только дырку.
+        // Слой растёт во время обхода
+        for (size_t i = 0; i < layer.size(); ++i)
+        {
+            u32 packed = layer[i] / 16;
+            u32 hole = layer[i] % 16;
+            distances[packed] = min(distances[packed], distance);
+
+            u32 occupied = 0;
+
+            for (i32 j = 0; j < pattern.size; ++j)
+                occupied |= 1u << ((packed >> (j * 4)) & 15);
+
+            for (u8 neighbor : neighbors[hole])
+            {
+                if (neighbor != 255 && !(occupied & (1u << neighbor)) && visit(packed * 16 + neighbor))
+                    layer.push_back(packed * 16 + neighbor);
+            }
+        }
+
+        // Все состояния на расстоянии distance уже посещены, поэтому новые состояния
+        // на следующем слое находятся точно на расстоянии distance + 1
+        next_layer.clear();
+
+        for (u32 state : layer)
+        {
+            u32 packed = state / 16;
+            u32 hole = state % 16;
+
+            for (i32 j = 0; j < pattern.size; ++j)
+            {
+                u32 pos = (packed >> (j * 4)) & 15;
+                bool is_neighbor = false;
+
+                for (u8 neighbor : neighbors[hole])
+                    is_neighbor |= neighbor == pos;
+
+                if (!is_neighbor)
+                    continue;
+
+                // Костяшка переезжает в дырку, дырка - на место костяшки
+                u32 new_state = (packed ^ ((pos ^ hole) << (j * 4))) * 16 + pos;
+
+                if (visit(new_state))
+                    next_layer.push_back(new_state);
+            }
+        }
+
+        layer.swap(next_layer);
+    }
+
+    // Переходим к плотной нумерации
+    vector<u8> ret(num_arrangements(pattern.size));
+    u8 positions[6];
+
+    for (u32 rank = 0; rank < ret.size(); ++rank)
+    {
+        unrank_arrangement(rank, pattern.size, positions);
+        u32 packed = 0;
+
+        for (i32 i = 0; i < pattern.size; ++i)
+            packed |= u32(positions[i]) << (i * 4);
+
+        ret[rank] = distances[packed];
+    }
+
+    return ret;
+}
+
+// Заголовок файла с базой
+static constexpr u32 cache_magic = 0x42445046; // "FPDB"
+static constexpr u32 cache_version = 1;
+
+bool PuzzleSolver::load(const StrUtf8& path)
+{
+    FILE* file = file_open(path, "rb");
+
+    if (!file)
+        return false;
+
+    u32 header[2]{};
+    bool ok = file_read(header, sizeof(u32), 2, file) == 2 && header[0] == cache_magic && header[1] == cache_version;
+
+    for (i32 i = 0; ok && i < 3; ++i)
+    {
+        databases_[i].resize(num_arrangements(patterns[i].size));
+        ok = file_read(databases_[i].data(), 1, (i32)databases_[i].size(), file) == (i32)databases_[i].size();
+    }
+
+    file_close(file);
+
+    if (!ok)
+    {
+        for (vector<u8>& database : databases_)
+            database.clear();
+    }
+
+    return ok;
+}
+
+void PuzzleSolver::save(const StrUtf8& path) const
+{
+    FILE* file = file_open(path, "wb");
+
+    if (!file)
+    {
+        DV_LOG->writef_error("PuzzleSolver::save(): cannot create {}", path);
+        return;
+    }
+
+    u32 header[2]{cache_magic, cache_version};
+    bool ok = file_write(header, sizeof(u32), 2, file) == 2;
+
+    for (const vector<u8>& database : databases_)
+        ok = ok && file_write(database.data(), 1, (i32)database.size(), file) == (i32)database.size();
+
+    file_close(file);
+
+    if (!ok)
+        DV_LOG->writef_error("PuzzleSolver::save(): cannot write {}", path);
+}
+
+PuzzleSolver::PuzzleSolver(const StrUtf8& cache_path, const atomic<bool>* cancel)
+{
+    if (!cache_path.empty() && load(cache_path))
+        return;
+
+    auto begin_time = chrono::steady_clock::now();
+
+    auto build = [this, cancel](i32 begin, i32 end)
+    {
+        for (i32 i = begin; i < end; ++i)
+            databases_[i] = build_database(patterns[i], cancel);
+    };
+
+    if (DV_JOB_SYSTEM)
+        DV_JOB_SYSTEM->parallel_for(0, 3, 1, build);
+    else
+        build(0, 3);
+
+    if (cancel && cancel->load())
+    {
+        for (vector<u8>& database : databases_)
+            database.clear();
+
+        return;
+    }
+
+    chrono::duration<f64> duration = chrono::steady_clock::now() - begin_time;
+    DV_LOG->writef_info("PuzzleSolver: pattern database built in {:.1f} s", duration.count());
+
+    if (!cache_path.empty())
+        save(cache_path);
+}
+
+// ================================ IDA* ================================
+
+// Глубина, на которой дерево поиска делится на независимые поддеревья для потоков
+static constexpr i32 split_depth = 8;
+
+// Состояние поиска в глубину. У каждого потока своё
+class Searcher
+{
+private:
+    const array<vector<u8>, 3>& databases_;
+    const atomic<bool>& stop_;
+
+    PuzzleSolver::Board board_;
+    u8 hole_;
+
+    // Клетка каждой костяшки
+    array<u8, 16> positions_;
+
+    // Оценки для каждой группы
+    array<i32, 3> estimates_;
+
+    i32 estimate_pattern(i32 pattern_index) const
+    {
+        const Pattern& pattern = patterns[pattern_index];
+        u8 positions[6];
+
+        for (i32 i = 0; i < pattern.size; ++i)
+            positions[i] = positions_[pattern.tiles[i]];
+
+        return databases_[pattern_index][rank_arrangement(positions, pattern.size)];
+    }
+
+public:
+    // Ходы от корня дерева поиска
+    vector<u8> path;
+
+    u64 num_nodes = 0;
+
+    // Минимальная оценка среди отсечённых узлов - порог для следующей итерации
+    i32 next_threshold = INT_MAX;
+
+    Searcher(const array<vector<u8>, 3>& databases, const atomic<bool>& stop, PuzzleSolver::Board board)
+        : databases_(databases)
+        , stop_(stop)
+    {
+        set_board(board);
+    }
+
+    void set_board(PuzzleSolver::Board board)
+    {
+        board_ = board;
+
+        for (u8 cell = 0; cell < 16; ++cell)
+        {
+            u8 tile = get_tile(board, cell);
+            positions_[tile] = cell;
+
+            if (tile == 0)
+                hole_ = cell;
+        }
+
+        for (i32 i = 0; i < 3; ++i)
+            estimates_[i] = estimate_pattern(i);
+    }
+
+    PuzzleSolver::Board board() const { return board_; }
+    u8 hole() const { return hole_; }
+    i32 estimate() const { return estimates_[0] + estimates_[1] + estimates_[2]; }
+
+    // Сдвигает костяшку из клетки cell в дырку
+    void move(u8 cell)
+    {
+        PuzzleSolver::Board tile = get_tile(board_, cell);
+        board_ ^= (tile << (cell * 4)) | (tile << (hole_ * 4));
+        positions_[tile] = hole_;
+        hole_ = cell;
+
+        i32 pattern_index = tile_pattern[tile];
+        estimates_[pattern_index] = estimate_pattern(pattern_index);
+    }
+
+    // Поиск в глубину с отсечением узлов, у которых depth + оценка > threshold.
+    // prev_hole - откуда пришла дырка (ход обратно бессмысленен).
+    // Если split_nodes != nullptr, то узлы на глубине split_depth не обходятся, а добавляются туда
+    bool search(i32 depth, i32 threshold, u8 prev_hole, vector<pair<vector<u8>, u8>>* split_nodes = nullptr)
+    {
+        ++num_nodes;
+
+        i32 f = depth + estimate();
+
+        if (f > threshold)
+        {
+            next_threshold = min(next_threshold, f);
+            return false;
+        }
+
+        // Все группы на своих местах, значит и вся головоломка собрана
+        if (estimate() == 0)
+            return true;
+
+        if (split_nodes && depth == split_depth)
+        {
+            split_nodes->emplace_back(path, prev_hole);
+            return false;
+        }
+
+        if (stop_.load(memory_order_relaxed))
+            return false;
+
+        for (u8 neighbor : neighbors[hole_])
+        {
+            if (neighbor == 255)
+                break;
+
+            if (neighbor == prev_hole)
+                continue;
+
+            u8 hole = hole_;
+            move(neighbor);
+            path.push_back(neighbor);
+
+            if (search(depth + 1, threshold, hole, split_nodes))
+                return true;
+
+            path.pop_back();
+            move(hole);
+        }
+
+        return false;
+    }
+};
+
+i32 PuzzleSolver::estimate(Board board) const
+{
+    atomic<bool> stop{false};
+    return Searcher(databases_, stop, board).estimate();
+}
+
+PuzzleSolver::Solution PuzzleSolver::solve(Board board) const
+{
+    Solution ret;
+
+    if (!is_solvable(board))
+        return ret;
+
+    atomic<bool> stop{false};
+    Searcher root(databases_, stop, board);
+    i32 threshold = root.estimate();
+
+    while (true)
+    {
+        // Обходим верхушку дерева и запоминаем узлы на глубине split_depth
+        vector<pair<vector<u8>, u8>> split_nodes;
+        root.next_threshold = INT_MAX;
+
+        if (root.search(0, threshold, 255, &split_nodes))
+        {
+            ret.moves = root.path;
+            ret.num_nodes += root.num_nodes;
+            return ret;
+        }
+
+        ret.num_nodes += root.num_nodes;
+        root.num_nodes = 0;
+
+        mutex result_mutex;
+        i32 next_threshold = root.next_threshold;
+        bool found = false;
+
+        auto search_subtrees = [&](i32 begin, i32 end)
+        {
+            Searcher searcher(databases_, stop, board);
+
+            for (i32 i = begin; i < end && !stop.load(memory_order_relaxed); ++i)
+            {
+                // Переходим в узел split_nodes[i]
+                searcher.set_board(board);
+
+                for (u8 cell : split_nodes[i].first)
+                    searcher.move(cell);
+
+                searcher.path = split_nodes[i].first;
+
+                if (searcher.search(split_depth, threshold, split_nodes[i].second))
+                {
+                    lock_guard lock(result_mutex);
+
+                    // Все решения на этой итерации имеют длину threshold, поэтому подходит любое
+                    if (!found)
+                    {
+                        found = true;
+                        ret.moves = searcher.path;
+                    }
+
+                    stop.store(true, memory_order_relaxed);
+                    break;
+                }
+            }
+
+            lock_guard lock(result_mutex);
+            ret.num_nodes += searcher.num_nodes;
+            next_threshold = min(next_threshold, searcher.next_threshold);
+        };
+
+        if (DV_JOB_SYSTEM)
+            DV_JOB_SYSTEM->parallel_for(0, (i32)split_nodes.size(), 1, search_subtrees);
+        else
+            search_subtrees(0, (i32)split_nodes.size());
+
+        if (found)
+            return ret;
+
+        assert(next_threshold != INT_MAX);
+        threshold = next_threshold;
+    }
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <dviglo/common/primitive_types.hpp>
+#include <dviglo/std_utils/string.hpp>
+
+#include <array>
+#include <atomic>
+#include <vector>
+
+using namespace dviglo;
+using namespace std;
+
+
+// Оптимальный решатель пятнашек: IDA* с аддитивной базой шаблонов (pattern database) 6-6-3.
+// Костяшки разбиты на 3 группы, и для каждой группы заранее посчитано минимальное число ходов
+// костяшками группы, чтобы расставить их по местам. Сумма по группам - допустимая (не завышенная) оценка.
+// База строится один раз и сохраняется на диск. Построение долгое: около 30 секунд в одном потоке,
+// а с DV_JOB_SYSTEM - около 15 секунд (группы строятся параллельно, но дольше всего строятся
+// две группы по 6 костяшек). Поэтому игра строит базу в фоне
+class PuzzleSolver
+{
+public:
+    // Поле в 64 битах: по 4 бита на клетку, клетка i (i = y * 4 + x) в битах [4i, 4i + 4). 0 - дырка
+    using Board = u64;
+
+    // Собранная головоломка: 1, 2, ..., 15, 0
+    static constexpr Board goal_board = 0x0FEDCBA987654321;
+
+    static Board encode(const array<u8, 16>& tiles);
+    static array<u8, 16> decode(Board board);
+
+    // Можно ли собрать головоломку (у половины расстановок решения нет)
+    static bool is_solvable(Board board);
+
+    struct Solution
+    {
+        // Клетки, костяшки из которых нужно по очереди сдвинуть в дырку.
+        // Пусто, если головоломка уже собрана или не имеет решения
+        vector<u8> moves;
+
+        // Число посещённых узлов дерева поиска
+        u64 num_nodes = 0;
+    };
+
+private:
+    // Для каждой группы костяшек: минимальное число ходов для каждой расстановки костяшек группы
+    array<vector<u8>, 3> databases_;
+
+    bool load(const StrUtf8& path);
+    void save(const StrUtf8& path) const;
+
+public:
+    // Загружает базу из cache_path, а если файла нет или он испорчен - строит базу и сохраняет её туда.
+    // cache_path может быть пустым (тогда база только строится).
+    // Построение распараллеливается с помощью DV_JOB_SYSTEM, если он есть.
+    // Если во время построения поднимается флаг cancel, то построение прерывается,
+    // ничего не сохраняется и is_ready() возвращает false
+    PuzzleSolver(const StrUtf8& cache_path, const atomic<bool>* cancel = nullptr);
+
+    // База загружена или построена
+    bool is_ready() const { return !databases_[0].empty(); }
+
+    // Нижняя оценка числа ходов до решения. Годится для оценки сложности расстановки
+    i32 estimate(Board board) const;
+
+    // Ищет кратчайшее решение. Если есть DV_JOB_SYSTEM, то поддеревья поиска,
+    // растущие из узлов на небольшой глубине, обходятся параллельно.
+    // Для сложных расстановок (50 ходов и больше) поиск может занять несколько секунд,
+    // поэтому в игре он выполняется не в главном потоке
+    Solution solve(Board board) const;
+};
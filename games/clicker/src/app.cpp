@@ -98,10 +98,10 @@ void App::draw()
     StrUtf8 help_str = "ЛКМ - добывать золото, ПКМ - усилить кирку";
     sprite_batch_->draw_string(help_str, r_20_font_.get(), vec2(10.f, 10.f));
 
-    StrUtf8 power_str = "Сила нажатия: " + power_.to_string() + " (= цене апгрейда)";
+    StrUtf8 power_str = "Сила нажатия: " + power_.to_cached_string() + " (= цене апгрейда)";
     sprite_batch_->draw_string(power_str, r_20_font_.get(), vec2(10.f, 40.f));
 
-    StrUtf8 gold_str = "Золота: " + gold_.to_string();
+    StrUtf8 gold_str = "Золота: " + gold_.to_cached_string();
     sprite_batch_->draw_string(gold_str, r_20_font_.get(), vec2(300.f, 300.f));
 
     sprite_batch_->flush();
@@ -0,0 +1,70 @@
+// Подменяет глобальные operator new и operator delete, чтобы считать выделения памяти в куче
+
+#include "alloc_counter.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+using namespace std;
+
+
+static atomic<u64> allocation_counter{0};
+
+u64 num_allocations()
+{
+    return allocation_counter.load(memory_order_relaxed);
+}
+
+void* operator new(size_t size)
+{
+    allocation_counter.fetch_add(1, memory_order_relaxed);
+
+    // malloc(0) может вернуть nullptr
+    if (void* ptr = malloc(size ? size : 1))
+        return ptr;
+
+    throw bad_alloc();
+}
+
+void* operator new(size_t size, align_val_t alignment)
+{
+    allocation_counter.fetch_add(1, memory_order_relaxed);
+
+    // Размер для aligned_alloc() должен быть кратен выравниванию
+    size_t align = (size_t)alignment;
+    size_t aligned_size = (size + align - 1) / align * align;
+
+#ifdef _MSC_VER
+    if (void* ptr = _aligned_malloc(aligned_size ? aligned_size : align, align))
+#else
+    if (void* ptr = aligned_alloc(align, aligned_size ? aligned_size : align))
+#endif
+        return ptr;
+
+    throw bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete(void* ptr, align_val_t) noexcept
+{
+#ifdef _MSC_VER
+    _aligned_free(ptr);
+#else
+    free(ptr);
+#endif
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    free(ptr);
+}
+
+void operator delete(void* ptr, size_t, align_val_t alignment) noexcept
+{
+    operator delete(ptr, alignment);
+}
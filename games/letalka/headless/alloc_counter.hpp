@@ -0,0 +1,9 @@
+#pragma once
+
+#include <dviglo/common/primitive_types.hpp>
+
+using namespace dviglo;
+
+
+// Число вызовов operator new с момента запуска программы
+u64 num_allocations();
@@ -0,0 +1,196 @@
+// Симуляция леталки без окна и рендеринга для замеров производительности в CI.
+// Параметры:
+// -seconds x - сколько секунд игрового времени симулировать (по умолчанию 60)
+// -seed x - seed генератора случайных чисел (по умолчанию 1)
+// -god_mode - неуязвимость игрока (врагов на экране становится больше)
+// -threads x - число рабочих потоков JobSystem (по умолчанию 0 - системы выполняются в главном потоке)
+// -profile path - сохранить замеры систем в формате Chrome Trace Event
+// -alloc_check_seconds x - сколько секунд после основной симуляции проверять,
+//                          что тики не выделяют память (по умолчанию 10, 0 - не проверять).
+//                          Если память выделялась, то программа возвращает 1
+
+#include "alloc_counter.hpp"
+
+#include "../src/ecs_main.hpp"
+
+#include <dviglo/fs/fs_base.hpp>
+#include <dviglo/fs/log.hpp>
+#include <dviglo/threading/job_system.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+
+// Частота апдейтов, как у игры с vsync 60 Гц
+static constexpr u64 ticks_per_second = 60;
+
+struct Options
+{
+    i32 seconds = 60;
+    u32 seed = 1;
+    bool god_mode = false;
+    i32 threads = 0;
+    StrUtf8 profile_path;
+    i32 alloc_check_seconds = 10;
+};
+
+static Options parse_args(i32 argc, char* argv[])
+{
+    Options ret;
+
+    for (i32 i = 1; i < argc; ++i)
+    {
+        StrUtf8 arg = argv[i];
+        bool has_value = i + 1 < argc;
+
+        if (arg == "-seconds" && has_value)
+            ret.seconds = stoi(argv[++i]);
+        else if (arg == "-seed" && has_value)
+            ret.seed = (u32)stoul(argv[++i]);
+        else if (arg == "-god_mode")
+            ret.god_mode = true;
+        else if (arg == "-threads" && has_value)
+            ret.threads = stoi(argv[++i]);
+        else if (arg == "-profile" && has_value)
+            ret.profile_path = argv[++i];
+        else if (arg == "-alloc_check_seconds" && has_value)
+            ret.alloc_check_seconds = stoi(argv[++i]);
+    }
+
+    return ret;
+}
+
+// Заскриптованный ввод: игрок летает по восьмёрке, как будто двигает мышь
+static SDL_MouseMotionEvent scripted_mouse_motion(u64 tick)
+{
+    f32 t = (f32)tick / ticks_per_second;
+    f32 prev_t = (f32)(tick - 1) / ticks_per_second;
+
+    auto path = [](f32 time)
+    {
+        return vec2(std::sin(time * 0.8f) * 400.f, std::sin(time * 1.6f) * 100.f);
+    };
+
+    vec2 delta = path(t) - path(prev_t);
+
+    SDL_MouseMotionEvent ret{};
+    ret.type = SDL_EVENT_MOUSE_MOTION;
+    ret.xrel = delta.x;
+    ret.yrel = delta.y;
+
+    return ret;
+}
+
+// Заскриптованный ввод: игрок стреляет 3 секунды из каждых 4
+static bool scripted_fire_button(u64 tick)
+{
+    return tick % (ticks_per_second * 4) < ticks_per_second * 3;
+}
+
+// Один тик игры с заскриптованным вводом
+static void simulate_tick(u64 tick)
+{
+    GLOBAL->fire_button = scripted_fire_button(tick);
+    ecs_on_mouse_motion(scripted_mouse_motion(tick));
+    ecs_update(ns_per_second / ticks_per_second);
+}
+
+struct EntityCounts
+{
+    u64 enemies = 0;
+    u64 enemy_projectiles = 0;
+    u64 player_lasers = 0;
+};
+
+static EntityCounts count_entities()
+{
+    registry& reg = *GLOBAL->reg();
+
+    EntityCounts ret;
+    ret.enemies = reg.view<CEnemy>().size();
+    ret.enemy_projectiles = reg.view<CEnemyProjectileMarker>().size();
+    ret.player_lasers = reg.view<CPlayerLaserMarker>().size();
+
+    return ret;
+}
+
+int main(int argc, char* argv[])
+{
+    setlocale(LC_CTYPE, "en_US.UTF-8");
+
+    Options options = parse_args(argc, argv);
+    u64 num_ticks = (u64)options.seconds * ticks_per_second;
+
+    Log log(get_pref_path("dviglo2d", "mini_games") + "letalka_headless.log");
+
+    // Храним все тики, чтобы среднее время систем считалось по всей симуляции
+    Profiler profiler((i32)num_ticks, false);
+
+    unique_ptr<JobSystem> job_system;
+    if (options.threads > 0)
+        job_system = make_unique<JobSystem>(options.threads);
+
+    Global global(true);
+    global.god_mode = options.god_mode;
+    set_enemy_spawner_seed(options.seed);
+    ecs_start();
+
+    EntityCounts max_counts;
+    EntityCounts sum_counts;
+
+    auto begin = chrono::steady_clock::now();
+
+    for (u64 tick = 1; tick <= num_ticks; ++tick)
+    {
+        profiler.begin_frame();
+
+        simulate_tick(tick);
+
+        profiler.end_frame();
+
+        EntityCounts counts = count_entities();
+        max_counts.enemies = std::max(max_counts.enemies, counts.enemies);
+        max_counts.enemy_projectiles = std::max(max_counts.enemy_projectiles, counts.enemy_projectiles);
+        max_counts.player_lasers = std::max(max_counts.player_lasers, counts.player_lasers);
+        sum_counts.enemies += counts.enemies;
+        sum_counts.enemy_projectiles += counts.enemy_projectiles;
+        sum_counts.player_lasers += counts.player_lasers;
+    }
+
+    chrono::duration<f64> duration = chrono::steady_clock::now() - begin;
+
+    CPlayer& player = GLOBAL->reg()->get<CPlayer>(get_player());
+
+    cout << "Симулировано: " << options.seconds << " с, " << num_ticks << " тиков, seed " << options.seed
+         << ", рабочих потоков " << options.threads << endl;
+    cout << "Реальное время: " << duration.count() << " с" << endl;
+    cout << "Тиков в секунду: " << (u64)(num_ticks / duration.count()) << endl;
+    cout << "Враги: в среднем " << sum_counts.enemies / num_ticks << ", максимум " << max_counts.enemies << endl;
+    cout << "Снаряды врагов: в среднем " << sum_counts.enemy_projectiles / num_ticks
+         << ", максимум " << max_counts.enemy_projectiles << endl;
+    cout << "Лазеры игрока: в среднем " << sum_counts.player_lasers / num_ticks
+         << ", максимум " << max_counts.player_lasers << endl;
+    cout << "Счёт: " << player.score << endl;
+    cout << profiler.summary() << endl;
+
+    if (!options.profile_path.empty())
+        profiler.save_chrome_trace(options.profile_path);
+
+    if (options.alloc_check_seconds <= 0)
+        return 0;
+
+    // Основная симуляция прогрела все контейнеры, поэтому дальше память выделяться не должна.
+    // Профайлер выключаем, так как он сам выделяет память под новые кадры
+    profiler.set_enabled(false);
+    u64 num_check_ticks = (u64)options.alloc_check_seconds * ticks_per_second;
+    u64 allocations_before = num_allocations();
+
+    for (u64 tick = num_ticks + 1; tick <= num_ticks + num_check_ticks; ++tick)
+        simulate_tick(tick);
+
+    u64 allocations = num_allocations() - allocations_before;
+    cout << "Выделений памяти за " << options.alloc_check_seconds << " с после прогрева: " << allocations << endl;
+
+    return allocations == 0 ? 0 : 1;
+}
@@ -79,6 +79,9 @@ void App::on_key(const SDL_KeyboardEvent& event_data)
 
 void App::update(u64 ns)
 {
+    // SDL_GetMouseState() нельзя вызывать из рабочих потоков
+    global_->fire_button = SDL_GetMouseState(nullptr, nullptr) & SDL_BUTTON_MASK(1);
+
     ecs_update(ns);
 }
 
@@ -112,6 +115,30 @@ void App::draw()
     sprite_batch->draw_string(god_mode_text, font, god_mode_pos + vec2(1.f, 1.f), 0xFF000000);
     sprite_batch->draw_string(god_mode_text, font, god_mode_pos, 0xFFFFFFFF);
 
+    if (global_->debug_draw)
+    {
+        // Статистика предыдущего кадра, так как текущий ещё не отрендерен
+        const RenderStats& stats = render_stats();
+
+        const StrUtf8 stats_lines[] =
+        {
+            format("Вызовы отрисовки: {}", stats.draw_calls),
+            format("Вершины: {}", stats.vertices),
+            format("Привязки текстур: {}", stats.texture_binds),
+            format("Смены шейдеров: {}", stats.shader_program_uses),
+            format("Загрузки в буферы: {} ({} байт)", stats.buffer_uploads, stats.buffer_upload_bytes),
+        };
+
+        vec2 stats_pos(3.f, 3.f);
+
+        for (const StrUtf8& line : stats_lines)
+        {
+            sprite_batch->draw_string(line, font, stats_pos + vec2(1.f, 1.f), 0xFF000000);
+            sprite_batch->draw_string(line, font, stats_pos, 0xFFFFFFFF);
+            stats_pos.y += (f32)font->line_height();
+        }
+    }
+
     global_->sprite_batch()->flush();
     fbo_->texture()->bind();
     glGenerateMipmap(GL_TEXTURE_2D);
@@ -3,25 +3,49 @@
 #include "global.hpp"
 
 
-void s_apply_velocities(u64 ns)
+void s_apply_velocities(u64 ns, CommandBuffer& commands)
 {
     registry& reg = *GLOBAL->reg();
-
     auto view = reg.view<CObject, CVelocity>(exclude<CDestroyedMarker>);
-    for (auto [ent, obj, vel] : view.each())
+
+    // Копируем список объектов, чтобы делить его на части по индексам.
+    // Память вектора переиспользуется
+    static vector<entity> entities;
+    entities.assign(view.begin(), view.end());
+
+    f32 seconds = (f32)ns / ns_per_second;
+
+    // Двигаем объекты. Части обрабатываются в разных потоках
+    auto process_chunk = [&](i32 begin, i32 end)
     {
-        // Двигаем объект
-        f32 seconds = (f32)ns / ns_per_second;
-        obj.pos += vel.value * seconds;
+        for (i32 i = begin; i < end; ++i)
+        {
+            auto [obj, vel] = view.get<CObject, CVelocity>(entities[i]);
+            obj.pos += vel.value * seconds;
+        }
+    };
+
+    // Меньшие части не окупают запуск задач
+    const i32 min_chunk_size = 256;
 
-        // Вражеские корабли создаются за границей экрана, поэтому удаляем только те объекты,
-        // которые находятся далеко от границы
-        const f32 safe_size = 500.f;
+    if (DV_JOB_SYSTEM)
+        DV_JOB_SYSTEM->parallel_for(0, (i32)entities.size(), min_chunk_size, process_chunk);
+    else
+        process_chunk(0, (i32)entities.size());
+
+    // Вражеские корабли создаются за границей экрана, поэтому удаляем только те объекты,
+    // которые находятся далеко от границы.
+    // Проверка в одном потоке, чтобы порядок команд (и удаления объектов) не зависел от числа потоков
+    const f32 safe_size = 500.f;
+
+    for (entity ent : entities)
+    {
+        const CObject& obj = view.get<CObject>(ent);
 
         if (obj.pos.x < -safe_size || obj.pos.x > (f32)fbo_size.x + safe_size ||
             obj.pos.y < -safe_size || obj.pos.y > (f32)fbo_size.y + safe_size)
         {
-            reg.emplace<CDestroyedMarker>(ent);
+            commands.push([ent] { GLOBAL->reg()->emplace<CDestroyedMarker>(ent); });
         }
     }
 }
@@ -68,3 +92,44 @@ bool is_overlap(const CObject& a, const vec2 b_local_pos, const Collider& b_coll
 {
     return is_overlap(a.pos, a.collider, b_local_pos, b_collider);
 }
+
+Aabb collider_bounds(const vec2 local_pos, const Collider& collider)
+{
+    vec2 center = local_pos + collider.pos;
+    return Aabb(center - collider.half_size, center + collider.half_size);
+}
+
+void extract_sprite(const CObject& obj, const Rect& destination, u32 color)
+{
+    // Объекты, улетевшие за экран, удаляются не сразу (см. s_apply_velocities())
+    if (destination.pos.x >= (f32)fbo_size.x || destination.pos.x + destination.size.x <= 0.f ||
+        destination.pos.y >= (f32)fbo_size.y || destination.pos.y + destination.size.y <= 0.f)
+    {
+        return;
+    }
+
+    // Объекты одного типа используют один и тот же спрайт и обычно идут подряд,
+    // поэтому текстурные координаты пересчитываются только при смене спрайта или спрайтшита
+    Global& global = *GLOBAL;
+    Global::LastSpriteUv& last = global.last_sprite_uv;
+    const Texture* spritesheet = global.spritesheet();
+
+    if (obj.uv != last.source || spritesheet != last.texture || spritesheet->revision() != last.texture_revision)
+    {
+        last.source = obj.uv;
+        last.texture = spritesheet;
+        last.texture_revision = spritesheet->revision();
+        last.uv = src_to_uv(&obj.uv, spritesheet);
+    }
+
+    global.sprites.push_back({destination, last.uv, color});
+}
+
+void submit_sprites()
+{
+    Global& global = *GLOBAL;
+    global.sprite_list.clear();
+    global.sprite_list.draw_sprites(global.spritesheet(), global.sprites.data(), (u32)global.sprites.size());
+    global.sprite_batch()->submit(global.sprite_list);
+    global.sprites.clear();
+}
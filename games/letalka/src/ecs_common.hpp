@@ -2,6 +2,7 @@
 
 #include <dviglo/common/primitive_types.hpp>
 #include <dviglo/math/rect.hpp>
+#include <dviglo/threading/command_buffer.hpp>
 #include <glm/glm.hpp>
 
 using namespace dviglo;
@@ -68,8 +69,9 @@ struct CDestroyedMarker
 
 // ===================== Системы =====================
 
-// Перемещает объекты и уничтожает их, если они далеко за границей экрана
-void s_apply_velocities(u64 ns);
+// Перемещает объекты и уничтожает их, если они далеко за границей экрана.
+// Объекты обрабатываются параллельно по частям
+void s_apply_velocities(u64 ns, CommandBuffer& commands);
 
 void s_draw_colliders();
 
@@ -84,3 +86,13 @@ bool is_overlap(const CObject& a, const CObject& b);
 
 // Определяет наложение коллайдеров
 bool is_overlap(const CObject& a, const vec2 b_local_pos, const Collider& b_collider);
+
+// Экранные координаты коллайдера
+Aabb collider_bounds(const vec2 local_pos, const Collider& collider);
+
+// Добавляет спрайт объекта в GLOBAL->sprites, если он виден на экране.
+// destination - область спрайта на экране
+void extract_sprite(const CObject& obj, const Rect& destination, u32 color = 0xFFFFFFFF);
+
+// Отправляет собранные спрайты в SpriteBatch и очищает список
+void submit_sprites();
@@ -42,13 +42,12 @@ void s_update_drone_velocities(u64 ns)
 void s_draw_enemies()
 {
     registry& reg = *GLOBAL->reg();
-    SpriteBatch& sprite_batch = *GLOBAL->sprite_batch();
 
     auto view = reg.view<CObject, CEnemy>();
     for (entity ent : view)
     {
         CObject& obj = view.get<CObject>(ent);
-        sprite_batch.draw_sprite(GLOBAL->spritesheet(), obj.pos - obj.uv.size * 0.5f, &obj.uv);
+        extract_sprite(obj, Rect(obj.pos - obj.uv.size * 0.5f, obj.uv.size));
     }
 }
 
@@ -43,80 +43,154 @@ void s_remove_destroyed()
         reg.destroy(ent);
 }
 
+// Категории объектов в SpatialHash
+enum CollisionCategory : u32
+{
+    cat_player_laser = 1 << 0,
+    cat_enemy_projectile = 1 << 1,
+    cat_enemy = 1 << 2
+};
+
+// Перестраивает широкую фазу по текущим позициям объектов
+static void update_spatial_hash()
+{
+    registry& reg = *GLOBAL->reg();
+    SpatialHash& hash = *GLOBAL->spatial_hash();
+
+    hash.begin_update();
+
+    for (auto [ent, obj] : reg.view<CObject, CPlayerLaserMarker>(exclude<CDestroyedMarker>).each())
+        hash.update(to_integral(ent), collider_bounds(obj.pos, obj.collider), cat_player_laser);
+
+    for (auto [ent, obj] : reg.view<CObject, CEnemyProjectileMarker>(exclude<CDestroyedMarker>).each())
+        hash.update(to_integral(ent), collider_bounds(obj.pos, obj.collider), cat_enemy_projectile);
+
+    for (auto [ent, obj, enemy] : reg.view<CObject, CEnemy>(exclude<CDestroyedMarker>).each())
+    {
+        // Хитбокс используется для снарядов игрока, а коллайдер - для корабля игрока
+        Aabb bounds = collider_bounds(obj.pos, obj.collider);
+        bounds.merge(collider_bounds(obj.pos, enemy.hitbox));
+        hash.update(to_integral(ent), bounds, cat_enemy);
+    }
+
+    // Уничтоженные объекты удаляются из хеша
+    hash.end_update();
+}
+
 void s_check_collisions()
 {
     registry& reg = *GLOBAL->reg();
+    SpatialHash& hash = *GLOBAL->spatial_hash();
     entity player_ent = get_player();
     CObject& player_obj = reg.get<CObject>(player_ent);
 
+    update_spatial_hash();
+
     // Ищем столкновения снарядов игрока со снарядами врагов
+    hash.query_pairs(cat_player_laser, cat_enemy_projectile, [&reg](u32 player_laser_id, u32 enemy_proj_id)
     {
-        auto enemy_proj_view = reg.view<CObject, CEnemyProjectileMarker>(exclude<CDestroyedMarker>);
-        for (entity enemy_proj_ent : enemy_proj_view)
-        {
-            CObject& enemy_proj_obj = enemy_proj_view.get<CObject>(enemy_proj_ent);
+        entity player_laser_ent{player_laser_id};
+        entity enemy_proj_ent{enemy_proj_id};
 
-            auto player_laser_view = reg.view<CObject, CPlayerLaserMarker>(exclude<CDestroyedMarker>);
-            for (entity player_laser_ent : player_laser_view)
-            {
-                CObject& player_laser_obj = player_laser_view.get<CObject>(player_laser_ent);
-
-                if (is_overlap(player_laser_obj, enemy_proj_obj))
-                {
-                    reg.emplace<CDestroyedMarker>(player_laser_ent);
-                    reg.emplace<CDestroyedMarker>(enemy_proj_ent);
-                    break;
-                }
-            }
+        // Лазер мог уже столкнуться с другим снарядом
+        if (reg.all_of<CDestroyedMarker>(player_laser_ent) || reg.all_of<CDestroyedMarker>(enemy_proj_ent))
+            return;
+
+        if (is_overlap(reg.get<CObject>(player_laser_ent), reg.get<CObject>(enemy_proj_ent)))
+        {
+            reg.emplace<CDestroyedMarker>(player_laser_ent);
+            reg.emplace<CDestroyedMarker>(enemy_proj_ent);
         }
-    }
+    });
 
     // Ищем столкновения снарядов игрока и кораблей противников
+    hash.query_pairs(cat_player_laser, cat_enemy, [&reg, player_ent](u32 player_laser_id, u32 enemy_id)
     {
-        auto enemy_view = reg.view<CObject, CEnemy>(exclude<CDestroyedMarker>);
-        for (entity enemy_ent : enemy_view)
-        {
-            CObject& enemy_obj = enemy_view.get<CObject>(enemy_ent);
-            CEnemy& enemy_enemy = enemy_view.get<CEnemy>(enemy_ent);
+        entity player_laser_ent{player_laser_id};
+        entity enemy_ent{enemy_id};
 
-            auto player_laser_view = reg.view<CObject, CPlayerLaserMarker>(exclude<CDestroyedMarker>);
-            for (entity player_laser_ent : player_laser_view)
-            {
-                CObject& player_laser_obj = player_laser_view.get<CObject>(player_laser_ent);
-
-                // Используем хитбокс врага, который больше коллайдера
-                if (is_overlap(player_laser_obj, enemy_obj.pos, enemy_enemy.hitbox))
-                {
-                    CPlayer& player = reg.get<CPlayer>(player_ent);
-                    reg.emplace<CDestroyedMarker>(player_laser_ent);
-                    reg.emplace<CDestroyedMarker>(enemy_ent);
-                    ++player.score;
-                    break;
-                }
-            }
+        if (reg.all_of<CDestroyedMarker>(player_laser_ent) || reg.all_of<CDestroyedMarker>(enemy_ent))
+            return;
+
+        const CObject& enemy_obj = reg.get<CObject>(enemy_ent);
+        const CEnemy& enemy_enemy = reg.get<CEnemy>(enemy_ent);
+
+        // Используем хитбокс врага, который больше коллайдера
+        if (is_overlap(reg.get<CObject>(player_laser_ent), enemy_obj.pos, enemy_enemy.hitbox))
+        {
+            CPlayer& player = reg.get<CPlayer>(player_ent);
+            reg.emplace<CDestroyedMarker>(player_laser_ent);
+            reg.emplace<CDestroyedMarker>(enemy_ent);
+            ++player.score;
         }
-    }
+    });
 
     if (!GLOBAL->god_mode)
     {
-        // Ищем столкновения снарядов противника и корабля игрока
-        auto enemy_proj_view = reg.view<CObject, CEnemyProjectileMarker>(exclude<CDestroyedMarker>);
-        for (entity enemy_proj_ent : enemy_proj_view)
-        {
-            CObject& enemy_proj_obj = enemy_proj_view.get<CObject>(enemy_proj_ent);
-
-            if (is_overlap(player_obj, enemy_proj_obj))
-                restart_game();
-        }
+        // Ищем столкновения корабля игрока со снарядами и кораблями противника
+        // Память не выделяется каждый тик
+        static vector<u32> candidates;
+        candidates.clear();
+        hash.query(collider_bounds(player_obj.pos, player_obj.collider), cat_enemy_projectile | cat_enemy, candidates);
 
-        // Ищем столкновения корабля игрока с кораблями противника
-        auto enemy_view = reg.view<CObject, CEnemy>(exclude<CDestroyedMarker>);
-        for (entity enemy_ent : enemy_view)
+        for (u32 id : candidates)
         {
-            CObject& enemy_obj = enemy_view.get<CObject>(enemy_ent);
+            entity ent{id};
 
-            if (is_overlap(player_obj, enemy_obj))
+            if (reg.all_of<CDestroyedMarker>(ent))
+                continue;
+
+            if (is_overlap(player_obj, reg.get<CObject>(ent)))
+            {
                 restart_game();
+                return;
+            }
         }
     }
 }
+
+// Хранилища компонентов создаются заранее, так как registry::view() создаёт
+// недостающее хранилище, а это нельзя делать из нескольких потоков одновременно
+static void create_storages()
+{
+    registry& reg = *GLOBAL->reg();
+
+    reg.storage<CObject>();
+    reg.storage<CVelocity>();
+    reg.storage<CDestroyedMarker>();
+    reg.storage<CEnemy>();
+    reg.storage<CDrone>();
+    reg.storage<CFighterMarker>();
+    reg.storage<CGunshipMarker>();
+    reg.storage<CPlayer>();
+    reg.storage<CEnemyProjectileMarker>();
+    reg.storage<CPlayerLaserMarker>();
+    reg.storage<CEnemyLaserMarker>();
+    reg.storage<CEnemyPlasmaMarker>();
+    reg.storage<CSpawnEnemyDelay>();
+    reg.storage<CGuns>();
+}
+
+void build_schedule()
+{
+    create_storages();
+
+    SystemScheduler& scheduler = *GLOBAL->scheduler();
+
+    // CDestroyedMarker параллельные системы только читают (добавляют его через CommandBuffer)
+
+    scheduler.add("s_spawn_enemy", reads<>(), writes<CSpawnEnemyDelay>(), s_spawn_enemy);
+
+    scheduler.add("s_update_drone_velocities", reads<CObject, CPlayer>(), writes<CDrone, CVelocity>(),
+                  [](u64 ns, CommandBuffer&) { s_update_drone_velocities(ns); });
+
+    scheduler.add("s_player_shoot", reads<CObject, CPlayer>(), writes<CGuns>(), s_player_shoot);
+    scheduler.add("s_fighters_shoot", reads<CObject, CFighterMarker>(), writes<CGuns>(), s_fighters_shoot);
+    scheduler.add("s_gunships_shoot", reads<CObject, CGunshipMarker>(), writes<CGuns>(), s_gunships_shoot);
+
+    // Зависит от всех систем выше, которые читают CObject или меняют CVelocity
+    scheduler.add("s_apply_velocities", reads<CVelocity>(), writes<CObject>(), s_apply_velocities);
+
+    scheduler.add_exclusive("s_check_collisions", [](u64, CommandBuffer&) { s_check_collisions(); });
+    scheduler.add_exclusive("s_remove_destroyed", [](u64, CommandBuffer&) { s_remove_destroyed(); });
+}
@@ -15,12 +15,23 @@ void s_check_collisions();
 // Удаляет уничтоженные объекты из списков
 void s_remove_destroyed();
 
+// Регистрирует системы апдейта в GLOBAL->scheduler()
+void build_schedule();
+
 // ================== Инициализация и апдейт ==================
 
 inline void ecs_start()
 {
+    // Память выделяется заранее, чтобы в процессе игры не было выделений памяти
+    reserve_projectiles(1024);
+
+    // Объекты удаляются, когда улетают от экрана дальше 500 пикселей (см. s_apply_velocities())
+    GLOBAL->spatial_hash()->reserve(Aabb(vec2(-500.f), vec2(fbo_size) + 500.f), 2048);
+
     create_enemy_spawner();
     create_player();
+
+    build_schedule();
 }
 
 inline void ecs_on_mouse_motion(const SDL_MouseMotionEvent& event_data)
@@ -30,14 +41,9 @@ inline void ecs_on_mouse_motion(const SDL_MouseMotionEvent& event_data)
 
 inline void ecs_update(u64 ns)
 {
-    s_spawn_enemy(ns);
-    s_update_drone_velocities(ns);
-    s_player_shoot(ns);
-    s_fighters_shoot(ns);
-    s_gunships_shoot(ns);
-    s_apply_velocities(ns);
-    s_check_collisions();
-    s_remove_destroyed();
+    DV_PROFILE_SCOPE("ecs_update");
+
+    GLOBAL->scheduler()->run(ns);
 }
 
 inline void ecs_draw()
@@ -48,6 +54,9 @@ inline void ecs_draw()
     s_draw_enemy_plasmas();
     s_draw_player();
 
+    // Все спрайты выше рендерятся одним вызовом
+    submit_sprites();
+
     if (GLOBAL->debug_draw)
     {
         s_draw_colliders();
@@ -18,10 +18,7 @@ void create_player()
     reg.emplace<CObject>(ent, pos, uv, collider);
 
     // Добавляем два лазера
-    vector<Gun> guns;
-    guns.emplace_back(u64(0), vec2(-32.f, -21.f));
-    guns.emplace_back(u64(0), vec2(32.f, -21.f));
-    reg.emplace<CGuns>(ent, guns);
+    reg.emplace<CGuns>(ent, CGuns{Gun{0, vec2(-32.f, -21.f)}, Gun{0, vec2(32.f, -21.f)}});
 }
 
 entity get_player()
@@ -51,7 +48,7 @@ void s_draw_player()
     registry& reg = *GLOBAL->reg();
     entity ent = get_player();
     CObject& obj = reg.get<CObject>(ent);
-    GLOBAL->sprite_batch()->draw_sprite(GLOBAL->spritesheet(), obj.pos - obj.uv.size * 0.5f, &obj.uv);
+    extract_sprite(obj, Rect(obj.pos - obj.uv.size * 0.5f, obj.uv.size));
 }
 
 void s_draw_score()
@@ -5,12 +5,12 @@
 #include "global.hpp"
 
 
-static void draw_laser(CObject& obj)
+static void draw_laser(const CObject& obj)
 {
     // Размер лазера на экране совпадает с размером коллайдера
     Rect screen_rect(obj.pos - obj.collider.half_size, obj.collider.half_size * 2.f);
 
-    GLOBAL->sprite_batch()->draw_sprite(GLOBAL->spritesheet(), screen_rect, &obj.uv, 0xAA00FF00);
+    extract_sprite(obj, screen_rect, 0xAA00FF00);
 }
 
 void s_draw_player_lasers()
@@ -49,60 +49,98 @@ void s_draw_enemy_plasmas()
         // Размер плазмы на экране совпадает с размером коллайдера
         Rect screen_rect(obj.pos - obj.collider.half_size, obj.collider.half_size * 2.f);
 
-        GLOBAL->sprite_batch()->draw_sprite(GLOBAL->spritesheet(), screen_rect, &obj.uv, 0xAA00BBFF);
+        extract_sprite(obj, screen_rect, 0xAA00BBFF);
     }
 }
 
-void create_laser(const vec2 screen_muzzle_pos, bool enemy)
+// Шаблон снаряда: компоненты, которые одинаковы у всех снарядов одного типа
+struct ProjectilePrefab
+{
+    Rect uv;
+
+    // Заодно размер снаряда на экране
+    Collider collider;
+
+    // Пикселей в секунду
+    f32 speed;
+};
+
+static const ProjectilePrefab laser_prefab
+{
+    Rect({26.f, 114.f}, {128.f, 128.f}),
+    Collider({0.f, 0.f}, {2.f, 10.f}),
+    300.f
+};
+
+static const ProjectilePrefab plasma_prefab
+{
+    Rect({26.f, 114.f}, {128.f, 128.f}),
+    Collider({0.f, 0.f}, {6.f, 6.f}),
+    100.f
+};
+
+// Создаёт снаряд по шаблону. Markers - компоненты-метки, определяющие тип снаряда
+template<typename... Markers>
+static entity stamp_projectile(const ProjectilePrefab& prefab, vec2 pos, vec2 velocity)
 {
     registry& reg = *GLOBAL->reg();
-    Rect uv({26.f, 114.f}, {128.f, 128.f});
-    Collider collider({0.f, 0.f}, {2.f, 10.f}); // Заодно размер лазера на экране
 
+    // Уничтоженные снаряды возвращают идентификаторы в реестр, и reg.create()
+    // использует их повторно. Память под компоненты зарезервирована в reserve_projectiles()
+    entity ent = reg.create();
+    reg.emplace<CObject>(ent, pos, prefab.uv, prefab.collider);
+    reg.emplace<CVelocity>(ent, velocity);
+    (reg.emplace<Markers>(ent), ...);
+
+    return ent;
+}
+
+void create_laser(const vec2 screen_muzzle_pos, bool enemy)
+{
     vec2 pos = screen_muzzle_pos;
-    vec2 velocity = vec2(0.f, 300.f);
+    vec2 velocity = vec2(0.f, laser_prefab.speed);
 
     if (enemy)
     {
         // Дуло направлено вниз
-        pos.y -= collider.half_size.y;
+        pos.y -= laser_prefab.collider.half_size.y;
+        stamp_projectile<CEnemyLaserMarker, CEnemyProjectileMarker>(laser_prefab, pos, velocity);
     }
     else
     {
         // Дуло направлено вверх
-        pos.y += collider.half_size.y;
+        pos.y += laser_prefab.collider.half_size.y;
         velocity.y = -velocity.y;
-    }
-
-    entity ent = reg.create();
-    reg.emplace<CObject>(ent, pos, uv, collider);
-    reg.emplace<CVelocity>(ent, velocity);
-
-    if (enemy)
-    {
-        reg.emplace<CEnemyLaserMarker>(ent);
-        reg.emplace<CEnemyProjectileMarker>(ent);
-    }
-    else
-    {
-        reg.emplace<CPlayerLaserMarker>(ent);
+        stamp_projectile<CPlayerLaserMarker>(laser_prefab, pos, velocity);
     }
 }
 
 void create_plasma(const vec2 screen_muzzle_pos)
 {
     registry& reg = *GLOBAL->reg();
-    Rect uv({26.f, 114.f}, {128.f, 128.f});
-    Collider collider({0.f, 0.f}, {6.f, 6.f}); // Заодно размер плазмы на экране
-
     entity player_ent = get_player();
     CObject& player_obj = reg.get<CObject>(player_ent);
     vec2 dir = normalize(player_obj.pos - screen_muzzle_pos);
-    vec2 velocity = dir * 100.f;
+    vec2 velocity = dir * plasma_prefab.speed;
 
-    entity ent = reg.create();
-    reg.emplace<CObject>(ent, screen_muzzle_pos, uv, collider);
-    reg.emplace<CEnemyPlasmaMarker>(ent);
-    reg.emplace<CEnemyProjectileMarker>(ent);
-    reg.emplace<CVelocity>(ent, velocity);
+    stamp_projectile<CEnemyPlasmaMarker, CEnemyProjectileMarker>(plasma_prefab, screen_muzzle_pos, velocity);
+}
+
+void reserve_projectiles(u32 count)
+{
+    registry& reg = *GLOBAL->reg();
+
+    reg.storage<CObject>().reserve(count);
+    reg.storage<CVelocity>().reserve(count);
+    reg.storage<CPlayerLaserMarker>().reserve(count);
+    reg.storage<CEnemyLaserMarker>().reserve(count);
+    reg.storage<CEnemyPlasmaMarker>().reserve(count);
+    reg.storage<CEnemyProjectileMarker>().reserve(count);
+    reg.storage<CDestroyedMarker>().reserve(count);
+
+    // Создаём и сразу уничтожаем сущности, чтобы реестр выделил память под идентификаторы.
+    // Потом reg.create() будет брать их из списка свободных
+    vector<entity> entities(count);
+    reg.create(entities.begin(), entities.end());
+    reg.destroy(entities.begin(), entities.end());
 }
@@ -1,7 +1,9 @@
 #pragma once
 
+#include <dviglo/common/primitive_types.hpp>
 #include <glm/glm.hpp>
 
+using namespace dviglo;
 using namespace glm;
 
 
@@ -40,3 +42,7 @@ void s_draw_enemy_plasmas();
 void create_laser(const vec2 screen_muzzle_pos, bool enemy);
 
 void create_plasma(const vec2 screen_muzzle_pos);
+
+// Пул снарядов: заранее выделяет память под count снарядов,
+// чтобы стрельба в процессе игры не выделяла память
+void reserve_projectiles(u32 count);
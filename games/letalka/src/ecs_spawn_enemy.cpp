@@ -26,6 +26,12 @@ public:
         generator_.seed(seed);
     }
 
+    // Фиксированный seed делает симуляцию воспроизводимой
+    void set_seed(u32 seed)
+    {
+        generator_.seed(seed);
+    }
+
     // Генерирует случайное число из диапазона [min, max] включительно
     i32 generate(i32 min, i32 max)
     {
@@ -36,98 +42,124 @@ public:
 
 static Random rnd;
 
-static const Rect drone_uv({108.f, 2.f}, {64.f, 64.f});
-static const Rect fighter_uv({182.f, 6.f}, {74.f, 64.f});
-static const Rect gunship_uv({269.f, 7.f}, {64.f, 64.f});
+void set_enemy_spawner_seed(u32 seed)
+{
+    rnd.set_seed(seed);
+}
 
-static void create_drone(vec2 pos)
+// Шаблон врага: компоненты, которые одинаковы у всех врагов одного типа.
+// Создаются один раз, а при спавне только копируются
+struct EnemyPrefab
 {
-    registry& reg = *GLOBAL->reg();
-    Collider collider({0.f, 0.f}, {25.f, 25.f});
-    Collider hitbox({0.f, 0.f}, {30, 30});
+    Rect uv;
+    Collider collider;
+
+    // Хитбокс больше коллайдера
+    Collider hitbox;
+
+    CGuns guns;
+};
+
+static const EnemyPrefab drone_prefab
+{
+    Rect({108.f, 2.f}, {64.f, 64.f}),
+    Collider({0.f, 0.f}, {25.f, 25.f}),
+    Collider({0.f, 0.f}, {30.f, 30.f}),
+    CGuns{}
+};
+
+static const EnemyPrefab fighter_prefab
+{
+    Rect({182.f, 6.f}, {74.f, 64.f}),
+    Collider({0.f, -6.f}, {16.f, 25.f}),
+    Collider({0.f, 0.f}, {37.f, 32.f}),
+    CGuns{Gun{0, vec2(0.f, 32.f)}}
+};
+
+static const EnemyPrefab gunship_prefab
+{
+    Rect({269.f, 7.f}, {64.f, 64.f}),
+    Collider({0.f, 0.f}, {25.f, 25.f}),
+    Collider({0.f, 0.f}, {30.f, 30.f}),
+    CGuns{Gun{0, vec2(0.f, 0.f)}}
+};
 
+// Создаёт врага по шаблону. Marker - компонент, определяющий тип врага
+template<typename Marker>
+static entity stamp_enemy(const EnemyPrefab& prefab, vec2 pos, vec2 velocity, const Marker& marker)
+{
+    registry& reg = *GLOBAL->reg();
     entity ent = reg.create();
-    reg.emplace<CObject>(ent, pos, drone_uv, collider);
-    reg.emplace<CEnemy>(ent, hitbox);
-    reg.emplace<CDrone>(ent, u64(0));
-    reg.emplace<CVelocity>(ent, vec2(0.f, 0.f));
+    reg.emplace<CObject>(ent, pos, prefab.uv, prefab.collider);
+    reg.emplace<CEnemy>(ent, prefab.hitbox);
+
+    if constexpr (is_empty_v<Marker>)
+        reg.emplace<Marker>(ent);
+    else
+        reg.emplace<Marker>(ent, marker);
+
+    reg.emplace<CVelocity>(ent, velocity);
+
+    if (prefab.guns.count)
+        reg.emplace<CGuns>(ent, prefab.guns);
+
+    return ent;
+}
+
+static void create_drone(vec2 pos)
+{
+    stamp_enemy(drone_prefab, pos, vec2(0.f, 0.f), CDrone{u64(0)});
 }
 
-static void spawn_drones()
+static void spawn_drones(CommandBuffer& commands)
 {
     f32 y = 130.f;
 
     // Дрон слева
-    f32 x = -drone_uv.size.y / 2;
-    create_drone({x, y});
+    f32 x = -drone_prefab.uv.size.y / 2;
+    commands.push([x, y] { create_drone({x, y}); });
 
     // Дрон справа
-    x = (f32)fbo_size.x + drone_uv.size.y / 2;
-    create_drone({x, y});
+    x = (f32)fbo_size.x + drone_prefab.uv.size.y / 2;
+    commands.push([x, y] { create_drone({x, y}); });
 }
 
 static void create_fighter(vec2 pos)
 {
-    registry& reg = *GLOBAL->reg();
-    Collider collider({0.f, -6.f}, {16.f, 25.f});
-    Collider hitbox({0.f, 0.f}, {37, 32});
-
-    entity ent = reg.create();
-    reg.emplace<CObject>(ent, pos, fighter_uv, collider);
-    reg.emplace<CEnemy>(ent, hitbox);
-    reg.emplace<CFighterMarker>(ent);
-    reg.emplace<CVelocity>(ent, vec2(0.f, 200.f));
-
-    vector<Gun> guns;
-    guns.emplace_back(u64(0), vec2(0.f, 32.f));
-    reg.emplace<CGuns>(ent, guns);
+    stamp_enemy(fighter_prefab, pos, vec2(0.f, 200.f), CFighterMarker{});
 }
 
-static void spawn_fighters()
+static void spawn_fighters(CommandBuffer& commands)
 {
     // Истребитель за верхней границей экрана
-    f32 x = (f32)rnd.generate(i32(fighter_uv.size.x / 2), i32(fbo_size.x - fighter_uv.size.x / 2));
-    f32 y = -fighter_uv.size.y / 2.f;
-    create_fighter({x, y});
+    f32 x = (f32)rnd.generate(i32(fighter_prefab.uv.size.x / 2), i32(fbo_size.x - fighter_prefab.uv.size.x / 2));
+    f32 y = -fighter_prefab.uv.size.y / 2.f;
+    commands.push([x, y] { create_fighter({x, y}); });
 
     // Второй истребитель выше первого, поэтому вылетит из-за края экрана позже
-    x = (f32)rnd.generate(i32(fighter_uv.size.x / 2), i32(fbo_size.x - fighter_uv.size.x / 2));
-    y = -fighter_uv.size.y * 2.5f;
-    create_fighter({x, y});
+    x = (f32)rnd.generate(i32(fighter_prefab.uv.size.x / 2), i32(fbo_size.x - fighter_prefab.uv.size.x / 2));
+    y = -fighter_prefab.uv.size.y * 2.5f;
+    commands.push([x, y] { create_fighter({x, y}); });
 }
 
 static void create_gunship(vec2 pos)
 {
-    registry& reg = *GLOBAL->reg();
-    Collider collider({0.f, 0.f}, {25.f, 25.f});
-    Collider hitbox({0.f, 0.f}, {30, 30});
-
-    entity ent = reg.create();
-    reg.emplace<CObject>(ent, pos, gunship_uv, collider);
-    reg.emplace<CEnemy>(ent, hitbox);
-    reg.emplace<CGunshipMarker>(ent);
-
-    if (pos.x < fbo_size.x / 2) // Появляется слева - движемся вправо
-        reg.emplace<CVelocity>(ent, vec2(300.f, 0.f));
-    else // Движемся влево
-        reg.emplace<CVelocity>(ent, vec2(-300.f, 0.f));
-
-    vector<Gun> guns;
-    guns.emplace_back(u64(0), vec2(0.f, 0.f));
-    reg.emplace<CGuns>(ent, guns);
+    // Появляется слева - движемся вправо, иначе влево
+    vec2 velocity = pos.x < fbo_size.x / 2 ? vec2(300.f, 0.f) : vec2(-300.f, 0.f);
+    stamp_enemy(gunship_prefab, pos, velocity, CGunshipMarker{});
 }
 
-static void spawn_gunships()
+static void spawn_gunships(CommandBuffer& commands)
 {
     // Ганшип слева
-    f32 x = -(f32)gunship_uv.size.x / 2;
+    f32 x = -(f32)gunship_prefab.uv.size.x / 2;
     f32 y = (f32)rnd.generate(100, 600);
-    create_gunship({x, y});
+    commands.push([x, y] { create_gunship({x, y}); });
 
     // Ганшип справа
-    x = (f32)fbo_size.x + gunship_uv.size.x / 2;
+    x = (f32)fbo_size.x + gunship_prefab.uv.size.x / 2;
     y = (f32)rnd.generate(100, 600);
-    create_gunship({x, y});
+    commands.push([x, y] { create_gunship({x, y}); });
 }
 
 void create_enemy_spawner()
@@ -148,7 +180,7 @@ void reset_enemy_spawner()
     delay.value = ns_per_second * 1;
 }
 
-void s_spawn_enemy(u64 ns)
+void s_spawn_enemy(u64 ns, CommandBuffer& commands)
 {
     registry& reg = *GLOBAL->reg();
     auto view = reg.view<CSpawnEnemyDelay>();
@@ -162,11 +194,11 @@ void s_spawn_enemy(u64 ns)
         i32 enemy_type = rnd.generate(0, 2);
 
         if (enemy_type == 0)
-            spawn_drones();
+            spawn_drones(commands);
         else if (enemy_type == 1)
-            spawn_fighters();
+            spawn_fighters(commands);
         else // enemy_type == 2
-            spawn_gunships();
+            spawn_gunships(commands);
 
         delay.value = ns_per_second * 2;
     }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <dviglo/common/primitive_types.hpp>
+#include <dviglo/threading/command_buffer.hpp>
 
 using namespace dviglo;
 
@@ -15,10 +16,13 @@ struct CSpawnEnemyDelay
 
 // ===================== Системы =====================
 
-// Создаёт очередную пачку врагов, если прошла задержка
-void s_spawn_enemy(u64 ns);
+// Создаёт очередную пачку врагов (через commands), если прошла задержка
+void s_spawn_enemy(u64 ns, CommandBuffer& commands);
 
 // ===================== Утилиты =====================
 
 void create_enemy_spawner();
 void reset_enemy_spawner();
+
+// Для воспроизводимой симуляции (по умолчанию seed случайный)
+void set_enemy_spawner_seed(u32 seed);
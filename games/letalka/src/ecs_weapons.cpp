@@ -25,29 +25,29 @@ static bool is_inside_screen(const CObject& obj)
     }
 }
 
-void s_player_shoot(u64 ns)
+void s_player_shoot(u64 ns, CommandBuffer& commands)
 {
     registry& reg = *GLOBAL->reg();
     entity player_ent = get_player();
     CObject& player_obj = reg.get<CObject>(player_ent);
     CGuns& player_guns = reg.get<CGuns>(player_ent);
-    Uint32 mouse_state = SDL_GetMouseState(nullptr, nullptr);
+    bool fire = GLOBAL->fire_button;
 
     // Для каждой лазерной пушки игрока
-    for (Gun& gun : player_guns.guns)
+    for (Gun& gun : player_guns)
     {
         decrease_delay(gun.shoot_delay, ns);
 
-        if (gun.shoot_delay == 0 && mouse_state & SDL_BUTTON_MASK(1))
+        if (gun.shoot_delay == 0 && fire)
         {
             vec2 screen_muzzle_pos = player_obj.pos + gun.muzzle_pos;
-            create_laser(screen_muzzle_pos, false);
+            commands.push([screen_muzzle_pos] { create_laser(screen_muzzle_pos, false); });
             gun.shoot_delay = ns_per_second / 2;
         }
     }
 }
 
-void s_fighters_shoot(u64 ns)
+void s_fighters_shoot(u64 ns, CommandBuffer& commands)
 {
     registry& reg = *GLOBAL->reg();
     auto view = reg.view<CObject, CGuns, CFighterMarker>(exclude<CDestroyedMarker>);
@@ -56,14 +56,14 @@ void s_fighters_shoot(u64 ns)
         // Начнёт стрелять после вылета на экран
         if (is_inside_screen(fighter_obj))
         {
-            for (Gun& gun : fighter_guns.guns)
+            for (Gun& gun : fighter_guns)
             {
                 decrease_delay(gun.shoot_delay, ns);
 
                 if (gun.shoot_delay == 0)
                 {
                     vec2 screen_muzzle_pos = fighter_obj.pos + gun.muzzle_pos;
-                    create_laser(screen_muzzle_pos, true);
+                    commands.push([screen_muzzle_pos] { create_laser(screen_muzzle_pos, true); });
                     gun.shoot_delay = ns_per_second * 3 / 2;
                 }
             }
@@ -71,7 +71,7 @@ void s_fighters_shoot(u64 ns)
     }
 }
 
-void s_gunships_shoot(u64 ns)
+void s_gunships_shoot(u64 ns, CommandBuffer& commands)
 {
     registry& reg = *GLOBAL->reg();
     auto view = reg.view<CObject, CGuns, CGunshipMarker>(exclude<CDestroyedMarker>);
@@ -80,14 +80,14 @@ void s_gunships_shoot(u64 ns)
         // Начнёт стрелять после вылета на экран
         if (is_inside_screen(gunship_obj))
         {
-            for (Gun& gun : gunship_guns.guns)
+            for (Gun& gun : gunship_guns)
             {
                 decrease_delay(gun.shoot_delay, ns);
 
                 if (gun.shoot_delay == 0)
                 {
                     vec2 screen_muzzle_pos = gunship_obj.pos + gun.muzzle_pos;
-                    create_plasma(screen_muzzle_pos);
+                    commands.push([screen_muzzle_pos] { create_plasma(screen_muzzle_pos); });
                     gun.shoot_delay = ns_per_second * 2;
                 }
             }
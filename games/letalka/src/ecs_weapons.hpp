@@ -1,8 +1,11 @@
 #pragma once
 
 #include <dviglo/common/primitive_types.hpp>
+#include <dviglo/threading/command_buffer.hpp>
 #include <glm/glm.hpp>
-#include <vector>
+
+#include <array>
+#include <type_traits>
 
 using namespace dviglo;
 using namespace glm;
@@ -22,16 +25,37 @@ struct Gun
 
 // ===================== Компоненты =====================
 
-// Чтобы прикрепить к кораблю несколько компонентов одного типа, помещаем их в компонент-массив
+// Чтобы прикрепить к кораблю несколько компонентов одного типа, помещаем их в компонент-массив.
+// Массив фиксированного размера хранится прямо в компоненте, поэтому создание корабля
+// не выделяет память в куче.
+// https://stackoverflow.com/questions/57235844/how-to-handle-dynamic-hierarchical-entities-in-ecs
 struct CGuns
 {
-    // Автор entt рекомендует использовать std::array, но не будем усложнять код
-    // https://stackoverflow.com/questions/57235844/how-to-handle-dynamic-hierarchical-entities-in-ecs
-    vector<Gun> guns;
+    // Больше пушек нет ни у одного корабля
+    static constexpr u32 max_guns = 2;
+
+    array<Gun, max_guns> items{};
+    u32 count = 0;
+
+    CGuns() = default;
+
+    // Число пушек проверяется при компиляции
+    template<typename... Guns>
+        requires (is_same_v<Guns, Gun> && ...)
+    CGuns(const Guns&... guns)
+        : items{guns...}
+        , count(sizeof...(Guns))
+    {
+        static_assert(sizeof...(Guns) <= max_guns, "Слишком много пушек, нужно увеличить max_guns");
+    }
+
+    Gun* begin() { return items.data(); }
+    Gun* end() { return items.data() + count; }
 };
 
 // ===================== Системы =====================
 
-void s_player_shoot(u64 ns);
-void s_fighters_shoot(u64 ns);
-void s_gunships_shoot(u64 ns);
+// Снаряды создаются через commands
+void s_player_shoot(u64 ns, CommandBuffer& commands);
+void s_fighters_shoot(u64 ns, CommandBuffer& commands);
+void s_gunships_shoot(u64 ns, CommandBuffer& commands);
@@ -5,14 +5,21 @@
 #include <dviglo/gl_utils/texture_cache.hpp>
 
 
-Global::Global()
+Global::Global(bool headless)
+    : headless_(headless)
 {
     reg_ = make_unique<registry>();
-    sprite_batch_ = make_unique<SpriteBatch>();
+    spatial_hash_ = make_unique<SpatialHash>(64.f);
+    scheduler_ = make_unique<SystemScheduler>();
 
-    StrUtf8 base_path = get_base_path();
-    spritesheet_ = DV_TEXTURE_CACHE->get(base_path + "letalka_data/textures/spritesheet.png");
-    r_20_font_ = make_unique<SpriteFont>(SFSettingsSimple(base_path + "engine_test_data/fonts/ubuntu/Ubuntu-R.ttf", 20));
+    if (!headless_)
+    {
+        sprite_batch_ = make_unique<SpriteBatch>();
+
+        StrUtf8 base_path = get_base_path();
+        spritesheet_ = DV_TEXTURE_CACHE->get(base_path + "letalka_data/textures/spritesheet.png");
+        r_20_font_ = make_unique<SpriteFont>(SFSettingsSimple(base_path + "engine_test_data/fonts/ubuntu/Ubuntu-R.ttf", 20));
+    }
 
     instance_ = this;
     DV_LOG->write_debug("Global constructed");
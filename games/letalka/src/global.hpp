@@ -1,7 +1,11 @@
 #pragma once
 
 #include <dviglo/common/primitive_types.hpp>
+#include <dviglo/debug/profiler.hpp>
 #include <dviglo/graphics/sprite_batch.hpp>
+#include <dviglo/graphics/sprite_command_list.hpp>
+#include <dviglo/math/spatial_hash.hpp>
+#include <dviglo/threading/system_scheduler.hpp>
 #include <entt/entt.hpp>
 #include <glm/glm.hpp>
 
@@ -21,6 +25,11 @@ private:
     unique_ptr<SpriteFont> r_20_font_;
     shared_ptr<Texture> spritesheet_;
     unique_ptr<registry> reg_;
+    unique_ptr<SpatialHash> spatial_hash_;
+    unique_ptr<SystemScheduler> scheduler_;
+
+    // Без OpenGL-контекста (только симуляция)
+    bool headless_;
 
 public:
     static Global* instance() { return instance_; }
@@ -31,12 +40,43 @@ public:
     // Рисовать ли коллайдеры объектов
     bool debug_draw = false;
 
+    // Нажата ли кнопка стрельбы. Обновляется в главном потоке перед апдейтом,
+    // так как системы могут выполняться в других потоках
+    bool fire_button = false;
+
+    // Видимые спрайты текущего кадра. Заполняются системами рендеринга (см. extract_sprite())
+    // и отправляются в SpriteBatch одним вызовом
+    vector<SpriteInstance> sprites;
+    SpriteCommandList sprite_list;
+
+    // Текстурные координаты последнего спрайта, добавленного в extract_sprite().
+    // Зависят и от спрайтшита: при горячей перезагрузке у него может измениться размер
+    struct LastSpriteUv
+    {
+        Rect source = Rect::zero;
+        const Texture* texture = nullptr;
+        u32 texture_revision = 0;
+        Rect uv = Rect::zero;
+    };
+
+    LastSpriteUv last_sprite_uv;
+
+    bool headless() const { return headless_; }
+
+    // В режиме headless ресурсы для рендеринга не создаются и равны nullptr
     SpriteBatch* sprite_batch() const { return sprite_batch_.get(); }
     SpriteFont* r_20_font() const { return r_20_font_.get(); }
     Texture* spritesheet() const { return spritesheet_.get(); }
     registry* reg() const { return reg_.get(); }
 
-    Global();
+    // Широкая фаза поиска столкновений. Обновляется в s_check_collisions()
+    SpatialHash* spatial_hash() const { return spatial_hash_.get(); }
+
+    // Системы апдейта. Заполняется в ecs_start()
+    SystemScheduler* scheduler() const { return scheduler_.get(); }
+
+    // headless - только симуляция, без рендеринга (не требует окна и OpenGL-контекста)
+    Global(bool headless = false);
     ~Global();
 };
 
@@ -0,0 +1,246 @@
+// Copyright (c) the Dviglo project
+// License: MIT
+
+/*
+
+Бенчмарк BigInt: время операций для разных длин чисел.
+Нужен, чтобы оценивать изменения в алгоритмах и подбирать пороги BigInt::mul_thresholds и BigInt::div_thresholds.
+
+Параметры командной строки:
+-format csv|json - формат вывода (по умолчанию csv)
+-max_size x - максимальная длина чисел в цифрах Digit (по умолчанию 100000)
+-min_time x - минимальное время измерения каждой операции в миллисекундах (по умолчанию 100)
+-seed x - seed для BigInt::generate() (по умолчанию 1)
+
+Для деления и остатка числитель в 2 раза длиннее знаменателя.
+Если при сборке найдена библиотека GMP, то те же операции измеряются и в ней (столбец gmp_ns_per_op).
+
+*/
+
+#include <dv_big_int.hpp>
+
+#if DV_BIG_INT_BENCHMARK_GMP
+    #include <gmp.h>
+#endif
+
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace dviglo;
+using namespace std;
+
+
+struct Params
+{
+    string format = "csv";
+    size_t max_size = 100'000;
+    double min_time_ms = 100.0;
+    uint32_t seed = 1;
+};
+
+static bool parse_params(int argc, char* argv[], Params& params)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        if (i + 1 >= argc)
+            return false;
+
+        string name = argv[i];
+        string value = argv[++i];
+
+        if (name == "-format" && (value == "csv" || value == "json"))
+            params.format = value;
+        else if (name == "-max_size")
+            params.max_size = stoull(value);
+        else if (name == "-min_time")
+            params.min_time_ms = stod(value);
+        else if (name == "-seed")
+            params.seed = (uint32_t)stoul(value);
+        else
+            return false;
+    }
+
+    return true;
+}
+
+// Повторяет func, пока суммарное время не превысит min_time_ms. Возвращает наносекунды на один вызов
+static double measure(const function<void()>& func, double min_time_ms)
+{
+    // Прогрев (и заодно оценка времени одного вызова)
+    auto begin_time = chrono::steady_clock::now();
+    func();
+    double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - begin_time).count();
+
+    const double min_time_ns = min_time_ms * 1'000'000.0;
+
+    if (ns >= min_time_ns)
+        return ns;
+
+    size_t repeats = 1;
+
+    while (true)
+    {
+        // Число повторов с запасом, чтобы обычно хватало одного замера
+        repeats = max(repeats * 2, (size_t)(min_time_ns * 1.2 / max(ns / repeats, 1.0)));
+
+        begin_time = chrono::steady_clock::now();
+
+        for (size_t i = 0; i < repeats; ++i)
+            func();
+
+        ns = chrono::duration<double, nano>(chrono::steady_clock::now() - begin_time).count();
+
+        if (ns >= min_time_ns)
+            return ns / repeats;
+    }
+}
+
+class Output
+{
+private:
+    string format_;
+    bool first_ = true;
+
+public:
+    Output(const string& format, uint32_t seed, bool has_reference)
+        : format_(format)
+    {
+        if (format_ == "csv")
+        {
+            cout << "operation,size,ns_per_op,limbs_per_sec,gmp_ns_per_op" << endl;
+        }
+        else
+        {
+            cout << "{\n  \"seed\": " << seed << ",\n  \"base\": " << BigInt::base
+                 << ",\n  \"reference\": " << (has_reference ? "\"gmp\"" : "null") << ",\n  \"results\": [";
+        }
+    }
+
+    ~Output()
+    {
+        if (format_ == "json")
+            cout << "\n  ]\n}" << endl;
+    }
+
+    // reference_ns < 0, если библиотеки для сравнения нет
+    void write(const char* operation, size_t size, double ns, double reference_ns)
+    {
+        double limbs_per_sec = size / ns * 1'000'000'000.0;
+
+        if (format_ == "csv")
+        {
+            cout << operation << ',' << size << ',' << ns << ',' << limbs_per_sec << ',';
+
+            if (reference_ns >= 0)
+                cout << reference_ns;
+
+            cout << endl;
+        }
+        else
+        {
+            cout << (first_ ? "\n" : ",\n") << "    {\"operation\": \"" << operation << "\", \"size\": " << size
+                 << ", \"ns_per_op\": " << ns << ", \"limbs_per_sec\": " << limbs_per_sec << ", \"gmp_ns_per_op\": ";
+
+            if (reference_ns >= 0)
+                cout << reference_ns;
+            else
+                cout << "null";
+
+            cout << '}' << flush;
+        }
+
+        first_ = false;
+    }
+};
+
+#if DV_BIG_INT_BENCHMARK_GMP
+// Обёртка над mpz_t, которая сама освобождает память
+struct Mpz
+{
+    mpz_t value;
+
+    Mpz() { mpz_init(value); }
+    explicit Mpz(const BigInt& bi) { mpz_init_set_str(value, bi.to_string().c_str(), 10); }
+    ~Mpz() { mpz_clear(value); }
+
+    Mpz(const Mpz&) = delete;
+    Mpz& operator=(const Mpz&) = delete;
+};
+#endif
+
+int main(int argc, char* argv[])
+{
+    Params params;
+
+    if (!parse_params(argc, argv, params))
+    {
+        cerr << "Использование: benchmark [-format csv|json] [-max_size x] [-min_time x] [-seed x]" << endl;
+        return 1;
+    }
+
+    BigInt::set_generate_seed(params.seed);
+
+#if DV_BIG_INT_BENCHMARK_GMP
+    constexpr bool has_reference = true;
+#else
+    constexpr bool has_reference = false;
+#endif
+
+    Output output(params.format, params.seed, has_reference);
+
+    const size_t sizes[] = {1, 3, 10, 30, 100, 300, 1000, 3000, 10'000, 30'000, 100'000};
+
+    for (size_t size : sizes)
+    {
+        if (size > params.max_size)
+            break;
+
+        const BigInt a = BigInt::generate(size);
+        const BigInt b = BigInt::generate(size);
+        const BigInt c = BigInt::generate(size * 2); // Числитель для деления
+        const string a_str = a.to_string();
+
+        BigInt result;
+        string str;
+
+        struct Operation
+        {
+            const char* name;
+            function<void()> func;
+            function<void()> reference_func;
+        };
+
+#if DV_BIG_INT_BENCHMARK_GMP
+        Mpz ga(a), gb(b), gc(c), gr;
+        vector<char> buffer(mpz_sizeinbase(ga.value, 10) + 2);
+        #define DV_REFERENCE(code) [&] { code; }
+#else
+        #define DV_REFERENCE(code) nullptr
+#endif
+
+        const Operation operations[] =
+        {
+            {"add", [&] { result = a + b; }, DV_REFERENCE(mpz_add(gr.value, ga.value, gb.value))},
+            {"sub", [&] { result = a - b; }, DV_REFERENCE(mpz_sub(gr.value, ga.value, gb.value))},
+            {"mul", [&] { result = a * b; }, DV_REFERENCE(mpz_mul(gr.value, ga.value, gb.value))},
+            {"div", [&] { result = c / b; }, DV_REFERENCE(mpz_tdiv_q(gr.value, gc.value, gb.value))},
+            {"mod", [&] { result = c % b; }, DV_REFERENCE(mpz_tdiv_r(gr.value, gc.value, gb.value))},
+            {"to_string", [&] { str = a.to_string(); }, DV_REFERENCE(mpz_get_str(buffer.data(), 10, ga.value))},
+            {"parse", [&] { result = BigInt(a_str); }, DV_REFERENCE(mpz_set_str(gr.value, a_str.c_str(), 10))},
+        };
+
+#undef DV_REFERENCE
+
+        for (const Operation& operation : operations)
+        {
+            double ns = measure(operation.func, params.min_time_ms);
+            double reference_ns = operation.reference_func ? measure(operation.reference_func, params.min_time_ms) : -1.0;
+            output.write(operation.name, size, ns, reference_ns);
+        }
+    }
+
+    return 0;
+}
@@ -4,9 +4,15 @@
 #include "dv_big_int.hpp"
 
 #include <algorithm>
+#include <array>
+#include <bit> // endian
 #include <cassert>
-#include <format>
+#include <cctype> // isdigit
+#include <cmath> // sqrt
+#include <cstring> // memcpy
 #include <random>
+#include <tuple> // tie
+#include <vector>
 
 using namespace std;
 
@@ -16,12 +22,13 @@ namespace dviglo
 
 constexpr uint32_t base = BigInt::base;
 using Digit = BigInt::Digit;
+using Magnitude = BigInt::Magnitude;
 
 // Тип удвоенной (double) длины. Умещает квадрат цифры
 using DDigit = uint64_t;
 
 // Определяет, меньше ли первый модуль
-static bool first_is_less(const vector<Digit>& first, const vector<Digit>& second)
+static bool first_is_less(const Magnitude& first, const Magnitude& second)
 {
     // Проверяем, что нет ведущих нулей
     assert(first.size() == 1 || first.back() != 0);
@@ -42,13 +49,13 @@ static bool first_is_less(const vector<Digit>& first, const vector<Digit>& secon
 }
 
 // Складывает модули чисел столбиком
-static vector<Digit> add_magnitudes(const vector<Digit>& a, const vector<Digit>& b)
+static Magnitude add_magnitudes(const Magnitude& a, const Magnitude& b)
 {
     // Выясняем, какой модуль длиннее
-    const vector<Digit>& long_mag = a.size() >= b.size() ? a : b;
-    const vector<Digit>& short_mag = a.size() < b.size() ? a : b;
+    const Magnitude& long_mag = a.size() >= b.size() ? a : b;
+    const Magnitude& short_mag = a.size() < b.size() ? a : b;
 
-    vector<Digit> ret;
+    Magnitude ret;
 
     // Длина результата равна long_mag.size() или long_mag.size() + 1
     ret.reserve(long_mag.size() + 1);
@@ -85,9 +92,9 @@ static vector<Digit> add_magnitudes(const vector<Digit>& a, const vector<Digit>&
 }
 
 // Вычитает модули чисел столбиком. Уменьшаемое minuend должно быть >= вычитаемого subtrahend
-static vector<Digit> sub_magnitudes(const vector<Digit>& minuend, const vector<Digit>& subtrahend)
+static Magnitude sub_magnitudes(const Magnitude& minuend, const Magnitude& subtrahend)
 {
-    vector<Digit> ret;
+    Magnitude ret;
     ret.resize(minuend.size(), 0);
 
     // Заём из следующего столбца
@@ -131,678 +138,2283 @@ static vector<Digit> sub_magnitudes(const vector<Digit>& minuend, const vector<D
     return ret;
 }
 
-// Перемножает модули чисел столбиком.
-// Смотрите "Умножение столбиком и смена base" в туторе
-static vector<Digit> mul_magnitudes(const vector<Digit>& a, const vector<Digit>& b)
-{
-    vector<Digit> ret;
-    ret.resize(a.size() + b.size(), 0);
+// Без угадываний делит модуль длинного числа на цифру (столбиком).
+// Если знаменатель == 0, возвращает {0, 0}
+static pair<Magnitude, Magnitude> div_by_digit(const Magnitude& numerator, Digit denominator);
 
-    for (size_t a_index = 0; a_index < a.size(); ++a_index)
-    {
-        Digit carry = 0;
+// ================================= Умножение =================================
 
-        for (size_t b_index = 0; b_index < b.size(); ++b_index)
-        {
-            size_t ret_index = a_index + b_index;
-            DDigit v = ret[ret_index] + (DDigit)a[a_index] * b[b_index] + carry;
-            assert(v <= (DDigit)base * base - 1);
-            carry = Digit(v / base);
-            assert(carry < base);
-            ret[ret_index] = v % base;
-        }
+BigInt::MulThresholds BigInt::mul_thresholds;
 
-        assert(ret[a_index + b.size()] == 0);
-        ret[a_index + b.size()] = carry;
-    }
+// Функции ниже работают с модулями, заданными указателем и длиной (кусками других модулей).
+// В отличие от Magnitude, такой модуль может быть пустым (равен 0) и содержать ведущие нули.
+// Результат умножения записывается в out длиной a_size + b_size
 
-    // Убираем ведущие нули
-    while (ret.size() > 1 && ret.back() == 0)
-        ret.pop_back();
+// Длина модуля без ведущих нулей
+static size_t trimmed_size(const Digit* mag, size_t size)
+{
+    while (size > 0 && mag[size - 1] == 0)
+        --size;
 
-    return ret;
+    return size;
 }
 
-// Без угадываний делит модуль длинного числа на цифру (столбиком).
-// Если знаменатель == 0, возвращает {0, 0}
-static pair<vector<Digit>, vector<Digit>> div_by_digit(const vector<Digit>& numerator, Digit denominator)
+// Преобразует кусок модуля в Magnitude без ведущих нулей
+static Magnitude to_magnitude(const Digit* mag, size_t size)
 {
-    // Если числитель или знаменатель == 0
-    if (numerator == vector<Digit>{0} || denominator == 0)
-        return {vector<Digit>{0}, vector<Digit>{0}};
+    size = trimmed_size(mag, size);
 
-    // Если числитель меньше знаменателя
-    if (first_is_less(numerator, vector<Digit>{denominator}))
-        return {vector<Digit>{0}, numerator};
+    if (size == 0)
+        return Magnitude{0};
 
-    // Неполное частное
-    vector<Digit> quotient;
-    quotient.reserve(numerator.size());
+    return Magnitude(mag, mag + size);
+}
 
-    // Текущий кусок числителя (и одновременно остаток)
-    DDigit chunk = 0;
+// dst += src (dst_size >= src_size). Возвращает перенос из старшего разряда dst
+static Digit add_to(Digit* dst, size_t dst_size, const Digit* src, size_t src_size)
+{
+    assert(dst_size >= src_size);
 
-    // Извлекаем цифры числителя, начиная с конца (со старших разрядов)
-    for (size_t i = numerator.size() - 1; i != size_t(-1); --i)
+    Digit carry = 0;
+
+    for (size_t i = 0; i < src_size; ++i)
     {
-        chunk = chunk * base + numerator[i];
+        Digit sum = dst[i] + src[i] + carry;
+        carry = sum >= base;
+        dst[i] = carry ? sum - base : sum;
+    }
 
-        // Делим кусок на знаменатель и получаем очередную цифру результата
-        assert(chunk / denominator < base);
-        Digit digit = Digit(chunk / denominator);
+    for (size_t i = src_size; carry && i < dst_size; ++i)
+    {
+        Digit sum = dst[i] + carry;
+        carry = sum >= base;
+        dst[i] = carry ? sum - base : sum;
+    }
 
-        // Добавляем цифру к результату
-        quotient.push_back(digit);
+    return carry;
+}
 
-        // chunk %= denominator
-        chunk -= (DDigit)digit * denominator;
-        assert(chunk < base);
-    }
+// dst -= src. Результат не должен быть отрицательным
+static void sub_from(Digit* dst, size_t dst_size, const Digit* src, size_t src_size)
+{
+    src_size = trimmed_size(src, src_size);
+    assert(dst_size >= src_size);
 
-    // Мы добавляли цифры в конец вектора, а не в начало, поэтому реверсируем
-    reverse(quotient.begin(), quotient.end());
+    Digit borrow = 0;
 
-    // Убираем ведущие нули
-    while (quotient.size() > 1 && quotient.back() == 0)
-        quotient.pop_back();
+    for (size_t i = 0; i < src_size; ++i)
+    {
+        Digit subtrahend = src[i] + borrow;
+        borrow = dst[i] < subtrahend;
+        dst[i] = dst[i] + base * borrow - subtrahend;
+    }
 
-    return {quotient, {(Digit)chunk}}; // В chunk находится остаток
+    for (size_t i = src_size; borrow && i < dst_size; ++i)
+    {
+        borrow = dst[i] == 0;
+        dst[i] = borrow ? base - 1 : dst[i] - 1;
+    }
+
+    assert(borrow == 0);
 }
 
-#ifndef NDEBUG
-// Отбрасывает младший разряд
-static vector<Digit> div_by_base(const vector<Digit>& magnitude)
+// Умножение столбиком. Смотрите "Умножение столбиком и смена base" в туторе
+static void mul_schoolbook(const Digit* a, size_t a_size, const Digit* b, size_t b_size, Digit* out)
 {
-    if (magnitude.size() == 1) // Модуль < base
-        return vector<Digit>{0};
+    fill(out, out + a_size + b_size, 0);
+
+    for (size_t a_index = 0; a_index < a_size; ++a_index)
+    {
+        DDigit a_digit = a[a_index];
+
+        // Нули в середине чисел встречаются часто (например у степеней 10)
+        if (a_digit == 0)
+            continue;
+
+        Digit carry = 0;
+        Digit* ret = out + a_index;
+
+        for (size_t b_index = 0; b_index < b_size; ++b_index)
+        {
+            DDigit v = ret[b_index] + a_digit * b[b_index] + carry;
+            assert(v <= (DDigit)base * base - 1);
+            carry = Digit(v / base);
+            ret[b_index] = Digit(v - (DDigit)carry * base); // v % base
+        }
 
-    // Отбрасываем цифру слева
-    return vector<Digit>(magnitude.cbegin() + 1, magnitude.cend());
+        assert(ret[b_size] == 0);
+        ret[b_size] = carry;
+    }
 }
-#endif
 
-// Делит кусок числителя на знаменатель.
-// Кусок и знаменатель таковы, что в результате всегда одна цифра.
-// К тому же аргументы должны быть нормализованы (старшая цифра знаменателя >= base / 2)
-static Digit div_chunk(const vector<Digit>& chunk, const vector<Digit>& denominator)
-{
-    if (first_is_less(chunk, denominator))
-        return 0;
+static void mul_dispatch(const Digit* a, size_t a_size, const Digit* b, size_t b_size, Digit* out);
 
-    assert(chunk.size() == denominator.size() // Длина куска равна длине знаменателя
-           || (chunk.size() == denominator.size() + 1 // Или кусок длиннее знаменателя на 1 цифру
-               && first_is_less(div_by_base(chunk), denominator))); // И эта цифра не лишняя
+// Алгоритм Карацубы. Множители разбиваются на половины: a = a1 * base^h + a0, b = b1 * base^h + b0.
+// Тогда a * b = z2 * base^2h + z1 * base^h + z0, где z0 = a0 * b0, z2 = a1 * b1,
+// z1 = (a0 + a1) * (b0 + b1) - z0 - z2. То есть три умножения половин вместо четырёх.
+// Длины множителей должны быть близки: a_size >= b_size > a_size / 2
+static void mul_karatsuba(const Digit* a, size_t a_size, const Digit* b, size_t b_size, Digit* out)
+{
+    assert(a_size >= b_size && b_size * 2 > a_size);
 
-    // Когда в знаменателе одна цифра, используется div_by_digit()
-    assert(denominator.size() >= 2);
+    size_t h = (a_size + 1) / 2;
+    assert(b_size >= h);
 
-    // Старшая цифра знаменателя
-    DDigit denominator_digit_1 = denominator.back();
+    const Digit* a0 = a;
+    const Digit* a1 = a + h;
+    size_t a1_size = a_size - h;
 
-    // Должно быть нормализовано
-    assert(denominator_digit_1 >= base / 2);
+    const Digit* b0 = b;
+    const Digit* b1 = b + h;
+    size_t b1_size = b_size - h;
 
-    // Две старшие цифры куска.
-    // Если длина куска равна длине знаменателя, то старшая цифра будет 0
-    DDigit chunk_2_digits = chunk.back();
-    if (chunk.size() != denominator.size())
-        chunk_2_digits = chunk_2_digits * base + chunk[chunk.size() - 2];
+    // z0 и z2 записываем сразу на свои места в out (они не пересекаются)
+    mul_dispatch(a0, h, b0, h, out);
+    mul_dispatch(a1, a1_size, b1, b1_size, out + h * 2);
 
-    // Третья цифра куска
-    DDigit chunk_digit_3 = (chunk.size() == denominator.size())
-        ? chunk[chunk.size() - 2] // Старшая цифра куска = 0, но её нет в массиве
-        : chunk[chunk.size() - 3];
+    // Суммы половин (на одну цифру длиннее из-за переноса)
+    Magnitude a_sum(a0, a0 + h);
+    a_sum.push_back(add_to(a_sum.data(), h, a1, a1_size));
+    Magnitude b_sum(b0, b0 + h);
+    b_sum.push_back(add_to(b_sum.data(), h, b1, b1_size));
 
-    // Вторая цифра знаменателя
-    DDigit denominator_digit_2 = denominator[denominator.size() - 2];
+    Magnitude z1(a_sum.size() + b_sum.size());
+    mul_dispatch(a_sum.data(), a_sum.size(), b_sum.data(), b_sum.size(), z1.data());
 
-    // Делим две старшие цифры куска на старшую цифру знаменателя
-    DDigit digit = chunk_2_digits / denominator_digit_1;
+    sub_from(z1.data(), z1.size(), out, h * 2); // z0
+    sub_from(z1.data(), z1.size(), out + h * 2, a1_size + b1_size); // z2
 
-    // Остаток
-    DDigit remainder = chunk_2_digits - digit * denominator_digit_1; // chunk_2_digits % denominator_digit_1
+    Digit carry = add_to(out + h, a_size + b_size - h, z1.data(), trimmed_size(z1.data(), z1.size()));
+    assert(carry == 0);
+    (void)carry;
+}
 
-    // Уменьшаем цифру, если она точно слишком большая
-    if (digit == base || digit * denominator_digit_2 > remainder * base + chunk_digit_3)
-    {
-        --digit;
-        remainder += denominator_digit_1;
+// Модуль со знаком для промежуточных значений в алгоритме Тоома-Кука
+struct SignedMagnitude
+{
+    bool negative = false;
+    Magnitude mag{0};
+};
 
-        if (remainder < base && (digit == base || digit * denominator_digit_2 > remainder * base + chunk_digit_3))
-        {
-            --digit;
+static SignedMagnitude signed_add(const SignedMagnitude& a, const SignedMagnitude& b)
+{
+    SignedMagnitude ret;
 
-#ifndef NDEBUG
-            remainder += denominator_digit_1;
-#endif
-        }
+    if (a.negative == b.negative)
+    {
+        ret.negative = a.negative;
+        ret.mag = add_magnitudes(a.mag, b.mag);
+    }
+    else if (first_is_less(a.mag, b.mag))
+    {
+        ret.negative = b.negative;
+        ret.mag = sub_magnitudes(b.mag, a.mag);
+    }
+    else
+    {
+        ret.negative = a.negative;
+        ret.mag = sub_magnitudes(a.mag, b.mag);
     }
 
-    assert(digit < base);
-    assert(digit * denominator_digit_2 <= remainder * base + chunk_digit_3);
+    // Ноль всегда положительный
+    if (ret.mag.size() == 1 && ret.mag[0] == 0)
+        ret.negative = false;
 
-    // Теперь проверяем, нет ли промаха на 1
-    if (first_is_less(chunk, mul_magnitudes(vector<Digit>{(Digit)digit}, denominator)))
-        --digit;
+    return ret;
+}
 
-    assert(!first_is_less(chunk, mul_magnitudes(vector<Digit>{(Digit)digit}, denominator)));
+static SignedMagnitude signed_sub(const SignedMagnitude& a, SignedMagnitude b)
+{
+    if (b.mag.size() > 1 || b.mag[0] != 0)
+        b.negative = !b.negative;
 
-    return (Digit)digit;
+    return signed_add(a, b);
 }
 
-// Возвращает неполное частное и остаток (делит столбиком).
-// Если знаменатель == 0, возвращает {0, 0}
-static pair<vector<Digit>, vector<Digit>> div_mod_magnitudes(const vector<Digit>& numerator, const vector<Digit>& denominator)
+// Умножает на цифру
+static SignedMagnitude signed_mul(const SignedMagnitude& a, Digit digit)
 {
-    // Если в знаменателе одна цифра
-    if (denominator.size() == 1)
-        return div_by_digit(numerator, denominator[0]);
+    SignedMagnitude ret;
+    ret.negative = a.negative;
+    ret.mag.resize(a.mag.size() + 1);
+    mul_schoolbook(a.mag.data(), a.mag.size(), &digit, 1, ret.mag.data());
 
-    // Если числитель или знаменатель == 0
-    if (numerator == vector<Digit>{0} || denominator == vector<Digit>{0})
-        return {vector<Digit>{0}, vector<Digit>{0}};
+    while (ret.mag.size() > 1 && ret.mag.back() == 0)
+        ret.mag.pop_back();
 
-    // Если числитель меньше знаменателя
-    if (first_is_less(numerator, denominator))
-        return {vector<Digit>{0}, numerator};
+    return ret;
+}
 
-    // Нормализующий множитель
-    Digit scale = base / (denominator.back() + 1);
-    assert(scale <= base / 2); // Старшая цифра denominator не может быть 0, т.е. минимум 1
+// Делит на цифру без остатка
+static SignedMagnitude signed_exact_div(const SignedMagnitude& a, Digit digit)
+{
+    pair<Magnitude, Magnitude> dm = div_by_digit(a.mag, digit);
+    assert(dm.second == Magnitude{0});
 
-    // Нормализованный числитель
-    vector<Digit> norm_numerator = (scale == 1)
-        ? numerator
-        : mul_magnitudes(vector<Digit>{scale}, numerator);
+    SignedMagnitude ret;
+    ret.negative = a.negative;
+    ret.mag = std::move(dm.first);
+    return ret;
+}
 
-    // Нормализованный знаменатель
-    vector<Digit> norm_denominator = (scale == 1)
-        ? denominator
-        : mul_magnitudes(vector<Digit>{scale}, denominator);
+static SignedMagnitude signed_mul(const SignedMagnitude& a, const SignedMagnitude& b)
+{
+    SignedMagnitude ret;
+    ret.mag.resize(a.mag.size() + b.mag.size());
+    mul_dispatch(a.mag.data(), a.mag.size(), b.mag.data(), b.mag.size(), ret.mag.data());
 
-    // Неполное частное
-    vector<Digit> quotient;
-    quotient.reserve(norm_numerator.size() - norm_denominator.size() + 1);
+    while (ret.mag.size() > 1 && ret.mag.back() == 0)
+        ret.mag.pop_back();
 
-    // Текущий кусок числителя (и одновременно остаток)
-    vector<Digit> chunk;
-    quotient.reserve(norm_denominator.size() + 1);
+    ret.negative = (a.negative != b.negative) && !(ret.mag.size() == 1 && ret.mag[0] == 0);
+    return ret;
+}
 
-    // Копируем цифры числителя, начиная с конца (со старших разрядов)
-    for (size_t i = norm_numerator.size() - 1; i != size_t(-1); --i)
-    {
-        // Копируем очередную цифру числителя в начало куска (так как цифры хранятся в обратном порядке)
-        chunk.insert(chunk.begin(), norm_numerator[i]); // chunk = chunk * base + norm_numerator[i]
+// Алгоритм Тоома-Кука (Toom-3). Множители разбиваются на три части и рассматриваются
+// как многочлены второй степени от x = base^k. Многочлен-произведение четвёртой степени
+// восстанавливается по значениям в точках 0, 1, -1, -2, ∞ (последовательность Бодрато).
+// То есть пять умножений третей вместо девяти.
+// Длины множителей должны быть близки: a_size >= b_size > a_size / 2
+static void mul_toom3(const Digit* a, size_t a_size, const Digit* b, size_t b_size, Digit* out)
+{
+    assert(a_size >= b_size && b_size * 2 > a_size);
 
-        // Убираем ведущие нули (когда chunk поделился без остатка и стал равен 0, а потом добавили 0)
-        while (chunk.size() > 1 && chunk.back() == 0)
-            chunk.pop_back();
+    size_t k = (a_size + 2) / 3;
 
-        // Делим кусок на знаменатель и получаем очередную цифру результата
-        Digit digit = div_chunk(chunk, norm_denominator);
+    auto split = [k](const Digit* mag, size_t size, SignedMagnitude parts[3])
+    {
+        for (size_t i = 0; i < 3; ++i)
+        {
+            size_t begin = min(i * k, size);
+            size_t end = min(begin + k, size);
+            parts[i].mag = to_magnitude(mag + begin, end - begin);
+        }
+    };
 
-        // Добавляем цифру к результату
-        quotient.push_back(digit);
+    SignedMagnitude a_parts[3];
+    SignedMagnitude b_parts[3];
+    split(a, a_size, a_parts);
+    split(b, b_size, b_parts);
 
-        // кусок -= цифра * знаменатель ⇔ кусок %= знаменатель
-        chunk = sub_magnitudes(chunk, mul_magnitudes(vector<Digit>{digit}, norm_denominator));
-    }
+    // Значения многочленов в точках 0, 1, -1, -2, ∞
+    auto evaluate = [](const SignedMagnitude parts[3], SignedMagnitude values[5])
+    {
+        SignedMagnitude sum_02 = signed_add(parts[0], parts[2]);
+        values[0] = parts[0];
+        values[1] = signed_add(sum_02, parts[1]);
+        values[2] = signed_sub(sum_02, parts[1]);
+        values[3] = signed_sub(signed_mul(signed_add(values[2], parts[2]), 2), parts[0]);
+        values[4] = parts[2];
+    };
+
+    SignedMagnitude a_values[5];
+    SignedMagnitude b_values[5];
+    evaluate(a_parts, a_values);
+    evaluate(b_parts, b_values);
+
+    SignedMagnitude r[5];
+    for (size_t i = 0; i < 5; ++i)
+        r[i] = signed_mul(a_values[i], b_values[i]);
+
+    // Интерполяция. Все деления точные
+    SignedMagnitude r0 = r[0];
+    SignedMagnitude r4 = r[4];
+    SignedMagnitude r3 = signed_exact_div(signed_sub(r[3], r[1]), 3);
+    SignedMagnitude r1 = signed_exact_div(signed_sub(r[1], r[2]), 2);
+    SignedMagnitude r2 = signed_sub(r[2], r[0]);
+    r3 = signed_add(signed_exact_div(signed_sub(r2, r3), 2), signed_mul(r4, 2));
+    r2 = signed_sub(signed_add(r2, r1), r4);
+    r1 = signed_sub(r1, r3);
+
+    // Коэффициенты произведения неотрицательны. Складываем их со сдвигами
+    fill(out, out + a_size + b_size, 0);
+    const SignedMagnitude* coefs[5] = {&r0, &r1, &r2, &r3, &r4};
+
+    for (size_t i = 0; i < 5; ++i)
+    {
+        const Magnitude& mag = coefs[i]->mag;
+        assert(!coefs[i]->negative);
 
-    // Мы добавляли цифры в конец вектора, а не в начало, поэтому реверсируем
-    reverse(quotient.begin(), quotient.end());
+        size_t offset = i * k;
+        size_t size = trimmed_size(mag.data(), mag.size());
 
-    // Убираем ведущие нули
-    while (quotient.size() > 1 && quotient.back() == 0)
-        quotient.pop_back();
+        if (size == 0)
+            continue;
 
-    // Денормализуем остаток
-    if (scale != 1)
-    {
-        pair<vector<Digit>, vector<Digit>> denorm_chunk = div_by_digit(chunk, scale);
-        assert(denorm_chunk.second == vector<Digit>{0}); // Должно поделиться без остатка
-        chunk = denorm_chunk.first;
+        assert(offset + size <= a_size + b_size);
+        Digit carry = add_to(out + offset, a_size + b_size - offset, mag.data(), size);
+        assert(carry == 0);
+        (void)carry;
     }
-
-    return {quotient, chunk}; // В chunk находится остаток
 }
 
-// Генерирует случайное число из диапазона [min, max] (включительно)
-static uint32_t generate_random(uint32_t min, uint32_t max)
+// 128-битное беззнаковое число для восстановления коэффициентов в NTT.
+// Не используем unsigned __int128, так как его нет в MSVC
+struct UInt128
 {
-    // Используем random_device только для генерации seed, так как он медленный
-    static random_device device;
-    static uint32_t random_seed = device();
-    static mt19937 generator(random_seed);
+    uint64_t hi;
+    uint64_t lo;
+};
 
-    uniform_int_distribution<uint32_t> dist(min, max);
-    return dist(generator);
-}
-
-BigInt BigInt::generate(size_t length)
+static UInt128 mul_64(uint64_t a, uint64_t b)
 {
-    vector<BigInt::Digit> magnitude(length);
+    uint64_t a_lo = (uint32_t)a;
+    uint64_t a_hi = a >> 32;
+    uint64_t b_lo = (uint32_t)b;
+    uint64_t b_hi = b >> 32;
 
-    // Старший разряд не должен быть 0
-    magnitude[length - 1] = generate_random(1, BigInt::base - 1);
-
-    // Остальные разряды могут быть 0
-    for (size_t i = 0; i < length - 1; ++i)
-        magnitude[i] = generate_random(0, BigInt::base - 1);
+    uint64_t p0 = a_lo * b_lo;
+    uint64_t p1 = a_lo * b_hi;
+    uint64_t p2 = a_hi * b_lo;
+    uint64_t p3 = a_hi * b_hi;
 
-    BigInt ret;
-    ret.positive_ = true;
-    ret.magnitude_ = magnitude;
+    uint64_t middle = (p0 >> 32) + (uint32_t)p1 + (uint32_t)p2;
 
+    UInt128 ret;
+    ret.lo = (middle << 32) | (uint32_t)p0;
+    ret.hi = p3 + (p1 >> 32) + (p2 >> 32) + (middle >> 32);
     return ret;
 }
 
-BigInt::BigInt()
+static void add_to(UInt128& value, UInt128 addend)
 {
-    positive_ = true;
-    magnitude_.push_back(0);
+    value.lo += addend.lo;
+    value.hi += addend.hi + (value.lo < addend.lo);
 }
 
-BigInt::BigInt(int32_t value)
+// value /= divisor. Возвращает остаток
+static uint32_t div_mod(UInt128& value, uint32_t divisor)
 {
-    positive_ = (value >= 0);
-
-    // Сперва преобразуем в int64_t, чтобы не было UB в std::abs(-2147483648)
-    uint64_t val = (uint64_t)std::abs((int64_t)value);
+    uint32_t words[4] = {uint32_t(value.hi >> 32), (uint32_t)value.hi, uint32_t(value.lo >> 32), (uint32_t)value.lo};
+    uint64_t remainder = 0;
 
-    while (val != 0)
+    // Делим столбиком по 32-битным словам, начиная со старшего
+    for (uint32_t& word : words)
     {
-        Digit mod = val % base;
-        magnitude_.push_back(mod);
-        val /= base;
+        uint64_t chunk = (remainder << 32) | word;
+        word = uint32_t(chunk / divisor);
+        remainder = chunk % divisor;
     }
 
-    if (!magnitude_.size()) // value == 0
-        magnitude_.push_back(0);
+    value.hi = ((uint64_t)words[0] << 32) | words[1];
+    value.lo = ((uint64_t)words[2] << 32) | words[3];
+
+    return (uint32_t)remainder;
 }
 
-BigInt::BigInt(uint32_t value)
+// Простое число вида c * 2^k + 1
+struct NttPrime
 {
-    positive_ = true;
+    uint32_t mod;
 
-    while (value != 0)
+    // Первообразный корень
+    uint32_t root;
+};
+
+// Произведение трёх простых больше 2^86, что вмещает коэффициенты свёртки
+// (ntt_max_size * (base - 1)^2 < 2^83 для base = 10^9)
+constexpr NttPrime ntt_primes[3] = {{998'244'353, 3}, {167'772'161, 3}, {469'762'049, 3}};
+
+// Максимальная длина преобразования (998'244'353 = 119 * 2^23 + 1)
+constexpr size_t ntt_max_size = size_t(1) << 23;
+
+static uint32_t pow_mod(uint64_t value, uint64_t exponent, uint32_t mod)
+{
+    uint64_t ret = 1;
+    value %= mod;
+
+    while (exponent)
     {
-        Digit mod = value % base;
-        magnitude_.push_back(mod);
-        value /= base;
+        if (exponent & 1)
+            ret = ret * value % mod;
+
+        value = value * value % mod;
+        exponent >>= 1;
     }
 
-    if (!magnitude_.size()) // value == 0
-        magnitude_.push_back(0);
+    return (uint32_t)ret;
 }
 
-// Обходит undefined behavior в std::abs()
-static uint64_t fixed_abs(int64_t value)
+// Теоретико-числовое преобразование Фурье на месте. Длина - степень двойки
+static void ntt(vector<uint32_t>& values, bool inverse, const NttPrime& prime)
 {
-    static_assert(is_same_v<int64_t, decltype(-9223372036854775807 - 1)>
-        && is_same_v<uint64_t, decltype(9223372036854775808u)>);
+    const size_t size = values.size();
+    const uint64_t mod = prime.mod;
 
-    if (value == -9223372036854775807 - 1)
-        return 9223372036854775808u;
-    else
-        return (uint64_t)std::abs(value);
-}
+    // Перестановка с обращением битов индекса
+    for (size_t i = 1, j = 0; i < size; ++i)
+    {
+        size_t bit = size >> 1;
 
-BigInt::BigInt(int64_t value)
-{
-    positive_ = (value >= 0);
+        for (; j & bit; bit >>= 1)
+            j ^= bit;
 
-    uint64_t val = fixed_abs(value);
+        j ^= bit;
 
-    while (val != 0)
+        if (i < j)
+            swap(values[i], values[j]);
+    }
+
+    // Степени корня для текущего уровня, чтобы не вычислять их во внутреннем цикле
+    vector<uint32_t> roots(size / 2);
+
+    for (size_t length = 2; length <= size; length <<= 1)
     {
-        Digit mod = val % base;
-        magnitude_.push_back(mod);
-        val /= base;
+        uint32_t root = pow_mod(prime.root, (mod - 1) / length, prime.mod);
+
+        if (inverse)
+            root = pow_mod(root, mod - 2, prime.mod);
+
+        size_t half = length / 2;
+        roots[0] = 1;
+
+        for (size_t i = 1; i < half; ++i)
+            roots[i] = uint32_t((uint64_t)roots[i - 1] * root % mod);
+
+        for (size_t i = 0; i < size; i += length)
+        {
+            for (size_t j = 0; j < half; ++j)
+            {
+                uint32_t u = values[i + j];
+                uint32_t v = uint32_t((uint64_t)values[i + j + half] * roots[j] % mod);
+                values[i + j] = u + v < mod ? u + v : uint32_t(u + v - mod);
+                values[i + j + half] = u >= v ? u - v : uint32_t(u + mod - v);
+            }
+        }
     }
 
-    if (!magnitude_.size()) // value == 0
-        magnitude_.push_back(0);
+    if (inverse)
+    {
+        uint64_t size_inv = pow_mod(size, mod - 2, prime.mod);
+
+        for (uint32_t& value : values)
+            value = uint32_t(value * size_inv % mod);
+    }
 }
 
-BigInt::BigInt(uint64_t value)
+// Свёртка модулей по модулю простого числа
+static vector<uint32_t> ntt_convolution(const Digit* a, size_t a_size, const Digit* b, size_t b_size,
+                                        size_t size, const NttPrime& prime)
 {
-    positive_ = true;
+    vector<uint32_t> fa(size, 0);
 
-    while (value != 0)
+    for (size_t i = 0; i < a_size; ++i)
+        fa[i] = a[i] % prime.mod;
+
+    ntt(fa, false, prime);
+
+    // При возведении в квадрат второе преобразование не нужно
+    if (a == b && a_size == b_size)
     {
-        Digit mod = (Digit)(value % base);
-        magnitude_.push_back(mod);
-        value /= base;
+        for (uint32_t& value : fa)
+            value = uint32_t((uint64_t)value * value % prime.mod);
     }
+    else
+    {
+        vector<uint32_t> fb(size, 0);
 
-    if (!magnitude_.size()) // value == 0
-        magnitude_.push_back(0);
+        for (size_t i = 0; i < b_size; ++i)
+            fb[i] = b[i] % prime.mod;
+
+        ntt(fb, false, prime);
+
+        for (size_t i = 0; i < size; ++i)
+            fa[i] = uint32_t((uint64_t)fa[i] * fb[i] % prime.mod);
+    }
+
+    ntt(fa, true, prime);
+
+    return fa;
 }
 
-static uint32_t to_uint32_t(const string& chunk)
+// Умножение через NTT по трём простым модулям. Коэффициенты свёртки восстанавливаются
+// по остаткам с помощью китайской теоремы об остатках (алгоритм Гарнера)
+static void mul_ntt(const Digit* a, size_t a_size, const Digit* b, size_t b_size, Digit* out)
 {
-    unsigned long long val = stoull(chunk);
-    assert(val <= base);
-    return (uint32_t)val;
+    size_t size = 1;
+    while (size < a_size + b_size - 1)
+        size <<= 1;
+
+    assert(size <= ntt_max_size);
+
+    vector<uint32_t> r[3];
+    for (size_t i = 0; i < 3; ++i)
+        r[i] = ntt_convolution(a, a_size, b, b_size, size, ntt_primes[i]);
+
+    constexpr uint64_t m0 = ntt_primes[0].mod;
+    constexpr uint64_t m1 = ntt_primes[1].mod;
+    constexpr uint64_t m2 = ntt_primes[2].mod;
+    static const uint64_t m0_inv_m1 = pow_mod(m0, m1 - 2, (uint32_t)m1);
+    static const uint64_t m0_m1_inv_m2 = pow_mod(m0 * m1 % m2, m2 - 2, (uint32_t)m2);
+
+    UInt128 carry{0, 0};
+
+    for (size_t i = 0; i < a_size + b_size; ++i)
+    {
+        if (i < a_size + b_size - 1)
+        {
+            // x = v0 + v1 * m0 + v2 * m0 * m1
+            uint64_t v0 = r[0][i];
+            uint64_t v1 = (r[1][i] + m1 - v0 % m1) % m1 * m0_inv_m1 % m1;
+            uint64_t v2 = (r[2][i] + m2 - v0 % m2) % m2;
+            v2 = (v2 + m2 - m0 % m2 * v1 % m2) % m2 * m0_m1_inv_m2 % m2;
+
+            add_to(carry, UInt128{0, v0 + v1 * m0});
+            add_to(carry, mul_64(m0 * m1, v2));
+        }
+
+        out[i] = div_mod(carry, base);
+    }
+
+    assert(carry.hi == 0 && carry.lo == 0);
 }
 
-BigInt::BigInt(const string& str)
+// Выбирает алгоритм умножения по длинам множителей
+static void mul_dispatch(const Digit* a, size_t a_size, const Digit* b, size_t b_size, Digit* out)
 {
-    if (str.empty())
+    size_t out_size = a_size + b_size;
+
+    // Ведущие нули у кусков модулей встречаются часто
+    a_size = trimmed_size(a, a_size);
+    b_size = trimmed_size(b, b_size);
+
+    if (a_size < b_size)
     {
-        // Инцициализируем нулём
-        positive_ = true;
-        magnitude_.push_back(0);
-        return;
+        swap(a, b);
+        swap(a_size, b_size);
     }
 
-    size_t first_digit_pos;
+    fill(out + a_size + b_size, out + out_size, 0);
 
-    if (str[0] == '-')
+    if (b_size == 0)
     {
-        positive_ = false;
-        first_digit_pos = 1;
+        fill(out, out + a_size, 0);
+        return;
     }
-    else if (str[0] == '+')
+
+    const BigInt::MulThresholds& thresholds = BigInt::mul_thresholds;
+
+    if (b_size < thresholds.karatsuba)
     {
-        positive_ = true;
-        first_digit_pos = 1;
+        mul_schoolbook(a, a_size, b, b_size, out);
+        return;
     }
-    else
+
+    if (b_size >= thresholds.ntt && a_size + b_size - 1 <= ntt_max_size)
     {
-        positive_ = true;
-        first_digit_pos = 0;
+        mul_ntt(a, a_size, b, b_size, out);
+        return;
     }
 
-    // Проверяем, что после знака только цифры
+    // Сильно разные длины: режем длинный множитель на куски длиной с короткий
+    if (b_size * 2 <= a_size)
+    {
+        fill(out, out + a_size + b_size, 0);
+        Magnitude product(b_size * 2);
+
+        for (size_t begin = 0; begin < a_size; begin += b_size)
+        {
+            size_t chunk_size = min(b_size, a_size - begin);
+            mul_dispatch(a + begin, chunk_size, b, b_size, product.data());
+            Digit carry = add_to(out + begin, a_size + b_size - begin, product.data(), chunk_size + b_size);
+            assert(carry == 0);
+            (void)carry;
+        }
+
+        return;
+    }
+
+    if (b_size >= thresholds.toom3)
+        mul_toom3(a, a_size, b, b_size, out);
+    else
+        mul_karatsuba(a, a_size, b, b_size, out);
+}
+
+// Перемножает модули чисел
+static Magnitude mul_magnitudes(const Magnitude& a, const Magnitude& b)
+{
+    Magnitude ret;
+    ret.resize(a.size() + b.size());
+    mul_dispatch(a.data(), a.size(), b.data(), b.size(), ret.data());
+
+    // Убираем ведущие нули
+    while (ret.size() > 1 && ret.back() == 0)
+        ret.pop_back();
+
+    return ret;
+}
+
+// Без угадываний делит модуль длинного числа на цифру (столбиком).
+// Если знаменатель == 0, возвращает {0, 0}
+static pair<Magnitude, Magnitude> div_by_digit(const Magnitude& numerator, Digit denominator)
+{
+    // Если числитель или знаменатель == 0
+    if (numerator == Magnitude{0} || denominator == 0)
+        return {Magnitude{0}, Magnitude{0}};
+
+    // Если числитель меньше знаменателя
+    if (first_is_less(numerator, Magnitude{denominator}))
+        return {Magnitude{0}, numerator};
+
+    // Неполное частное
+    Magnitude quotient;
+    quotient.reserve(numerator.size());
+
+    // Текущий кусок числителя (и одновременно остаток)
+    DDigit chunk = 0;
+
+    // Извлекаем цифры числителя, начиная с конца (со старших разрядов)
+    for (size_t i = numerator.size() - 1; i != size_t(-1); --i)
+    {
+        chunk = chunk * base + numerator[i];
+
+        // Делим кусок на знаменатель и получаем очередную цифру результата
+        assert(chunk / denominator < base);
+        Digit digit = Digit(chunk / denominator);
+
+        // Добавляем цифру к результату
+        quotient.push_back(digit);
+
+        // chunk %= denominator
+        chunk -= (DDigit)digit * denominator;
+        assert(chunk < base);
+    }
+
+    // Мы добавляли цифры в конец вектора, а не в начало, поэтому реверсируем
+    reverse(quotient.begin(), quotient.end());
+
+    // Убираем ведущие нули
+    while (quotient.size() > 1 && quotient.back() == 0)
+        quotient.pop_back();
+
+    return {quotient, {(Digit)chunk}}; // В chunk находится остаток
+}
+
+// ================================= Деление =================================
+
+BigInt::DivThresholds BigInt::div_thresholds;
+
+// Умножает кусок модуля на цифру. Записывает в out size цифр и возвращает перенос из старшего разряда
+static Digit mul_by_digit(const Digit* mag, size_t size, Digit digit, Digit* out)
+{
+    Digit carry = 0;
+
+    for (size_t i = 0; i < size; ++i)
+    {
+        DDigit product = (DDigit)mag[i] * digit + carry;
+        carry = Digit(product / base);
+        out[i] = Digit(product - (DDigit)carry * base);
+    }
+
+    return carry;
+}
+
+// Делит кусок модуля на цифру на месте. Возвращает остаток
+static Digit div_by_digit_in_place(Digit* mag, size_t size, Digit digit)
+{
+    DDigit remainder = 0;
+
+    for (size_t i = size - 1; i != size_t(-1); --i)
+    {
+        DDigit chunk = remainder * base + mag[i];
+        mag[i] = Digit(chunk / digit);
+        remainder = chunk - (DDigit)mag[i] * digit;
+    }
+
+    return (Digit)remainder;
+}
+
+// Алгоритм D Кнута (деление столбиком) без выделения памяти.
+// num - нормализованный числитель длиной den_size + q_size, причём его старшие den_size цифр меньше знаменателя.
+// den - нормализованный знаменатель (старшая цифра >= base / 2) длиной den_size >= 2.
+// В q записывается q_size цифр неполного частного (возможно с ведущими нулями).
+// Остаток остаётся в младших den_size цифрах num, остальные цифры num обнуляются
+static void div_knuth(Digit* num, size_t q_size, const Digit* den, size_t den_size, Digit* q)
+{
+    assert(den_size >= 2);
+    assert(den[den_size - 1] >= base / 2);
+
+    // Две старшие цифры знаменателя
+    const DDigit den_digit_1 = den[den_size - 1];
+    const DDigit den_digit_2 = den[den_size - 2];
+
+    for (size_t j = q_size - 1; j != size_t(-1); --j)
+    {
+        // Текущий кусок числителя длиной den_size + 1 цифр. Он меньше base * den
+        Digit* chunk = num + j;
+
+        // Делим две старшие цифры куска на старшую цифру знаменателя
+        DDigit chunk_2_digits = (DDigit)chunk[den_size] * base + chunk[den_size - 1];
+        DDigit digit = chunk_2_digits / den_digit_1;
+        DDigit remainder = chunk_2_digits - digit * den_digit_1; // chunk_2_digits % den_digit_1
+
+        // Уменьшаем цифру, если она точно слишком большая (максимум 2 раза)
+        while (digit >= base || digit * den_digit_2 > remainder * base + chunk[den_size - 2])
+        {
+            --digit;
+            remainder += den_digit_1;
+
+            if (remainder >= base)
+                break;
+        }
+
+        // chunk -= digit * den
+        Digit carry = 0;
+        Digit borrow = 0;
+
+        for (size_t i = 0; i < den_size; ++i)
+        {
+            DDigit product = digit * den[i] + carry;
+            carry = Digit(product / base);
+            Digit subtrahend = Digit(product - (DDigit)carry * base) + borrow;
+            borrow = chunk[i] < subtrahend;
+            chunk[i] = chunk[i] + base * borrow - subtrahend;
+        }
+
+        Digit subtrahend = carry + borrow;
+
+        if (chunk[den_size] >= subtrahend)
+        {
+            chunk[den_size] -= subtrahend;
+        }
+        else
+        {
+            // Промах на 1 (бывает редко): возвращаем знаменатель обратно.
+            // Перенос из старшего разряда компенсирует заём
+            --digit;
+            [[maybe_unused]] Digit add_carry = add_to(chunk, den_size, den, den_size);
+            assert(chunk[den_size] + add_carry == subtrahend);
+            chunk[den_size] = 0;
+        }
+
+        q[j] = (Digit)digit;
+    }
+}
+
+// Делит столбиком. Если знаменатель == 0, возвращает {0, 0}
+static pair<Magnitude, Magnitude> div_mod_knuth(const Magnitude& numerator, const Magnitude& denominator)
+{
+    // Если в знаменателе одна цифра
+    if (denominator.size() == 1)
+        return div_by_digit(numerator, denominator[0]);
+
+    // Если числитель меньше знаменателя
+    if (first_is_less(numerator, denominator))
+        return {Magnitude{0}, numerator};
+
+    const size_t den_size = denominator.size();
+
+    // Нормализующий множитель
+    Digit scale = base / (denominator.back() + 1);
+    assert(scale <= base / 2); // Старшая цифра denominator не может быть 0, т.е. минимум 1
+
+    // Нормализованный числитель с дополнительной старшей цифрой
+    Magnitude num(numerator.size() + 1);
+    num.back() = mul_by_digit(numerator.data(), numerator.size(), scale, num.data());
+
+    // Нормализованный знаменатель
+    Magnitude den(den_size);
+    [[maybe_unused]] Digit den_carry = mul_by_digit(denominator.data(), den_size, scale, den.data());
+    assert(den_carry == 0);
+
+    // Неполное частное
+    Magnitude quotient(num.size() - den_size);
+    div_knuth(num.data(), quotient.size(), den.data(), den_size, quotient.data());
+
+    // Убираем ведущие нули
+    while (quotient.size() > 1 && quotient.back() == 0)
+        quotient.pop_back();
+
+    // Денормализуем остаток
+    num.resize(den_size);
+    [[maybe_unused]] Digit scale_remainder = div_by_digit_in_place(num.data(), den_size, scale);
+    assert(scale_remainder == 0); // Должно поделиться без остатка
+
+    while (num.size() > 1 && num.back() == 0)
+        num.pop_back();
+
+    return {quotient, num}; // В num находится остаток
+}
+
+// Цифры модуля с номерами [begin, begin + count) без ведущих нулей
+static Magnitude get_digits(const Magnitude& magnitude, size_t begin, size_t count)
+{
+    if (begin >= magnitude.size())
+        return Magnitude{0};
+
+    return to_magnitude(magnitude.data() + begin, min(count, magnitude.size() - begin));
+}
+
+// Умножает модуль на base^count
+static Magnitude shift_digits(const Magnitude& magnitude, size_t count)
+{
+    if (magnitude.size() == 1 && magnitude[0] == 0)
+        return magnitude;
+
+    Magnitude ret(count + magnitude.size(), 0);
+    copy(magnitude.begin(), magnitude.end(), ret.begin() + count);
+    return ret;
+}
+
+static pair<Magnitude, Magnitude> div_3n_2n(const Magnitude& a, const Magnitude& b, size_t half);
+
+// Рекурсивное деление Буркеля — Циглера. Делит a на нормализованный b длиной n цифр.
+// Должно быть a < b * base^n, т.е. частное умещается в n цифр
+static pair<Magnitude, Magnitude> div_2n_1n(const Magnitude& a, const Magnitude& b, size_t n)
+{
+    if (n % 2 != 0 || n < BigInt::div_thresholds.burnikel_ziegler)
+        return div_mod_knuth(a, b);
+
+    size_t half = n / 2;
+
+    // a = [a1 a2 a3 a4], где каждая часть длиной half цифр (a1 - старшая).
+    // Делим [a1 a2 a3] на b, а потом [остаток a4] на b
+    auto [q1, r1] = div_3n_2n(get_digits(a, half, half * 3), b, half);
+    auto [q2, r2] = div_3n_2n(add_magnitudes(shift_digits(r1, half), get_digits(a, 0, half)), b, half);
+
+    return {add_magnitudes(shift_digits(q1, half), q2), r2};
+}
+
+// Делит a = [a1 a2 a3] на нормализованный b = [b1 b2], где каждая часть длиной half цифр.
+// Должно быть a < b * base^half
+static pair<Magnitude, Magnitude> div_3n_2n(const Magnitude& a, const Magnitude& b, size_t half)
+{
+    Magnitude a1 = get_digits(a, half * 2, half);
+    Magnitude a12 = get_digits(a, half, half * 2);
+    Magnitude b1 = get_digits(b, half, half);
+
+    Magnitude quotient;
+    Magnitude remainder;
+
+    // Оцениваем частное делением [a1 a2] на b1
+    if (first_is_less(a1, b1))
+    {
+        tie(quotient, remainder) = div_2n_1n(a12, b1, half);
+    }
+    else
+    {
+        // a1 == b1, тогда частное = base^half - 1, а остаток = [a1 a2] - частное * b1
+        quotient.assign(half, base - 1);
+        remainder = sub_magnitudes(add_magnitudes(a12, b1), shift_digits(b1, half));
+    }
+
+    // Остаток = [остаток a3] - частное * b2
+    Magnitude product = mul_magnitudes(quotient, get_digits(b, 0, half));
+    remainder = add_magnitudes(shift_digits(remainder, half), get_digits(a, 0, half));
+
+    // Оценка больше точного частного максимум на 2
+    while (first_is_less(remainder, product))
+    {
+        quotient = sub_magnitudes(quotient, Magnitude{1});
+        remainder = add_magnitudes(remainder, b);
+    }
+
+    return {quotient, sub_magnitudes(remainder, product)};
+}
+
+// Делит методом Буркеля — Циглера. Числитель не меньше знаменателя, в знаменателе минимум 2 цифры
+static pair<Magnitude, Magnitude> div_mod_burnikel_ziegler(const Magnitude& numerator, const Magnitude& denominator)
+{
+    // Длина блока n = j * 2^k, где j < порога. Тогда рекурсия делит блок пополам до самого порога
+    const size_t threshold = max(BigInt::div_thresholds.burnikel_ziegler, size_t(2));
+    size_t k = 0;
+
+    while (((denominator.size() + (size_t(1) << k) - 1) >> k) >= threshold)
+        ++k;
+
+    size_t block_size = ((denominator.size() + (size_t(1) << k) - 1) >> k) << k;
+
+    // Нормализуем: знаменатель удлиняем до длины блока и делаем старшую цифру >= base / 2
+    size_t shift = block_size - denominator.size();
+    Digit scale = base / (denominator.back() + 1);
+    Magnitude den = shift_digits(mul_magnitudes(denominator, Magnitude{scale}), shift);
+    Magnitude num = shift_digits(mul_magnitudes(numerator, Magnitude{scale}), shift);
+    assert(den.size() == block_size && den.back() >= base / 2);
+
+    // Делим числитель на блоки. Старшая цифра старшего блока равна 0, поэтому блок меньше den
+    size_t num_blocks = max(size_t(2), (num.size() + block_size) / block_size);
+
+    // Делим столбиком, только вместо цифр - блоки
+    Magnitude chunk = get_digits(num, (num_blocks - 2) * block_size, block_size * 2);
+    Magnitude quotient{0};
+    Magnitude remainder;
+
+    for (size_t i = num_blocks - 2; i != size_t(-1); --i)
+    {
+        Magnitude block_quotient;
+        tie(block_quotient, remainder) = div_2n_1n(chunk, den, block_size);
+        quotient = add_magnitudes(shift_digits(quotient, block_size), block_quotient);
+
+        if (i > 0)
+            chunk = add_magnitudes(shift_digits(remainder, block_size), get_digits(num, (i - 1) * block_size, block_size));
+    }
+
+    // Денормализуем остаток
+    pair<Magnitude, Magnitude> denorm_remainder = div_by_digit(get_digits(remainder, shift, remainder.size()), scale);
+    assert(denorm_remainder.second == Magnitude{0}); // Должно поделиться без остатка
+
+    return {quotient, denorm_remainder.first};
+}
+
+// Ниже этой длины обратное число вычисляется делением столбиком
+constexpr size_t reciprocal_threshold = 32;
+
+// Вычисляет floor(base^(2m) / d) для нормализованного d длиной m цифр.
+// Итерация Ньютона x = x + x * (base^(2m) - d * x) / base^(2m) удваивает число верных цифр,
+// поэтому обратное число длиной m получается из обратного числа старшей половины d
+static Magnitude reciprocal(const Magnitude& d)
+{
+    const size_t m = d.size();
+    assert(d.back() >= base / 2);
+
+    const Magnitude one = shift_digits(Magnitude{1}, m * 2);
+
+    if (m <= reciprocal_threshold)
+        return div_mod_knuth(one, d).first;
+
+    // Приближение по старшей половине делителя
+    size_t h = (m + 1) / 2;
+    Magnitude x = shift_digits(reciprocal(get_digits(d, m - h, h)), m - h);
+
+    // Один шаг Ньютона
+    Magnitude product = mul_magnitudes(d, x);
+
+    if (!first_is_less(one, product))
+    {
+        Magnitude error = sub_magnitudes(one, product);
+        x = add_magnitudes(x, get_digits(mul_magnitudes(x, error), m * 2, SIZE_MAX));
+    }
+    else
+    {
+        Magnitude error = sub_magnitudes(product, one);
+        Magnitude correction = add_magnitudes(get_digits(mul_magnitudes(x, error), m * 2, SIZE_MAX), Magnitude{1});
+        x = first_is_less(correction, x) ? sub_magnitudes(x, correction) : Magnitude{0};
+    }
+
+    // После шага Ньютона ошибка - несколько единиц. Исправляем её
+    product = mul_magnitudes(d, x);
+
+    while (first_is_less(one, product))
+    {
+        x = sub_magnitudes(x, Magnitude{1});
+        product = sub_magnitudes(product, d);
+    }
+
+    Magnitude rest = sub_magnitudes(one, product);
+
+    while (!first_is_less(rest, d))
+    {
+        x = add_magnitudes(x, Magnitude{1});
+        rest = sub_magnitudes(rest, d);
+    }
+
+    return x;
+}
+
+// Делит умножением на обратное число. Числитель не меньше знаменателя, в знаменателе минимум 2 цифры
+static pair<Magnitude, Magnitude> div_mod_newton(const Magnitude& numerator, const Magnitude& denominator)
+{
+    // Нормализуем
+    Digit scale = base / (denominator.back() + 1);
+    Magnitude den = mul_magnitudes(denominator, Magnitude{scale});
+    Magnitude num = mul_magnitudes(numerator, Magnitude{scale});
+
+    const size_t m = den.size();
+    Magnitude inverse = reciprocal(den);
+
+    // Как в div_mod_burnikel_ziegler(), делим столбиком блоками по m цифр
+    size_t num_blocks = max(size_t(2), (num.size() + m) / m);
+    Magnitude chunk = get_digits(num, (num_blocks - 2) * m, m * 2);
+    Magnitude quotient{0};
+    Magnitude remainder;
+
+    for (size_t i = num_blocks - 2; i != size_t(-1); --i)
+    {
+        // Для оценки частного достаточно старших m + 1 цифр куска.
+        // inverse <= base^(2m) / den, поэтому оценка не больше точного частного и меньше его максимум на 3
+        Magnitude block_quotient = get_digits(mul_magnitudes(get_digits(chunk, m - 1, SIZE_MAX), inverse), m + 1, SIZE_MAX);
+        remainder = sub_magnitudes(chunk, mul_magnitudes(block_quotient, den));
+
+        while (!first_is_less(remainder, den))
+        {
+            block_quotient = add_magnitudes(block_quotient, Magnitude{1});
+            remainder = sub_magnitudes(remainder, den);
+        }
+
+        quotient = add_magnitudes(shift_digits(quotient, m), block_quotient);
+
+        if (i > 0)
+            chunk = add_magnitudes(shift_digits(remainder, m), get_digits(num, (i - 1) * m, m));
+    }
+
+    // Денормализуем остаток
+    pair<Magnitude, Magnitude> denorm_remainder = div_by_digit(remainder, scale);
+    assert(denorm_remainder.second == Magnitude{0}); // Должно поделиться без остатка
+
+    return {quotient, denorm_remainder.first};
+}
+
+// Возвращает неполное частное и остаток. Выбирает алгоритм по длине знаменателя и частного.
+// Если знаменатель == 0, возвращает {0, 0}
+static pair<Magnitude, Magnitude> div_mod_magnitudes(const Magnitude& numerator, const Magnitude& denominator)
+{
+    // Если в знаменателе одна цифра
+    if (denominator.size() == 1)
+        return div_by_digit(numerator, denominator[0]);
+
+    // Если числитель меньше знаменателя (в том числе когда числитель == 0)
+    if (first_is_less(numerator, denominator))
+        return {Magnitude{0}, numerator};
+
+    // Быстрые алгоритмы выгодны, только когда и знаменатель, и частное длинные
+    size_t quotient_size = numerator.size() - denominator.size() + 1;
+    const BigInt::DivThresholds& thresholds = BigInt::div_thresholds;
+
+    // Вычисление обратного числа дорогое и окупается, только если частное в несколько раз длиннее знаменателя
+    if (denominator.size() >= thresholds.newton && quotient_size >= denominator.size() * 4)
+        return div_mod_newton(numerator, denominator);
+
+    if (min(denominator.size(), quotient_size) >= thresholds.burnikel_ziegler)
+        return div_mod_burnikel_ziegler(numerator, denominator);
+
+    return div_mod_knuth(numerator, denominator);
+}
+
+// ============================= Операции на месте =============================
+
+// Определяет, меньше ли первый модуль (модули без ведущих нулей)
+static bool first_is_less(const Digit* first, size_t first_size, const Digit* second, size_t second_size)
+{
+    if (first_size != second_size)
+        return first_size < second_size;
+
+    for (size_t i = first_size - 1; i != size_t(-1); --i)
+    {
+        if (first[i] != second[i])
+            return first[i] < second[i];
+    }
+
+    return false; // Модули равны
+}
+
+// Убирает ведущие нули
+static void trim(Magnitude& mag)
+{
+    while (mag.size() > 1 && mag.back() == 0)
+        mag.pop_back();
+}
+
+// mag += src. Память mag используется повторно
+static void add_in_place(Magnitude& mag, const Digit* src, size_t src_size)
+{
+    if (mag.size() < src_size)
+        mag.resize(src_size);
+
+    Digit carry = add_to(mag.data(), mag.size(), src, src_size);
+
+    if (carry)
+        mag.push_back(carry);
+}
+
+// mag -= src. Модуль mag не меньше src
+static void sub_in_place(Magnitude& mag, const Digit* src, size_t src_size)
+{
+    sub_from(mag.data(), mag.size(), src, src_size);
+    trim(mag);
+}
+
+// mag = src - mag. Модуль src не меньше mag
+static void reverse_sub_in_place(Magnitude& mag, const Digit* src, size_t src_size)
+{
+    assert(mag.size() <= src_size);
+    mag.resize(src_size);
+
+    Digit borrow = 0;
+
+    for (size_t i = 0; i < src_size; ++i)
+    {
+        Digit subtrahend = mag[i] + borrow;
+        borrow = src[i] < subtrahend;
+        mag[i] = src[i] + base * borrow - subtrahend;
+    }
+
+    assert(borrow == 0);
+    trim(mag);
+}
+
+// mag *= digit
+static void mul_by_digit_in_place(Magnitude& mag, Digit digit)
+{
+    Digit carry = mul_by_digit(mag.data(), mag.size(), digit, mag.data());
+
+    if (carry)
+        mag.push_back(carry);
+    else
+        trim(mag); // Если digit == 0
+}
+
+// Сколько цифр Digit нужно для записи любого uint64_t
+constexpr size_t u64_max_digits = []
+{
+    size_t ret = 0;
+
+    for (uint64_t value = UINT64_MAX; value != 0; value /= base)
+        ++ret;
+
+    return ret;
+}();
+
+// Записывает число в out (минимум одна цифра) и возвращает число цифр
+static size_t to_digits(uint64_t value, Digit (&out)[u64_max_digits])
+{
+    size_t size = 0;
+
+    do
+    {
+        out[size++] = Digit(value % base);
+        value /= base;
+    }
+    while (value != 0);
+
+    return size;
+}
+
+// Общий генератор для generate()
+static mt19937& get_generator()
+{
+    // Используем random_device только для генерации seed, так как он медленный
+    static mt19937 generator(random_device{}());
+    return generator;
+}
+
+void BigInt::set_generate_seed(uint32_t seed)
+{
+    get_generator().seed(seed);
+}
+
+// Генерирует случайное число из диапазона [min, max] (включительно)
+static uint32_t generate_random(uint32_t min, uint32_t max)
+{
+    uniform_int_distribution<uint32_t> dist(min, max);
+    return dist(get_generator());
+}
+
+BigInt BigInt::generate(size_t length)
+{
+    Magnitude magnitude(length);
+
+    // Старший разряд не должен быть 0
+    magnitude[length - 1] = generate_random(1, BigInt::base - 1);
+
+    // Остальные разряды могут быть 0
+    for (size_t i = 0; i < length - 1; ++i)
+        magnitude[i] = generate_random(0, BigInt::base - 1);
+
+    BigInt ret;
+    ret.positive_ = true;
+    ret.magnitude_ = magnitude;
+
+    return ret;
+}
+
+BigInt::BigInt()
+{
+    positive_ = true;
+    magnitude_.push_back(0);
+}
+
+BigInt::BigInt(int32_t value)
+{
+    positive_ = (value >= 0);
+
+    // Сперва преобразуем в int64_t, чтобы не было UB в std::abs(-2147483648)
+    uint64_t val = (uint64_t)std::abs((int64_t)value);
+
+    while (val != 0)
+    {
+        Digit mod = val % base;
+        magnitude_.push_back(mod);
+        val /= base;
+    }
+
+    if (!magnitude_.size()) // value == 0
+        magnitude_.push_back(0);
+}
+
+BigInt::BigInt(uint32_t value)
+{
+    positive_ = true;
+
+    while (value != 0)
+    {
+        Digit mod = value % base;
+        magnitude_.push_back(mod);
+        value /= base;
+    }
+
+    if (!magnitude_.size()) // value == 0
+        magnitude_.push_back(0);
+}
+
+// Обходит undefined behavior в std::abs()
+static uint64_t fixed_abs(int64_t value)
+{
+    static_assert(is_same_v<int64_t, decltype(-9223372036854775807 - 1)>
+        && is_same_v<uint64_t, decltype(9223372036854775808u)>);
+
+    if (value == -9223372036854775807 - 1)
+        return 9223372036854775808u;
+    else
+        return (uint64_t)std::abs(value);
+}
+
+BigInt::BigInt(int64_t value)
+{
+    positive_ = (value >= 0);
+
+    uint64_t val = fixed_abs(value);
+
+    while (val != 0)
+    {
+        Digit mod = val % base;
+        magnitude_.push_back(mod);
+        val /= base;
+    }
+
+    if (!magnitude_.size()) // value == 0
+        magnitude_.push_back(0);
+}
+
+BigInt::BigInt(uint64_t value)
+{
+    positive_ = true;
+
+    while (value != 0)
+    {
+        Digit mod = (Digit)(value % base);
+        magnitude_.push_back(mod);
+        value /= base;
+    }
+
+    if (!magnitude_.size()) // value == 0
+        magnitude_.push_back(0);
+}
+
+// Преобразует 8 символов-цифр в число за несколько операций над uint64_t (SWAR).
+// Используется на little-endian машинах, где первый символ попадает в младший байт
+static uint32_t parse_8_digits(const char* chars)
+{
+    uint64_t val;
+    memcpy(&val, chars, 8);
+
+    val -= 0x3030303030303030; // Вычитаем '0' из каждого байта
+    val = val * 10 + (val >> 8); // В каждом втором байте - число из двух соседних цифр
+
+    // Объединяем пары в четвёрки и четвёрки в итоговое число
+    val = ((val & 0x000000FF000000FF) * (100 + (1'000'000ull << 32))
+           + ((val >> 16) & 0x000000FF000000FF) * (1 + (10'000ull << 32))) >> 32;
+
+    return (uint32_t)val;
+}
+
+// Преобразует length <= chunk_length символов-цифр в Digit
+static Digit parse_chunk(const char* chars, size_t length)
+{
+    assert(length <= BigInt::chunk_length);
+
+    if constexpr (endian::native == endian::little && BigInt::chunk_length == 9)
+    {
+        if (length == 9)
+            return Digit(chars[0] - '0') * 100'000'000 + parse_8_digits(chars + 1);
+    }
+
+    Digit ret = 0;
+
+    for (size_t i = 0; i < length; ++i)
+        ret = ret * 10 + Digit(chars[i] - '0');
+
+    return ret;
+}
+
+BigInt::BigInt(const string& str)
+{
+    if (str.empty())
+    {
+        // Инцициализируем нулём
+        positive_ = true;
+        magnitude_.push_back(0);
+        return;
+    }
+
+    size_t first_digit_pos;
+
+    if (str[0] == '-')
+    {
+        positive_ = false;
+        first_digit_pos = 1;
+    }
+    else if (str[0] == '+')
+    {
+        positive_ = true;
+        first_digit_pos = 1;
+    }
+    else
+    {
+        positive_ = true;
+        first_digit_pos = 0;
+    }
+
+    // Проверяем, что после знака только цифры
     for (size_t i = first_digit_pos; i < str.length(); ++i)
     {
-        if (!isdigit(str[i]))
+        if (!isdigit(str[i]))
+        {
+            // Инцициализируем нулём
+            positive_ = true;
+            magnitude_.push_back(0);
+            return;
+        }
+    }
+
+    // Пропускаем ведущие нули
+    for (; first_digit_pos < str.length(); ++first_digit_pos)
+    {
+        if (str[first_digit_pos] != '0')
+            break;
+    }
+
+    // Если после знака только нули или ничего нет
+    if (first_digit_pos == str.length())
+    {
+        // Инцициализируем нулём
+        positive_ = true;
+        magnitude_.push_back(0);
+        return;
+    }
+
+    const char* digits = str.data() + first_digit_pos;
+    size_t num_digits = str.length() - first_digit_pos;
+
+    // Первый кусок может быть неполным
+    size_t first_chunk_length = num_digits % chunk_length;
+
+    if (!first_chunk_length)
+        first_chunk_length = chunk_length;
+
+    size_t num_chunks = (num_digits - first_chunk_length) / chunk_length + 1;
+    magnitude_.resize(num_chunks);
+
+    // Куски идут в строке от старших разрядов к младшим
+    magnitude_[num_chunks - 1] = parse_chunk(digits, first_chunk_length);
+    const char* chunk = digits + first_chunk_length;
+
+    for (size_t i = num_chunks - 2; i != size_t(-1); --i)
+    {
+        magnitude_[i] = parse_chunk(chunk, chunk_length);
+        chunk += chunk_length;
+    }
+}
+
+bool BigInt::is_zero() const
+{
+    assert(magnitude_.size() > 0);
+
+    // Проверяем, что нет ведущих нулей (вдруг число ещё не нормализовано и состоит из одних нулей)
+    assert(magnitude_.size() == 1 || magnitude_.back() != 0);
+
+    if (magnitude_.size() == 1 && magnitude_[0] == 0)
+    {
+        assert(positive_);
+        return true;
+    }
+
+    return false;
+}
+
+void BigInt::set_positive(bool positive)
+{
+    if (!is_zero() && positive_ != positive) // Ноль всегда положительный
+    {
+        positive_ = positive;
+        string_cache_.clear();
+    }
+}
+
+strong_ordering BigInt::operator<=>(const BigInt& rhs) const
+{
+    // Если у чисел разные знаки
+    if (positive_ != rhs.positive_)
+    {
+        // То, положительное больше отрицательного
+        return positive_ ? strong_ordering::greater : strong_ordering::less;
+    }
+
+    // В этой точке у чисел одинаковый знак
+
+    // Если у чисел разная длина
+    if (magnitude_.size() != rhs.magnitude_.size())
+    {
+        // Если числа положительные
+        if (positive_)
         {
-            // Инцициализируем нулём
-            positive_ = true;
-            magnitude_.push_back(0);
-            return;
+            // То более длинное число больше
+            return (magnitude_.size() > rhs.magnitude_.size()) ? strong_ordering::greater : strong_ordering::less;
+        }
+        else // А если числа отрицательные
+        {
+            // То более короткое число больше
+            return (magnitude_.size() < rhs.magnitude_.size()) ? strong_ordering::greater : strong_ordering::less;
+        }
+    }
+
+    // В этой точке у чисел одинаковая длина
+
+    // Сравниваем цифры в обратном порядке
+    for (size_t i = magnitude_.size() - 1; i != size_t(-1); --i)
+    {
+        if (magnitude_[i] != rhs.magnitude_[i])
+        {
+            if (positive_)
+                return (magnitude_[i] > rhs.magnitude_[i]) ? strong_ordering::greater : strong_ordering::less;
+            else
+                return (magnitude_[i] < rhs.magnitude_[i]) ? strong_ordering::greater : strong_ordering::less;
         }
     }
 
-    // Пропускаем ведущие нули
-    for (; first_digit_pos < str.length(); ++first_digit_pos)
-    {
-        if (str[first_digit_pos] != '0')
-            break;
-    }
+    return strong_ordering::equal;
+}
+
+void BigInt::add(const Digit* rhs, size_t rhs_size, bool rhs_positive)
+{
+    string_cache_.clear();
+
+    if (positive_ == rhs_positive)
+    {
+        add_in_place(magnitude_, rhs, rhs_size);
+    }
+    else if (first_is_less(magnitude_.data(), magnitude_.size(), rhs, rhs_size))
+    {
+        reverse_sub_in_place(magnitude_, rhs, rhs_size);
+        positive_ = rhs_positive;
+    }
+    else
+    {
+        sub_in_place(magnitude_, rhs, rhs_size);
+
+        if (magnitude_.size() == 1 && magnitude_[0] == 0) // Ноль всегда положительный
+            positive_ = true;
+    }
+}
+
+void BigInt::add(uint64_t value, bool positive)
+{
+    Digit digits[u64_max_digits];
+    size_t size = to_digits(value, digits);
+    add(digits, size, positive);
+}
+
+void BigInt::mul(const Digit* rhs, size_t rhs_size, bool rhs_positive)
+{
+    string_cache_.clear();
+
+    if (rhs_size == 1)
+    {
+        mul_by_digit_in_place(magnitude_, rhs[0]);
+    }
+    else if (magnitude_.size() == 1)
+    {
+        Digit digit = magnitude_[0];
+        magnitude_.assign(rhs, rhs + rhs_size);
+        mul_by_digit_in_place(magnitude_, digit);
+    }
+    else
+    {
+        Magnitude product(magnitude_.size() + rhs_size);
+        mul_dispatch(magnitude_.data(), magnitude_.size(), rhs, rhs_size, product.data());
+        trim(product);
+        magnitude_ = std::move(product);
+    }
+
+    // is_zero() нельзя: он проверяет, что ноль положительный, а знак ещё старый
+    positive_ = (positive_ == rhs_positive) || (magnitude_.size() == 1 && magnitude_[0] == 0);
+}
+
+void BigInt::mul(uint64_t value, bool positive)
+{
+    Digit digits[u64_max_digits];
+    size_t size = to_digits(value, digits);
+    mul(digits, size, positive);
+}
+
+BigInt BigInt::operator+(const BigInt& rhs) const
+{
+    BigInt ret;
+
+    // Сразу выделяем память с запасом на перенос
+    ret.magnitude_.reserve(max(magnitude_.size(), rhs.magnitude_.size()) + 1);
+    ret.magnitude_ = magnitude_;
+    ret.positive_ = positive_;
+
+    ret.add(rhs.magnitude_.data(), rhs.magnitude_.size(), rhs.positive_);
+    return ret;
+}
+
+BigInt BigInt::operator-(const BigInt& rhs) const
+{
+    BigInt ret;
+
+    ret.magnitude_.reserve(max(magnitude_.size(), rhs.magnitude_.size()) + 1);
+    ret.magnitude_ = magnitude_;
+    ret.positive_ = positive_;
+
+    // Вычитание - это сложение с числом противоположного знака
+    ret.add(rhs.magnitude_.data(), rhs.magnitude_.size(), !rhs.positive_);
+    return ret;
+}
+
+BigInt BigInt::operator*(const BigInt& rhs) const
+{
+    BigInt ret;
+    ret.magnitude_ = mul_magnitudes(magnitude_, rhs.magnitude_);
+    ret.set_positive(positive_ == rhs.positive_);
+    return ret;
+}
+
+pair<BigInt, BigInt> BigInt::div_mod(const BigInt& rhs) const
+{
+    pair<Magnitude, Magnitude> dm = div_mod_magnitudes(magnitude_, rhs.magnitude_);
+
+    pair<BigInt, BigInt> ret;
+    ret.first.magnitude_ = std::move(dm.first); // Неполное частное
+    ret.second.magnitude_ = std::move(dm.second); // Остаток
+
+    // https://en.cppreference.com/w/cpp/language/operator_arithmetic#Built-in_multiplicative_operators
+    // (a/b)*b + a%b == a
+    // 7/3 = {2, 1}    | 2*3 + 1 == 7
+    // -7/3 = {-2, -1} | -2*3 + -1 == -7
+    // 7/-3 = {-2, 1}  | -2*-3 + 1 == 7
+    // -7/-3 = {2, -1} | 2*-3 + -1 == -7
+
+    if (positive_ != rhs.positive_) // Если знаки числителя и знаменателя разные
+        ret.first.set_positive(false); // Тогда неполное частное отрицательное
+
+    // Знак остатка совпадает со знаком числителя
+    ret.second.set_positive(positive_);
+
+    return ret;
+}
+
+BigInt BigInt::operator/(const BigInt& rhs) const
+{
+    return div_mod(rhs).first;
+}
+
+BigInt BigInt::operator%(const BigInt& rhs) const
+{
+    return div_mod(rhs).second;
+}
+
+BigInt BigInt::operator-() const
+{
+    BigInt ret = *this;
+    ret.set_positive(!positive_);
+    return ret;
+}
+
+BigInt& BigInt::operator+=(const BigInt& rhs)
+{
+    add(rhs.magnitude_.data(), rhs.magnitude_.size(), rhs.positive_);
+    return *this;
+}
+
+BigInt& BigInt::operator-=(const BigInt& rhs)
+{
+    add(rhs.magnitude_.data(), rhs.magnitude_.size(), !rhs.positive_);
+    return *this;
+}
+
+BigInt& BigInt::operator*=(const BigInt& rhs)
+{
+    mul(rhs.magnitude_.data(), rhs.magnitude_.size(), rhs.positive_);
+    return *this;
+}
+
+BigInt& BigInt::operator/=(const BigInt& rhs)
+{
+    string_cache_.clear();
+
+    // Деление на цифру выполняется на месте
+    if (rhs.magnitude_.size() == 1 && rhs.magnitude_[0] != 0)
+    {
+        div_by_digit_in_place(magnitude_.data(), magnitude_.size(), rhs.magnitude_[0]);
+        trim(magnitude_);
+        positive_ = (positive_ == rhs.positive_) || (magnitude_.size() == 1 && magnitude_[0] == 0);
+        return *this;
+    }
+
+    *this = div_mod(rhs).first;
+    return *this;
+}
+
+BigInt& BigInt::operator%=(const BigInt& rhs)
+{
+    string_cache_.clear();
+
+    if (rhs.magnitude_.size() == 1 && rhs.magnitude_[0] != 0)
+    {
+        Digit remainder = div_by_digit_in_place(magnitude_.data(), magnitude_.size(), rhs.magnitude_[0]);
+        magnitude_.resize(1);
+        magnitude_[0] = remainder;
+
+        // Знак остатка совпадает со знаком числителя
+        positive_ = positive_ || remainder == 0;
+        return *this;
+    }
+
+    *this = div_mod(rhs).second;
+    return *this;
+}
+
+// Пары десятичных цифр "00", "01", ..., "99"
+static constexpr array<char, 200> digit_pairs = []
+{
+    array<char, 200> ret{};
+
+    for (size_t i = 0; i < 100; ++i)
+    {
+        ret[i * 2] = char('0' + i / 10);
+        ret[i * 2 + 1] = char('0' + i % 10);
+    }
+
+    return ret;
+}();
+
+// Число десятичных цифр (для 0 возвращает 1)
+static size_t decimal_length(Digit value)
+{
+    size_t ret = 1;
+
+    while (value >= 10)
+    {
+        value /= 10;
+        ++ret;
+    }
+
+    return ret;
+}
+
+// Записывает в out ровно length младших десятичных цифр числа (с ведущими нулями).
+// Цифры записываются парами по таблице, без деления на 10 для каждой цифры
+static void write_digits(Digit value, size_t length, char* out)
+{
+    char* pos = out + length;
+
+    for (; length >= 2; length -= 2)
+    {
+        Digit pair = value % 100;
+        value /= 100;
+        pos -= 2;
+        memcpy(pos, &digit_pairs[pair * 2], 2);
+    }
+
+    if (length)
+        *--pos = char('0' + value % 10);
+}
+
+// Записывает число в out. Если ёмкости out хватает, память не выделяется
+static void format_to(const Magnitude& magnitude, bool positive, string& out)
+{
+    assert(magnitude.size() > 0);
+
+    size_t first_chunk_length = decimal_length(magnitude.back());
+    out.resize(!positive + first_chunk_length + (magnitude.size() - 1) * BigInt::chunk_length);
+    char* pos = out.data();
+
+    if (!positive)
+        *pos++ = '-';
+
+    // Первый кусок результата без ведущих нулей
+    write_digits(magnitude.back(), first_chunk_length, pos);
+    pos += first_chunk_length;
+
+    // Остальные куски результата с ведущими нулями
+    for (size_t i = magnitude.size() - 2; i != size_t(-1); --i)
+    {
+        write_digits(magnitude[i], BigInt::chunk_length, pos);
+        pos += BigInt::chunk_length;
+    }
+}
+
+string BigInt::to_string() const
+{
+    if (!string_cache_.empty())
+        return string_cache_;
+
+    string ret;
+    format_to(magnitude_, positive_, ret);
+    return ret;
+}
+
+const string& BigInt::to_cached_string() const
+{
+    if (string_cache_.empty())
+        format_to(magnitude_, positive_, string_cache_);
+
+    return string_cache_;
+}
+
+string BigInt::to_abbreviated_string(size_t precision) const
+{
+    precision = max(precision, size_t(1));
 
-    // Если после знака только нули или ничего нет
-    if (first_digit_pos == str.length())
-    {
-        // Инцициализируем нулём
-        positive_ = true;
-        magnitude_.push_back(0);
-        return;
-    }
+    size_t first_chunk_length = decimal_length(magnitude_.back());
+    size_t num_digits = first_chunk_length + (magnitude_.size() - 1) * chunk_length;
 
-    size_t num_digits = str.length() - first_digit_pos;
-    size_t num_chunks = num_digits / chunk_length;
-    size_t rest_length = num_digits - num_chunks * chunk_length;
-    size_t first_chunk_length;
+    if (num_digits <= precision)
+        return to_string();
 
-    if (!rest_length) // Первый кусок полный
-    {
-        first_chunk_length = chunk_length;
-    }
-    else // Первый кусок неполный
+    // Для мантиссы достаточно нескольких старших цифр Digit
+    size_t num_chunks = min(magnitude_.size() - 1, (precision + chunk_length - 1) / chunk_length);
+    string leading(first_chunk_length + num_chunks * chunk_length, '0');
+    write_digits(magnitude_.back(), first_chunk_length, leading.data());
+
+    for (size_t i = 0; i < num_chunks; ++i)
+        write_digits(magnitude_[magnitude_.size() - 2 - i], chunk_length, leading.data() + first_chunk_length + i * chunk_length);
+
+    // Остальные цифры отбрасываются (без округления)
+    string ret;
+
+    if (!positive_)
+        ret += '-';
+
+    ret += leading[0];
+
+    if (precision > 1)
     {
-        first_chunk_length = rest_length;
-        ++num_chunks;
+        ret += '.';
+        ret.append(leading, 1, precision - 1);
     }
 
-    magnitude_.reserve(num_chunks);
+    ret += 'e';
+    ret += std::to_string(num_digits - 1);
+
+    return ret;
+}
+
+// =========================== Сдвиги и теория чисел ===========================
+
+// Наибольшее k, при котором 2^k < base. На 2^k можно умножать и делить как на одну цифру
+constexpr size_t shift_step = []
+{
+    size_t ret = 0;
+
+    while ((uint64_t(1) << (ret + 1)) < base)
+        ++ret;
+
+    return ret;
+}();
+
+// При более длинных сдвигах выгоднее один раз умножить (поделить) на 2^bits
+constexpr size_t max_stepwise_shift = shift_step * 4;
+
+BigInt& BigInt::operator<<=(size_t bits)
+{
+    if (is_zero())
+        return *this;
+
+    if (bits > max_stepwise_shift)
+        return *this *= pow(BigInt(2), bits);
+
+    string_cache_.clear();
 
-    // Извлекаем куски в обратном порядке и преобразуем в Digit (кроме первого куска)
-    for (size_t i = 0; i < num_chunks - 1; ++i) // i - номер куска с конца
+    while (bits)
     {
-        size_t chunk_start = str.size() - (i + 1) * chunk_length;
-        string chunk = str.substr(chunk_start, chunk_length);
-        magnitude_.push_back(to_uint32_t(chunk));
+        size_t step = min(bits, shift_step);
+        mul_by_digit_in_place(magnitude_, Digit(1) << step);
+        bits -= step;
     }
 
-    // Преобразуем в Digit первый кусок
-    string first_chunk = str.substr(first_digit_pos, first_chunk_length);
-    magnitude_.push_back(to_uint32_t(first_chunk));
+    return *this;
 }
 
-bool BigInt::is_zero() const
+BigInt& BigInt::operator>>=(size_t bits)
 {
-    assert(magnitude_.size() > 0);
+    if (bits > max_stepwise_shift)
+        return *this /= pow(BigInt(2), bits);
 
-    // Проверяем, что нет ведущих нулей (вдруг число ещё не нормализовано и состоит из одних нулей)
-    assert(magnitude_.size() == 1 || magnitude_.back() != 0);
+    string_cache_.clear();
 
-    if (magnitude_.size() == 1 && magnitude_[0] == 0)
+    while (bits && !(magnitude_.size() == 1 && magnitude_[0] == 0))
     {
-        assert(positive_);
-        return true;
+        size_t step = min(bits, shift_step);
+        div_by_digit_in_place(magnitude_.data(), magnitude_.size(), Digit(1) << step);
+        trim(magnitude_);
+        bits -= step;
     }
 
-    return false;
+    if (magnitude_.size() == 1 && magnitude_[0] == 0)
+        positive_ = true;
+
+    return *this;
 }
 
-void BigInt::set_positive(bool positive)
+BigInt BigInt::operator<<(size_t bits) const
 {
-    if (!is_zero()) // Ноль всегда положительный
-        positive_ = positive;
+    BigInt ret = *this;
+    ret <<= bits;
+    return ret;
 }
 
-strong_ordering BigInt::operator<=>(const BigInt& rhs) const
+BigInt BigInt::operator>>(size_t bits) const
 {
-    // Если у чисел разные знаки
-    if (positive_ != rhs.positive_)
-    {
-        // То, положительное больше отрицательного
-        return positive_ ? strong_ordering::greater : strong_ordering::less;
-    }
+    BigInt ret = *this;
+    ret >>= bits;
+    return ret;
+}
 
-    // В этой точке у чисел одинаковый знак
+BigInt pow(const BigInt& value, uint64_t exponent)
+{
+    BigInt ret = 1;
+    BigInt square = value;
 
-    // Если у чисел разная длина
-    if (magnitude_.size() != rhs.magnitude_.size())
+    // Бинарное возведение в степень: value^exponent = произведение value^(2^i) для единичных битов exponent
+    while (exponent)
     {
-        // Если числа положительные
-        if (positive_)
-        {
-            // То более длинное число больше
-            return (magnitude_.size() > rhs.magnitude_.size()) ? strong_ordering::greater : strong_ordering::less;
-        }
-        else // А если числа отрицательные
-        {
-            // То более короткое число больше
-            return (magnitude_.size() < rhs.magnitude_.size()) ? strong_ordering::greater : strong_ordering::less;
-        }
+        if (exponent & 1)
+            ret *= square;
+
+        exponent >>= 1;
+
+        if (exponent)
+            square *= square;
     }
 
-    // В этой точке у чисел одинаковая длина
+    return ret;
+}
 
-    // Сравниваем цифры в обратном порядке
-    for (size_t i = magnitude_.size() - 1; i != size_t(-1); --i)
+// Биты модуля, начиная с младшего. Старший бит всегда единичный
+static vector<bool> to_bits(Magnitude mag)
+{
+    vector<bool> ret;
+
+    while (!(mag.size() == 1 && mag[0] == 0))
     {
-        if (magnitude_[i] != rhs.magnitude_[i])
-        {
-            if (positive_)
-                return (magnitude_[i] > rhs.magnitude_[i]) ? strong_ordering::greater : strong_ordering::less;
-            else
-                return (magnitude_[i] < rhs.magnitude_[i]) ? strong_ordering::greater : strong_ordering::less;
-        }
+        Digit chunk = div_by_digit_in_place(mag.data(), mag.size(), Digit(1) << shift_step);
+        trim(mag);
+
+        for (size_t i = 0; i < shift_step; ++i)
+            ret.push_back((chunk >> i) & 1);
     }
 
-    return strong_ordering::equal;
+    // Убираем ведущие нули
+    while (!ret.empty() && !ret.back())
+        ret.pop_back();
+
+    return ret;
 }
 
-BigInt BigInt::operator+(const BigInt& rhs) const
+// Возведение в степень скользящим окном: за один проход по битам показателя умножение на x^(нечётное число)
+// выполняется не для каждого единичного бита, а для окна из нескольких битов.
+// mul(a, b) умножает в нужной арифметике (например, по модулю), one - единица этой арифметики
+template<typename Mul>
+static Magnitude pow_sliding_window(const Magnitude& x, const vector<bool>& bits, const Magnitude& one, Mul mul)
 {
-    BigInt ret;
+    if (bits.empty())
+        return one;
 
-    if (positive_ == rhs.positive_)
+    // Размер окна растёт с длиной показателя (как в GMP)
+    constexpr size_t window_thresholds[] = {7, 25, 81, 241, 673};
+    const size_t num_bits = bits.size();
+    size_t window = 1;
+
+    for (size_t threshold : window_thresholds)
     {
-        ret.positive_ = positive_;
-        ret.magnitude_ = add_magnitudes(magnitude_, rhs.magnitude_);
+        if (num_bits > threshold)
+            ++window;
     }
-    else
+
+    // Нечётные степени x^1, x^3, ..., x^(2^window - 1)
+    vector<Magnitude> odd_powers(size_t(1) << (window - 1));
+    odd_powers[0] = x;
+
+    if (window > 1)
+    {
+        Magnitude x2 = mul(x, x);
+
+        for (size_t i = 1; i < odd_powers.size(); ++i)
+            odd_powers[i] = mul(odd_powers[i - 1], x2);
+    }
+
+    Magnitude ret;
+    bool ret_is_one = true; // Чтобы не возводить единицу в квадрат
+
+    for (size_t i = num_bits - 1; i != size_t(-1);)
     {
-        if (first_is_less(magnitude_, rhs.magnitude_))
+        if (!bits[i])
+        {
+            if (!ret_is_one)
+                ret = mul(ret, ret);
+
+            --i;
+            continue;
+        }
+
+        // Окно [j, i] не длиннее window и заканчивается единичным битом
+        size_t j = (i + 1 >= window) ? i + 1 - window : 0;
+
+        while (!bits[j])
+            ++j;
+
+        size_t window_value = 0;
+
+        for (size_t k = i; k != j - 1; --k)
+            window_value = window_value * 2 + bits[k];
+
+        if (ret_is_one)
         {
-            ret.positive_ = rhs.positive_;
-            ret.magnitude_ = sub_magnitudes(rhs.magnitude_, magnitude_);
+            ret = odd_powers[window_value / 2];
+            ret_is_one = false;
         }
         else
         {
-            ret.positive_ = positive_;
-            ret.magnitude_ = sub_magnitudes(magnitude_, rhs.magnitude_);
+            for (size_t k = j; k <= i; ++k)
+                ret = mul(ret, ret);
+
+            ret = mul(ret, odd_powers[window_value / 2]);
         }
+
+        i = j - 1;
     }
 
-    return ret;
+    return ret_is_one ? one : ret;
 }
 
+// Обратный элемент по модулю base (value и base взаимно просты)
+static Digit inverse_mod_base(Digit value)
+{
+    // Расширенный алгоритм Евклида
+    int64_t r0 = base, r1 = value;
+    int64_t t0 = 0, t1 = 1;
 
-BigInt BigInt::operator-(const BigInt& rhs) const
+    while (r1 != 0)
+    {
+        int64_t q = r0 / r1;
+        tie(r0, r1) = make_pair(r1, r0 - q * r1);
+        tie(t0, t1) = make_pair(t1, t0 - q * t1);
+    }
+
+    assert(r0 == 1);
+    return Digit(t0 < 0 ? t0 + base : t0);
+}
+
+// Умножение Монтгомери по модулю m, взаимно простому с base.
+// Числа хранятся в форме a * R mod m, где R = base^n (n - длина m), и имеют ровно n цифр.
+// Вместо деления на m выполняется деление на R, т.е. отбрасывание цифр
+class Montgomery
 {
-    BigInt ret;
+private:
+    Magnitude m_;
+    size_t n_;
 
-    if (positive_ != rhs.positive_)
+    // -m^(-1) mod base
+    Digit m_inv_;
+
+    // Временный буфер длиной n + 2
+    Magnitude t_;
+
+public:
+    explicit Montgomery(const Magnitude& m)
+        : m_(m)
+        , n_(m.size())
+        , t_(m.size() + 2)
     {
-        ret.positive_ = positive_;
-        ret.magnitude_ = add_magnitudes(magnitude_, rhs.magnitude_);
+        m_inv_ = base - inverse_mod_base(m[0]);
     }
-    else
+
+    // Переводит число (меньше m) в форму Монтгомери
+    Magnitude to_form(const Magnitude& a) const
     {
-        if (first_is_less(magnitude_, rhs.magnitude_))
-        {
-            ret.positive_ = !rhs.positive_;
-            ret.magnitude_ = sub_magnitudes(rhs.magnitude_, magnitude_);
-        }
-        else
+        Magnitude ret = div_mod_magnitudes(shift_digits(a, n_), m_).second;
+        ret.resize(n_);
+        return ret;
+    }
+
+    // Переводит число из формы Монтгомери
+    Magnitude from_form(const Magnitude& a)
+    {
+        Magnitude one(n_);
+        one[0] = 1;
+        Magnitude ret = mul(a, one);
+        trim(ret);
+        return ret;
+    }
+
+    // Возвращает a * b / R mod m (CIOS: умножение чередуется с сокращением)
+    Magnitude mul(const Magnitude& a, const Magnitude& b)
+    {
+        assert(a.size() == n_ && b.size() == n_);
+
+        Digit* t = t_.data();
+        fill(t, t + n_ + 2, 0);
+
+        for (size_t i = 0; i < n_; ++i)
         {
-            ret.positive_ = positive_;
-            ret.magnitude_ = sub_magnitudes(magnitude_, rhs.magnitude_);
+            // t += a * b[i]
+            DDigit carry = 0;
+
+            for (size_t j = 0; j < n_; ++j)
+            {
+                DDigit cur = t[j] + (DDigit)a[j] * b[i] + carry;
+                carry = cur / base;
+                t[j] = Digit(cur - carry * base);
+            }
+
+            DDigit cur = t[n_] + carry;
+            t[n_] = Digit(cur % base);
+            t[n_ + 1] = Digit(cur / base);
+
+            // t = (t + u * m) / base, где u подобрано так, что младшая цифра суммы равна 0
+            Digit u = Digit((DDigit)t[0] * m_inv_ % base);
+            carry = (t[0] + (DDigit)u * m_[0]) / base;
+
+            for (size_t j = 1; j < n_; ++j)
+            {
+                cur = t[j] + (DDigit)u * m_[j] + carry;
+                carry = cur / base;
+                t[j - 1] = Digit(cur - carry * base);
+            }
+
+            cur = t[n_] + carry;
+            carry = cur / base;
+            t[n_ - 1] = Digit(cur - carry * base);
+            t[n_] = Digit(t[n_ + 1] + carry);
         }
+
+        // Результат меньше 2m
+        if (t[n_] != 0 || !first_is_less(t, trimmed_size(t, n_), m_.data(), n_))
+            sub_from(t, n_ + 1, m_.data(), n_);
+
+        return Magnitude(t, t + n_);
     }
+};
 
-    return ret;
-}
+// Умножение Монтгомери выполняется столбиком, поэтому на длинных модулях быстрее
+// обычное умножение (Карацуба и т.д.) с делением. Подобрано бенчмарком в Тестере (DV_NUMBER_THEORY_BENCHMARK)
+constexpr size_t montgomery_max_size = 64;
 
-BigInt BigInt::operator*(const BigInt& rhs) const
+BigInt pow_mod(const BigInt& value, const BigInt& exponent, const BigInt& modulus)
 {
-    BigInt ret;
-    ret.magnitude_ = mul_magnitudes(magnitude_, rhs.magnitude_);
-    ret.set_positive(positive_ == rhs.positive_);
-    return ret;
-}
+    if (modulus.is_zero() || modulus.is_negative() || exponent.is_negative())
+        return 0;
 
-BigInt BigInt::operator/(const BigInt& rhs) const
-{
-    pair<vector<Digit>, vector<Digit>> dm = div_mod_magnitudes(magnitude_, rhs.magnitude_);
+    const Magnitude& m = modulus.magnitude_;
 
-    BigInt ret;
-    ret.magnitude_ = dm.first; // Неполное частное
+    // Остаток от деления на модуль, неотрицательный
+    Magnitude x = div_mod_magnitudes(value.magnitude_, m).second;
 
-    // https://en.cppreference.com/w/cpp/language/operator_arithmetic#Built-in_multiplicative_operators
-    // (a/b)*b + a%b == a
-    // 7/3 = {2, 1}    | 2*3 + 1 == 7
-    // -7/3 = {-2, -1} | -2*3 + -1 == -7
-    // 7/-3 = {-2, 1}  | -2*-3 + 1 == 7
-    // -7/-3 = {2, -1} | 2*-3 + -1 == -7
+    if (value.is_negative() && !(x.size() == 1 && x[0] == 0))
+        x = sub_magnitudes(m, x);
 
-    if (positive_ != rhs.positive_) // Если знаки числителя и знаменателя разные
-        ret.set_positive(false); // Тогда неполное частное отрицательное
+    vector<bool> bits = to_bits(exponent.magnitude_);
 
-    return ret;
-}
+    BigInt ret;
 
-BigInt BigInt::operator%(const BigInt& rhs) const
-{
-    pair<vector<Digit>, vector<Digit>> dm = div_mod_magnitudes(magnitude_, rhs.magnitude_);
+    if (m.size() == 1 && m[0] == 1)
+        return ret; // Любое число по модулю 1 равно 0
 
-    BigInt ret;
-    ret.magnitude_ = dm.second; // Остаток
+    if (m[0] % 2 != 0 && m[0] % 5 != 0 && m.size() <= montgomery_max_size)
+    {
+        // Модуль взаимно прост с base (base - степень 10), поэтому можно использовать форму Монтгомери
+        Montgomery montgomery(m);
+        Magnitude one = montgomery.to_form(Magnitude{1});
+        Magnitude result = pow_sliding_window(montgomery.to_form(x), bits, one,
+            [&](const Magnitude& a, const Magnitude& b) { return montgomery.mul(a, b); });
+        ret.magnitude_ = montgomery.from_form(result);
+    }
+    else
+    {
+        ret.magnitude_ = pow_sliding_window(x, bits, Magnitude{1},
+            [&](const Magnitude& a, const Magnitude& b) { return div_mod_magnitudes(mul_magnitudes(a, b), m).second; });
 
-    // Знак остатка совпадает со знаком числителя
-    ret.set_positive(positive_);
+        // Показатель == 0
+        ret.magnitude_ = div_mod_magnitudes(ret.magnitude_, m).second;
+    }
 
     return ret;
 }
 
-BigInt BigInt::operator-() const
+// Наибольший общий делитель чисел, которые умещаются в uint64_t
+static uint64_t gcd_u64(uint64_t a, uint64_t b)
 {
-    BigInt ret = *this;
-    ret.set_positive(!positive_);
-    return ret;
-}
+    while (b != 0)
+    {
+        uint64_t r = a % b;
+        a = b;
+        b = r;
+    }
 
-BigInt& BigInt::operator+=(const BigInt& rhs)
-{
-    BigInt result = *this + rhs;
-    swap(this->positive_, result.positive_);
-    swap(this->magnitude_, result.magnitude_);
-    return *this;
+    return a;
 }
 
-BigInt& BigInt::operator-=(const BigInt& rhs)
+// Число из двух младших цифр модуля
+static uint64_t to_u64(const Magnitude& mag)
 {
-    BigInt result = *this - rhs;
-    swap(this->positive_, result.positive_);
-    swap(this->magnitude_, result.magnitude_);
-    return *this;
+    assert(mag.size() <= 2);
+    return mag.size() == 1 ? mag[0] : (uint64_t)mag[1] * base + mag[0];
 }
 
-BigInt& BigInt::operator*=(const BigInt& rhs)
+// Деление с округлением вниз (для отрицательных чисел тоже)
+static int64_t floor_div_base(int64_t value)
 {
-    BigInt result = *this * rhs;
-    swap(this->positive_, result.positive_);
-    swap(this->magnitude_, result.magnitude_);
-    return *this;
-}
+    int64_t ret = value / (int64_t)base;
 
-BigInt& BigInt::operator/=(const BigInt& rhs)
-{
-    BigInt result = *this / rhs;
-    swap(this->positive_, result.positive_);
-    swap(this->magnitude_, result.magnitude_);
-    return *this;
-}
+    if (value % (int64_t)base < 0)
+        --ret;
 
-BigInt& BigInt::operator%=(const BigInt& rhs)
-{
-    BigInt result = *this % rhs;
-    swap(this->positive_, result.positive_);
-    swap(this->magnitude_, result.magnitude_);
-    return *this;
+    return ret;
 }
 
-string BigInt::to_string() const
+BigInt gcd(const BigInt& a, const BigInt& b)
 {
-    assert(magnitude_.size() > 0);
+    Magnitude x = a.magnitude_;
+    Magnitude y = b.magnitude_;
 
-    string ret;
+    if (first_is_less(x, y))
+        swap(x, y);
 
-    if (!positive_)
+    // Алгоритм Лемера: шаги алгоритма Евклида вычисляются по старшим цифрам в int64_t,
+    // а к длинным числам применяется только итоговая матрица. Пока y не умещается в uint64_t
+    while (y.size() > 2)
+    {
+        size_t n = x.size();
+
+        // Старшие цифры x и y (с одинаковым сдвигом)
+        int64_t x_high = (int64_t)x[n - 1] * base + x[n - 2];
+        int64_t y_high = (y.size() == n) ? (int64_t)y[n - 1] * base + y[n - 2]
+                       : (y.size() == n - 1) ? y[n - 2]
+                       : 0;
+
+        // Матрица [A B; C D]. Коэффициенты ограничены, чтобы A * x[i] + B * y[i] умещалось в int64_t
+        constexpr int64_t max_coef = int64_t(1) << 31;
+        int64_t A = 1, B = 0, C = 0, D = 1;
+
+        // Знаменатели и числители должны оставаться положительными, иначе деление в C++ округляет не вниз
+        while (y_high + C > 0 && y_high + D > 0 && x_high + A >= 0 && x_high + B >= 0)
+        {
+            int64_t q = (x_high + A) / (y_high + C);
+
+            if (q != (x_high + B) / (y_high + D))
+                break;
+
+            int64_t new_C = A - q * C;
+            int64_t new_D = B - q * D;
+
+            if (new_C > max_coef || new_C < -max_coef || new_D > max_coef || new_D < -max_coef)
+                break;
+
+            A = C;
+            B = D;
+            C = new_C;
+            D = new_D;
+
+            int64_t new_y_high = x_high - q * y_high;
+            x_high = y_high;
+            y_high = new_y_high;
+        }
+
+        if (B == 0)
+        {
+            // Старших цифр не хватило даже на один шаг: делаем обычный шаг алгоритма Евклида
+            Magnitude r = div_mod_magnitudes(x, y).second;
+            x = std::move(y);
+            y = std::move(r);
+            continue;
+        }
+
+        // (x, y) = (A * x + B * y, C * x + D * y) на месте
+        y.resize(n);
+        int64_t x_carry = 0;
+        int64_t y_carry = 0;
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            int64_t xi = x[i];
+            int64_t yi = y[i];
+
+            int64_t new_x = A * xi + B * yi + x_carry;
+            int64_t new_y = C * xi + D * yi + y_carry;
+
+            x_carry = floor_div_base(new_x);
+            y_carry = floor_div_base(new_y);
+
+            x[i] = Digit(new_x - x_carry * (int64_t)base);
+            y[i] = Digit(new_y - y_carry * (int64_t)base);
+        }
+
+        assert(x_carry == 0 && y_carry == 0);
+        trim(x);
+        trim(y);
+    }
+
+    BigInt ret;
+
+    if (y.size() == 1 && y[0] == 0)
     {
-        ret.reserve(magnitude_.size() * chunk_length + 1);
-        ret = "-";
+        ret.magnitude_ = std::move(x);
+        return ret;
     }
-    else
+
+    // Один шаг с длинным x, дальше всё умещается в uint64_t
+    uint64_t y64 = to_u64(y);
+    uint64_t r64 = to_u64(div_mod_magnitudes(x, y).second);
+
+    return BigInt(gcd_u64(y64, r64));
+}
+
+BigInt isqrt(const BigInt& value)
+{
+    if (value.is_zero() || value.is_negative())
+        return 0;
+
+    const Magnitude& mag = value.magnitude_;
+
+    if (mag.size() <= 2)
     {
-        ret.reserve(magnitude_.size() * chunk_length);
+        uint64_t v = to_u64(mag);
+        uint64_t r = (uint64_t)sqrt((double)v);
+
+        // Исправляем погрешность double
+        while (r * r > v)
+            --r;
+
+        while ((r + 1) * (r + 1) <= v)
+            ++r;
+
+        return BigInt(r);
     }
 
-    // Первый кусок результата без ведущих нулей
-    ret += std::to_string(magnitude_.back());
+    // Начальное приближение сверху по старшим цифрам: 2 или 3 цифры, чтобы остаток длины был чётным
+    size_t num_leading = (mag.size() % 2 == 0) ? 2 : 3;
+    double leading = 0;
 
-    // Остальные куски результата с ведущими нулями
-    for (size_t i = magnitude_.size() - 2; i != size_t(-1); --i)
-        ret += format("{0:0>{1}}", magnitude_[i], chunk_length);
+    for (size_t i = 0; i < num_leading; ++i)
+        leading = leading * base + mag[mag.size() - 1 - i];
 
-    return ret;
+    BigInt x = BigInt((uint64_t)sqrt(leading) + 2);
+    x.magnitude_ = shift_digits(x.magnitude_, (mag.size() - num_leading) / 2);
+
+    // Метод Ньютона сходится сверху: x = (x + value / x) / 2, пока x уменьшается
+    while (true)
+    {
+        BigInt y = value / x;
+        y += x;
+        y >>= 1;
+
+        if (y >= x)
+            return x;
+
+        x = std::move(y);
+    }
 }
 
 } // namespace dviglo
@@ -3,9 +3,11 @@
 
 #pragma once
 
+#include "dv_small_vector.hpp"
+
 #include <cstdint> // uint64_t, ...
 #include <string>
-#include <vector>
+#include <utility> // pair
 
 
 namespace dviglo
@@ -31,15 +33,66 @@ public:
     /// Отдельная цифра длинного числа
     using Digit = uint32_t;
 
+    /// Цифры числа. Короткие числа (до 4 цифр) хранятся внутри объекта без выделения памяти в куче
+    using Magnitude = SmallVector<Digit, 4>;
+
     /// Генерирует случайное положительное число указанной длины. Никогда не генерирует 0
     static BigInt generate(size_t length);
 
+    /// Делает последовательность generate() воспроизводимой (например, для бенчмарков).
+    /// По умолчанию seed случайный. Не потокобезопасно
+    static void set_generate_seed(uint32_t seed);
+
+    /// Пороги переключения алгоритмов умножения (длина более короткого множителя в цифрах Digit).
+    /// Ниже порога karatsuba используется умножение столбиком.
+    /// Значения по умолчанию подобраны бенчмарком в Тестере (DV_MUL_BENCHMARK)
+    struct MulThresholds
+    {
+        size_t karatsuba = 24;
+        size_t toom3 = 400;
+        size_t ntt = 1800;
+    };
+
+    /// Можно менять, например, чтобы сравнить алгоритмы. Не потокобезопасно
+    static MulThresholds mul_thresholds;
+
+    /// Пороги переключения алгоритмов деления (в цифрах Digit).
+    /// Если знаменатель или частное короче burnikel_ziegler, используется деление столбиком (алгоритм D Кнута).
+    /// Деление умножением на обратное число (метод Ньютона) используется, когда знаменатель не короче newton,
+    /// а частное длиннее знаменателя минимум в 4 раза.
+    /// Значения по умолчанию подобраны бенчмарком в Тестере (DV_DIV_ALGORITHMS_BENCHMARK)
+    struct DivThresholds
+    {
+        size_t burnikel_ziegler = 96;
+        size_t newton = 32768;
+    };
+
+    /// Можно менять, например, чтобы сравнить алгоритмы. Не потокобезопасно
+    static DivThresholds div_thresholds;
+
 private:
     /// Знак числа (ноль всегда положительный)
     bool positive_;
 
     /// Цифры числа в обратном порядке. Всегда содержит как минимум одну цифру
-    std::vector<Digit> magnitude_;
+    Magnitude magnitude_;
+
+    /// Результат to_cached_string(). Пустая строка означает, что кэш устарел.
+    /// Очищается (с сохранением ёмкости) при каждом изменении числа
+    mutable std::string string_cache_;
+
+    /// Прибавляет число, заданное модулем и знаком. Использует память magnitude_ повторно
+    void add(const Digit* rhs, size_t rhs_size, bool rhs_positive);
+
+    /// Умножает на число, заданное модулем и знаком
+    void mul(const Digit* rhs, size_t rhs_size, bool rhs_positive);
+
+    /// Прибавляет (или умножает на) короткое число без создания BigInt
+    void add(uint64_t value, bool positive);
+    void mul(uint64_t value, bool positive);
+
+    /// Модуль без undefined behavior для минимального int64_t
+    static uint64_t abs_u64(int64_t value) { return value < 0 ? 0 - (uint64_t)value : (uint64_t)value; }
 
 public:
     /// Инициализирует нулём
@@ -70,27 +123,73 @@ public:
     /// Возвращаеть 0, если rhs ноль
     BigInt operator%(const BigInt& rhs) const;
 
+    /// Возвращает неполное частное и остаток за одно деление (как operator/ и operator%).
+    /// Возвращает {0, 0}, если rhs ноль
+    std::pair<BigInt, BigInt> div_mod(const BigInt& rhs) const;
+
     BigInt operator-() const;
 
+    // Составные операторы работают на месте и повторно используют память числа
+
     BigInt& operator+=(const BigInt& rhs);
     BigInt& operator-=(const BigInt& rhs);
     BigInt& operator*=(const BigInt& rhs);
     BigInt& operator/=(const BigInt& rhs);
     BigInt& operator%=(const BigInt& rhs);
 
+    // Быстрые версии для коротких чисел
+
+    BigInt& operator+=(int32_t rhs) { add(abs_u64(rhs), rhs >= 0); return *this; }
+    BigInt& operator+=(uint32_t rhs) { add((uint64_t)rhs, true); return *this; }
+    BigInt& operator+=(int64_t rhs) { add(abs_u64(rhs), rhs >= 0); return *this; }
+    BigInt& operator+=(uint64_t rhs) { add(rhs, true); return *this; }
+
+    BigInt& operator-=(int32_t rhs) { add(abs_u64(rhs), rhs < 0); return *this; }
+    BigInt& operator-=(uint32_t rhs) { add((uint64_t)rhs, false); return *this; }
+    BigInt& operator-=(int64_t rhs) { add(abs_u64(rhs), rhs < 0); return *this; }
+    BigInt& operator-=(uint64_t rhs) { add(rhs, false); return *this; }
+
+    BigInt& operator*=(int32_t rhs) { mul(abs_u64(rhs), rhs >= 0); return *this; }
+    BigInt& operator*=(uint32_t rhs) { mul((uint64_t)rhs, true); return *this; }
+    BigInt& operator*=(int64_t rhs) { mul(abs_u64(rhs), rhs >= 0); return *this; }
+    BigInt& operator*=(uint64_t rhs) { mul(rhs, true); return *this; }
+
     /// Prefix increment operator
-    BigInt& operator++() { this->operator+=(1); return *this; }
+    BigInt& operator++() { add((uint64_t)1, true); return *this; }
 
     /// Postfix increment operator
     BigInt operator++(int) { BigInt ret = *this; ++*this; return ret; }
 
     /// Prefix decrement operator
-    BigInt& operator--() { this->operator-=(1); return *this; }
+    BigInt& operator--() { add((uint64_t)1, false); return *this; }
 
     /// Postfix decrement operator
     BigInt operator--(int) { BigInt ret = *this; --*this; return ret; }
 
+    /// Умножение на 2^bits. Так как base десятичное, это умножение, а не сдвиг битов
+    BigInt operator<<(size_t bits) const;
+
+    /// Деление на 2^bits с отбрасыванием дробной части (как operator/, т.е. -5 >> 1 == -2)
+    BigInt operator>>(size_t bits) const;
+
+    BigInt& operator<<=(size_t bits);
+    BigInt& operator>>=(size_t bits);
+
+    friend BigInt pow_mod(const BigInt& value, const BigInt& exponent, const BigInt& modulus);
+    friend BigInt gcd(const BigInt& a, const BigInt& b);
+    friend BigInt isqrt(const BigInt& value);
+
+    /// Записывает число в десятичной системе
     std::string to_string() const;
+
+    /// То же, что to_string(), но строка запоминается и пересчитывается только после изменения числа.
+    /// Удобно, когда число выводится каждый кадр. Не потокобезопасно
+    const std::string& to_cached_string() const;
+
+    /// Приблизительная запись вида "1.23e456", где в мантиссе precision цифр (лишние цифры отбрасываются).
+    /// Вычисляется по старшим цифрам числа без полного преобразования в строку.
+    /// Если в числе не больше precision десятичных цифр, то возвращает to_string()
+    std::string to_abbreviated_string(size_t precision = 3) const;
 };
 
 inline BigInt operator+(int32_t lhs, const BigInt& rhs) { return BigInt(lhs) + rhs; }
@@ -122,4 +221,18 @@ inline BigInt operator""_bi(const char* str, std::size_t) { return BigInt(str);
 
 inline BigInt abs(const BigInt& value) { return value.is_negative() ? -value : value; }
 
+/// Возведение в степень. pow(x, 0) == 1
+BigInt pow(const BigInt& value, uint64_t exponent);
+
+/// value^exponent mod modulus в диапазоне [0, modulus). Промежуточные числа не длиннее модуля.
+/// Для не очень длинных модулей, взаимно простых с base (нечётных и не кратных 5), используется умножение Монтгомери.
+/// Возвращает 0, если modulus <= 0 или exponent < 0
+BigInt pow_mod(const BigInt& value, const BigInt& exponent, const BigInt& modulus);
+
+/// Наибольший общий делитель (алгоритм Лемера). Всегда неотрицательный. gcd(0, 0) == 0
+BigInt gcd(const BigInt& a, const BigInt& b);
+
+/// Целая часть квадратного корня. Возвращает 0 для отрицательных чисел
+BigInt isqrt(const BigInt& value);
+
 } // namespace dviglo
@@ -0,0 +1,945 @@
+// Copyright (c) the Dviglo project
+// License: MIT
+
+#include "dv_big_int_bin.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cctype>
+
+#if defined(_MSC_VER) && defined(_M_X64) && !defined(__clang__)
+    #include <intrin.h>
+#endif
+
+using namespace std;
+
+
+namespace dviglo
+{
+
+using Limb = BigIntBin::Limb;
+using Magnitude = vector<Limb>;
+
+// ================================= 128-битные операции =================================
+
+// Умножает 64-битные числа. Возвращает младшую половину произведения, старшую записывает в hi
+static inline Limb mul_128(Limb a, Limb b, Limb& hi)
+{
+#if defined(__SIZEOF_INT128__)
+    __extension__ using u128 = unsigned __int128;
+    u128 product = (u128)a * b;
+    hi = Limb(product >> 64);
+    return (Limb)product;
+#elif defined(_MSC_VER) && defined(_M_X64)
+    return _umul128(a, b, &hi);
+#else
+    // Умножение столбиком по 32-битным половинам
+    Limb a_lo = (uint32_t)a;
+    Limb a_hi = a >> 32;
+    Limb b_lo = (uint32_t)b;
+    Limb b_hi = b >> 32;
+
+    Limb p0 = a_lo * b_lo;
+    Limb p1 = a_lo * b_hi;
+    Limb p2 = a_hi * b_lo;
+    Limb p3 = a_hi * b_hi;
+
+    Limb middle = (p0 >> 32) + (uint32_t)p1 + (uint32_t)p2;
+    hi = p3 + (p1 >> 32) + (p2 >> 32) + (middle >> 32);
+    return (middle << 32) | (uint32_t)p0;
+#endif
+}
+
+// Делит 128-битное число (hi, lo) на divisor. Частное должно умещаться в 64 бита (hi < divisor)
+static inline Limb div_128(Limb hi, Limb lo, Limb divisor, Limb& remainder)
+{
+    assert(hi < divisor);
+
+#if defined(__SIZEOF_INT128__)
+    __extension__ using u128 = unsigned __int128;
+    u128 numerator = ((u128)hi << 64) | lo;
+    remainder = Limb(numerator % divisor);
+    return Limb(numerator / divisor);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    return _udiv128(hi, lo, divisor, &remainder);
+#else
+    // Деление столбиком по 32-битным половинам (Hacker's Delight, divlu)
+    constexpr Limb b = Limb(1) << 32;
+
+    int shift = countl_zero(divisor);
+    divisor <<= shift;
+    Limb d1 = divisor >> 32;
+    Limb d0 = (uint32_t)divisor;
+
+    Limb un32 = shift ? (hi << shift) | (lo >> (64 - shift)) : hi;
+    Limb un10 = lo << shift;
+    Limb un1 = un10 >> 32;
+    Limb un0 = (uint32_t)un10;
+
+    Limb q1 = un32 / d1;
+    Limb rhat = un32 - q1 * d1;
+
+    while (q1 >= b || q1 * d0 > b * rhat + un1)
+    {
+        --q1;
+        rhat += d1;
+
+        if (rhat >= b)
+            break;
+    }
+
+    Limb un21 = un32 * b + un1 - q1 * divisor;
+    Limb q0 = un21 / d1;
+    rhat = un21 - q0 * d1;
+
+    while (q0 >= b || q0 * d0 > b * rhat + un0)
+    {
+        --q0;
+        rhat += d1;
+
+        if (rhat >= b)
+            break;
+    }
+
+    remainder = (un21 * b + un0 - q0 * divisor) >> shift;
+    return q1 * b + q0;
+#endif
+}
+
+// a + b + carry. carry (0 или 1) обновляется
+static inline Limb add_carry(Limb a, Limb b, Limb& carry)
+{
+    Limb sum = a + b;
+    Limb carry_1 = sum < a;
+    sum += carry;
+    Limb carry_2 = sum < carry;
+    carry = carry_1 + carry_2;
+    return sum;
+}
+
+// a - b - borrow. borrow (0 или 1) обновляется
+static inline Limb sub_borrow(Limb a, Limb b, Limb& borrow)
+{
+    Limb diff = a - b;
+    Limb borrow_1 = a < b;
+    Limb borrow_2 = diff < borrow;
+    diff -= borrow;
+    borrow = borrow_1 + borrow_2;
+    return diff;
+}
+
+// ================================= Модули =================================
+
+static void trim(Magnitude& mag)
+{
+    while (mag.size() > 1 && mag.back() == 0)
+        mag.pop_back();
+}
+
+static bool is_zero(const Magnitude& mag)
+{
+    return mag.size() == 1 && mag[0] == 0;
+}
+
+// Длина модуля без ведущих нулей
+static size_t trimmed_size(const Limb* mag, size_t size)
+{
+    while (size > 0 && mag[size - 1] == 0)
+        --size;
+
+    return size;
+}
+
+// Сравнивает модули без ведущих нулей
+static strong_ordering compare(const Magnitude& a, const Magnitude& b)
+{
+    if (a.size() != b.size())
+        return a.size() <=> b.size();
+
+    for (size_t i = a.size() - 1; i != size_t(-1); --i)
+    {
+        if (a[i] != b[i])
+            return a[i] <=> b[i];
+    }
+
+    return strong_ordering::equal;
+}
+
+// dst += src (dst_size >= src_size). Возвращает перенос из старшего разряда dst
+static Limb add_to(Limb* dst, size_t dst_size, const Limb* src, size_t src_size)
+{
+    assert(dst_size >= src_size);
+
+    Limb carry = 0;
+
+    for (size_t i = 0; i < src_size; ++i)
+        dst[i] = add_carry(dst[i], src[i], carry);
+
+    for (size_t i = src_size; carry && i < dst_size; ++i)
+        dst[i] = add_carry(dst[i], 0, carry);
+
+    return carry;
+}
+
+// dst -= src. Возвращает заём из старшего разряда dst
+static Limb sub_from(Limb* dst, size_t dst_size, const Limb* src, size_t src_size)
+{
+    src_size = trimmed_size(src, src_size);
+    assert(dst_size >= src_size);
+
+    Limb borrow = 0;
+
+    for (size_t i = 0; i < src_size; ++i)
+        dst[i] = sub_borrow(dst[i], src[i], borrow);
+
+    for (size_t i = src_size; borrow && i < dst_size; ++i)
+        dst[i] = sub_borrow(dst[i], 0, borrow);
+
+    return borrow;
+}
+
+static Magnitude add_magnitudes(const Magnitude& a, const Magnitude& b)
+{
+    const Magnitude& long_mag = a.size() >= b.size() ? a : b;
+    const Magnitude& short_mag = a.size() < b.size() ? a : b;
+
+    Magnitude ret;
+    ret.reserve(long_mag.size() + 1);
+    ret = long_mag;
+
+    if (add_to(ret.data(), ret.size(), short_mag.data(), short_mag.size()))
+        ret.push_back(1);
+
+    return ret;
+}
+
+// Уменьшаемое должно быть >= вычитаемого
+static Magnitude sub_magnitudes(const Magnitude& minuend, const Magnitude& subtrahend)
+{
+    Magnitude ret = minuend;
+    Limb borrow = sub_from(ret.data(), ret.size(), subtrahend.data(), subtrahend.size());
+    assert(borrow == 0);
+    (void)borrow;
+    trim(ret);
+    return ret;
+}
+
+// ================================= Умножение =================================
+
+// Ниже этой длины (в лимбах) алгоритм Карацубы медленнее умножения столбиком
+constexpr size_t karatsuba_threshold = 32;
+
+// Результат записывается в out длиной a_size + b_size
+static void mul_schoolbook(const Limb* a, size_t a_size, const Limb* b, size_t b_size, Limb* out)
+{
+    fill(out, out + a_size + b_size, 0);
+
+    for (size_t a_index = 0; a_index < a_size; ++a_index)
+    {
+        Limb a_limb = a[a_index];
+
+        if (a_limb == 0)
+            continue;
+
+        Limb carry = 0;
+        Limb* ret = out + a_index;
+
+        for (size_t b_index = 0; b_index < b_size; ++b_index)
+        {
+            // a * b + c + d < 2^128, поэтому перенос умещается в лимб
+            Limb hi;
+            Limb lo = mul_128(a_limb, b[b_index], hi);
+            Limb add = 0;
+            lo = add_carry(lo, carry, add);
+            hi += add;
+            add = 0;
+            ret[b_index] = add_carry(lo, ret[b_index], add);
+            carry = hi + add;
+        }
+
+        ret[b_size] = carry;
+    }
+}
+
+static void mul_dispatch(const Limb* a, size_t a_size, const Limb* b, size_t b_size, Limb* out);
+
+// Алгоритм Карацубы (подробнее в dv_big_int.cpp). a_size >= b_size > a_size / 2
+static void mul_karatsuba(const Limb* a, size_t a_size, const Limb* b, size_t b_size, Limb* out)
+{
+    assert(a_size >= b_size && b_size * 2 > a_size);
+
+    size_t h = (a_size + 1) / 2;
+    size_t a1_size = a_size - h;
+    size_t b1_size = b_size - h;
+
+    mul_dispatch(a, h, b, h, out);
+    mul_dispatch(a + h, a1_size, b + h, b1_size, out + h * 2);
+
+    Magnitude a_sum(a, a + h);
+    a_sum.push_back(add_to(a_sum.data(), h, a + h, a1_size));
+    Magnitude b_sum(b, b + h);
+    b_sum.push_back(add_to(b_sum.data(), h, b + h, b1_size));
+
+    Magnitude z1(a_sum.size() + b_sum.size());
+    mul_dispatch(a_sum.data(), a_sum.size(), b_sum.data(), b_sum.size(), z1.data());
+    sub_from(z1.data(), z1.size(), out, h * 2);
+    sub_from(z1.data(), z1.size(), out + h * 2, a1_size + b1_size);
+
+    Limb carry = add_to(out + h, a_size + b_size - h, z1.data(), trimmed_size(z1.data(), z1.size()));
+    assert(carry == 0);
+    (void)carry;
+}
+
+static void mul_dispatch(const Limb* a, size_t a_size, const Limb* b, size_t b_size, Limb* out)
+{
+    size_t out_size = a_size + b_size;
+    a_size = trimmed_size(a, a_size);
+    b_size = trimmed_size(b, b_size);
+
+    if (a_size < b_size)
+    {
+        swap(a, b);
+        swap(a_size, b_size);
+    }
+
+    fill(out + a_size + b_size, out + out_size, 0);
+
+    if (b_size < karatsuba_threshold)
+    {
+        mul_schoolbook(a, a_size, b, b_size, out);
+        return;
+    }
+
+    // Сильно разные длины: режем длинный множитель на куски длиной с короткий
+    if (b_size * 2 <= a_size)
+    {
+        fill(out, out + a_size + b_size, 0);
+        Magnitude product(b_size * 2);
+
+        for (size_t begin = 0; begin < a_size; begin += b_size)
+        {
+            size_t chunk_size = min(b_size, a_size - begin);
+            mul_dispatch(a + begin, chunk_size, b, b_size, product.data());
+            add_to(out + begin, a_size + b_size - begin, product.data(), chunk_size + b_size);
+        }
+
+        return;
+    }
+
+    mul_karatsuba(a, a_size, b, b_size, out);
+}
+
+static Magnitude mul_magnitudes(const Magnitude& a, const Magnitude& b)
+{
+    Magnitude ret(a.size() + b.size());
+    mul_dispatch(a.data(), a.size(), b.data(), b.size(), ret.data());
+    trim(ret);
+    return ret;
+}
+
+// mag = mag * factor + addend
+static void mul_add_limb(Magnitude& mag, Limb factor, Limb addend)
+{
+    Limb carry = addend;
+
+    for (Limb& limb : mag)
+    {
+        Limb hi;
+        Limb lo = mul_128(limb, factor, hi);
+        Limb add = 0;
+        limb = add_carry(lo, carry, add);
+        carry = hi + add;
+    }
+
+    if (carry)
+        mag.push_back(carry);
+
+    trim(mag);
+}
+
+// ================================= Деление =================================
+
+// mag /= divisor. Возвращает остаток
+static Limb div_mod_limb(Magnitude& mag, Limb divisor)
+{
+    assert(divisor != 0);
+
+    Limb remainder = 0;
+
+    for (size_t i = mag.size() - 1; i != size_t(-1); --i)
+        mag[i] = div_128(remainder, mag[i], divisor, remainder);
+
+    trim(mag);
+    return remainder;
+}
+
+// Сдвигает влево на shift < 64 бит. Результат может стать длиннее на один лимб
+static Magnitude shift_left(const Magnitude& mag, int shift, size_t extra_limbs = 1)
+{
+    Magnitude ret(mag.size() + extra_limbs, 0);
+
+    if (shift == 0)
+    {
+        copy(mag.begin(), mag.end(), ret.begin());
+        return ret;
+    }
+
+    Limb carry = 0;
+
+    for (size_t i = 0; i < mag.size(); ++i)
+    {
+        ret[i] = (mag[i] << shift) | carry;
+        carry = mag[i] >> (64 - shift);
+    }
+
+    if (extra_limbs)
+        ret[mag.size()] = carry;
+
+    return ret;
+}
+
+// Сдвигает вправо на shift < 64 бит
+static void shift_right(Magnitude& mag, int shift)
+{
+    if (shift != 0)
+    {
+        for (size_t i = 0; i < mag.size(); ++i)
+        {
+            Limb next = i + 1 < mag.size() ? mag[i + 1] : 0;
+            mag[i] = (mag[i] >> shift) | (next << (64 - shift));
+        }
+    }
+
+    trim(mag);
+}
+
+// Деление столбиком (алгоритм D Кнута). Знаменатель не ноль
+static void div_mod_magnitudes(const Magnitude& numerator, const Magnitude& denominator,
+                               Magnitude& quotient, Magnitude& remainder)
+{
+    assert(!is_zero(denominator));
+
+    if (compare(numerator, denominator) == strong_ordering::less)
+    {
+        quotient = Magnitude{0};
+        remainder = numerator;
+        return;
+    }
+
+    if (denominator.size() == 1)
+    {
+        quotient = numerator;
+        remainder = Magnitude{div_mod_limb(quotient, denominator[0])};
+        return;
+    }
+
+    const size_t n = denominator.size();
+    const size_t m = numerator.size() - n;
+
+    // Нормализуем: старший бит знаменателя должен быть 1
+    int shift = countl_zero(denominator.back());
+    Magnitude v = shift_left(denominator, shift, 0);
+    Magnitude u = shift_left(numerator, shift, 1);
+
+    quotient.assign(m + 1, 0);
+
+    for (size_t j = m; j != size_t(-1); --j)
+    {
+        // Оцениваем цифру частного по двум старшим цифрам куска и старшей цифре знаменателя
+        Limb qhat;
+        Limb rhat;
+        bool rhat_overflow = false;
+
+        if (u[j + n] >= v[n - 1])
+        {
+            assert(u[j + n] == v[n - 1]);
+            qhat = ~Limb(0);
+            rhat = u[j + n - 1] + v[n - 1];
+            rhat_overflow = rhat < v[n - 1];
+        }
+        else
+        {
+            qhat = div_128(u[j + n], u[j + n - 1], v[n - 1], rhat);
+        }
+
+        // Уточняем по второй цифре знаменателя (цифра уменьшается максимум на 2)
+        while (!rhat_overflow)
+        {
+            Limb p_hi;
+            Limb p_lo = mul_128(qhat, v[n - 2], p_hi);
+
+            if (p_hi < rhat || (p_hi == rhat && p_lo <= u[j + n - 2]))
+                break;
+
+            --qhat;
+            rhat += v[n - 1];
+            rhat_overflow = rhat < v[n - 1];
+        }
+
+        // Кусок -= qhat * знаменатель
+        Limb mul_carry = 0;
+        Limb borrow = 0;
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            Limb hi;
+            Limb lo = mul_128(qhat, v[i], hi);
+            Limb add = 0;
+            lo = add_carry(lo, mul_carry, add);
+            mul_carry = hi + add;
+            u[i + j] = sub_borrow(u[i + j], lo, borrow);
+        }
+
+        u[j + n] = sub_borrow(u[j + n], mul_carry, borrow);
+
+        // Промах на 1 (редко): возвращаем знаменатель
+        if (borrow)
+        {
+            --qhat;
+            Limb carry = 0;
+
+            for (size_t i = 0; i < n; ++i)
+                u[i + j] = add_carry(u[i + j], v[i], carry);
+
+            u[j + n] += carry; // Перенос компенсирует заём
+        }
+
+        quotient[j] = qhat;
+    }
+
+    trim(quotient);
+
+    // Денормализуем остаток
+    u.resize(n);
+    shift_right(u, shift);
+    remainder = std::move(u);
+}
+
+// ======================= Деление на степени 10 через обратное число =======================
+
+// Ниже этой длины (в лимбах) деление столбиком быстрее
+constexpr size_t reciprocal_threshold = 48;
+
+// B^power, где B = 2^64
+static Magnitude limb_power(size_t power)
+{
+    Magnitude ret(power + 1, 0);
+    ret[power] = 1;
+    return ret;
+}
+
+// Сдвиг на целое число лимбов вправо (деление на B^limbs)
+static Magnitude shift_limbs_right(const Magnitude& mag, size_t limbs)
+{
+    if (mag.size() <= limbs)
+        return Magnitude{0};
+
+    return Magnitude(mag.begin() + limbs, mag.end());
+}
+
+// Вычисляет floor(B^(2m) / d) для нормализованного d длиной m лимбов (старший бит равен 1).
+// Итерация Ньютона x = x + x * (B^(2m) - d * x) / B^(2m) удваивает число верных цифр,
+// поэтому обратное число длиной m получается из обратного числа старшей половины d
+static Magnitude reciprocal(const Magnitude& d)
+{
+    const size_t m = d.size();
+    assert(d.back() >> 63);
+
+    const Magnitude one = limb_power(m * 2);
+
+    if (m <= reciprocal_threshold)
+    {
+        Magnitude q;
+        Magnitude r;
+        div_mod_magnitudes(one, d, q, r);
+        return q;
+    }
+
+    // Приближение по старшей половине делителя
+    size_t h = (m + 1) / 2;
+    Magnitude d_high(d.end() - h, d.end());
+    Magnitude x_high = reciprocal(d_high);
+
+    Magnitude x(m - h, 0);
+    x.insert(x.end(), x_high.begin(), x_high.end());
+
+    // Один шаг Ньютона
+    Magnitude product = mul_magnitudes(d, x);
+
+    if (compare(product, one) != strong_ordering::greater)
+    {
+        Magnitude error = sub_magnitudes(one, product);
+        x = add_magnitudes(x, shift_limbs_right(mul_magnitudes(x, error), m * 2));
+    }
+    else
+    {
+        Magnitude error = sub_magnitudes(product, one);
+        Magnitude correction = add_magnitudes(shift_limbs_right(mul_magnitudes(x, error), m * 2), Magnitude{1});
+        x = compare(x, correction) == strong_ordering::greater ? sub_magnitudes(x, correction) : Magnitude{0};
+    }
+
+    // После шага Ньютона ошибка - несколько единиц. Исправляем её
+    product = mul_magnitudes(d, x);
+
+    while (compare(product, one) == strong_ordering::greater)
+    {
+        x = sub_magnitudes(x, Magnitude{1});
+        product = sub_magnitudes(product, d);
+    }
+
+    Magnitude rest = sub_magnitudes(one, product);
+
+    while (compare(rest, d) != strong_ordering::less)
+    {
+        x = add_magnitudes(x, Magnitude{1});
+        rest = sub_magnitudes(rest, d);
+    }
+
+    return x;
+}
+
+// Степень 10 и данные для быстрого деления на неё
+struct DecimalPower
+{
+    // 10^(digits_per_limb * 2^level)
+    Magnitude value;
+
+    // Сдвиг, нормализующий value
+    int shift = 0;
+
+    // value << shift
+    Magnitude normalized;
+
+    // floor(B^(2m) / normalized), где m - длина normalized.
+    // Вычисляется при первом делении, если normalized длиннее reciprocal_threshold
+    Magnitude reciprocal;
+};
+
+// Максимальная степень 10, которая умещается в лимб
+constexpr Limb limb_decimal_base = 10'000'000'000'000'000'000u;
+constexpr size_t digits_per_limb = 19;
+
+// Степени 10^(19 * 2^level). Вычисляются по мере необходимости
+class DecimalPowers
+{
+private:
+    vector<DecimalPower> powers_;
+
+public:
+    const Magnitude& get(size_t level)
+    {
+        while (powers_.size() <= level)
+        {
+            DecimalPower power;
+
+            if (powers_.empty())
+                power.value = Magnitude{limb_decimal_base};
+            else
+                power.value = mul_magnitudes(powers_.back().value, powers_.back().value);
+
+            powers_.push_back(std::move(power));
+        }
+
+        return powers_[level].value;
+    }
+
+    // Делит число меньше 10^(19 * 2^(level + 1)) на 10^(19 * 2^level)
+    void div_mod(const Magnitude& numerator, size_t level, Magnitude& quotient, Magnitude& remainder)
+    {
+        get(level);
+        DecimalPower& power = powers_[level];
+
+        if (power.value.size() <= reciprocal_threshold)
+        {
+            div_mod_magnitudes(numerator, power.value, quotient, remainder);
+            return;
+        }
+
+        if (power.reciprocal.empty())
+        {
+            power.shift = countl_zero(power.value.back());
+            power.normalized = shift_left(power.value, power.shift, 0);
+            power.reciprocal = reciprocal(power.normalized);
+        }
+
+        const Magnitude& d = power.normalized;
+        const size_t m = d.size();
+
+        Magnitude n = shift_left(numerator, power.shift, 1);
+        trim(n);
+
+        // reciprocal <= B^(2m) / d, поэтому частное не больше точного и меньше его максимум на 2
+        quotient = shift_limbs_right(mul_magnitudes(n, power.reciprocal), m * 2);
+        remainder = sub_magnitudes(n, mul_magnitudes(quotient, d));
+
+        while (compare(remainder, d) != strong_ordering::less)
+        {
+            quotient = add_magnitudes(quotient, Magnitude{1});
+            remainder = sub_magnitudes(remainder, d);
+        }
+
+        shift_right(remainder, power.shift);
+    }
+};
+
+// Ниже этой длины (в лимбах) строка формируется делением на 10^19
+constexpr size_t to_string_threshold = 32;
+
+// Записывает в out ровно digits_per_limb * 2^(level + 1) цифр (с ведущими нулями).
+// Число должно быть меньше 10^(digits_per_limb * 2^(level + 1))
+static void to_decimal(const Magnitude& mag, size_t level, DecimalPowers& powers, char* out)
+{
+    size_t num_digits = digits_per_limb << (level + 1);
+
+    if (level == 0 || mag.size() <= to_string_threshold)
+    {
+        Magnitude rest = mag;
+        char* pos = out + num_digits;
+
+        while (!is_zero(rest))
+        {
+            Limb chunk = div_mod_limb(rest, limb_decimal_base);
+
+            for (size_t i = 0; i < digits_per_limb; ++i)
+            {
+                *--pos = char('0' + chunk % 10);
+                chunk /= 10;
+            }
+        }
+
+        fill(out, pos, '0');
+        return;
+    }
+
+    // mag = high * 10^(num_digits / 2) + low
+    Magnitude high;
+    Magnitude low;
+    powers.div_mod(mag, level, high, low);
+
+    to_decimal(high, level - 1, powers, out);
+    to_decimal(low, level - 1, powers, out + num_digits / 2);
+}
+
+// Ниже этой длины (в символах) строка преобразуется умножением на 10^19
+constexpr size_t parse_threshold = digits_per_limb * 32;
+
+// Строка должна состоять только из цифр
+static Magnitude parse_decimal(const char* str, size_t length, DecimalPowers& powers)
+{
+    if (length <= parse_threshold)
+    {
+        Magnitude ret{0};
+
+        // Первый кусок может быть неполным
+        size_t chunk_length = length % digits_per_limb;
+        if (chunk_length == 0)
+            chunk_length = digits_per_limb;
+
+        Limb multiplier = 1;
+        for (size_t i = 0; i < chunk_length; ++i)
+            multiplier *= 10;
+
+        for (size_t pos = 0; pos < length; pos += chunk_length, chunk_length = digits_per_limb, multiplier = limb_decimal_base)
+        {
+            Limb chunk = 0;
+
+            for (size_t i = 0; i < chunk_length; ++i)
+                chunk = chunk * 10 + Limb(str[pos + i] - '0');
+
+            mul_add_limb(ret, multiplier, chunk);
+        }
+
+        return ret;
+    }
+
+    // Младшая часть - максимальная степень двойки кусков, меньшая длины
+    size_t level = 0;
+    while ((digits_per_limb << (level + 1)) < length)
+        ++level;
+
+    size_t low_length = digits_per_limb << level;
+
+    Magnitude high = parse_decimal(str, length - low_length, powers);
+    Magnitude low = parse_decimal(str + length - low_length, low_length, powers);
+
+    return add_magnitudes(mul_magnitudes(high, powers.get(level)), low);
+}
+
+// ================================= BigIntBin =================================
+
+BigIntBin::BigIntBin()
+    : positive_(true)
+    , magnitude_{0}
+{
+}
+
+BigIntBin::BigIntBin(int32_t value)
+    : BigIntBin((int64_t)value)
+{
+}
+
+BigIntBin::BigIntBin(uint32_t value)
+    : BigIntBin((uint64_t)value)
+{
+}
+
+BigIntBin::BigIntBin(int64_t value)
+{
+    positive_ = value >= 0;
+
+    // Обходим undefined behavior в std::abs(INT64_MIN)
+    magnitude_.push_back(positive_ ? (Limb)value : Limb(0) - (Limb)value);
+}
+
+BigIntBin::BigIntBin(uint64_t value)
+    : positive_(true)
+    , magnitude_{value}
+{
+}
+
+BigIntBin::BigIntBin(const string& str)
+    : BigIntBin()
+{
+    size_t first_digit_pos = 0;
+    bool positive = true;
+
+    if (!str.empty() && (str[0] == '-' || str[0] == '+'))
+    {
+        positive = str[0] == '+';
+        first_digit_pos = 1;
+    }
+
+    // Проверяем, что после знака только цифры
+    for (size_t i = first_digit_pos; i < str.length(); ++i)
+    {
+        if (!isdigit((unsigned char)str[i]))
+            return;
+    }
+
+    // Пропускаем ведущие нули
+    while (first_digit_pos < str.length() && str[first_digit_pos] == '0')
+        ++first_digit_pos;
+
+    if (first_digit_pos == str.length())
+        return;
+
+    DecimalPowers powers;
+    magnitude_ = parse_decimal(str.data() + first_digit_pos, str.length() - first_digit_pos, powers);
+    positive_ = positive;
+}
+
+bool BigIntBin::is_zero() const
+{
+    return dviglo::is_zero(magnitude_);
+}
+
+void BigIntBin::set_positive(bool positive)
+{
+    if (!is_zero()) // Ноль всегда положительный
+        positive_ = positive;
+}
+
+strong_ordering BigIntBin::operator<=>(const BigIntBin& rhs) const
+{
+    if (positive_ != rhs.positive_)
+        return positive_ ? strong_ordering::greater : strong_ordering::less;
+
+    strong_ordering ret = compare(magnitude_, rhs.magnitude_);
+
+    // У отрицательных чисел больше то, у которого модуль меньше
+    return positive_ ? ret : 0 <=> ret;
+}
+
+BigIntBin BigIntBin::operator+(const BigIntBin& rhs) const
+{
+    BigIntBin ret;
+
+    if (positive_ == rhs.positive_)
+    {
+        ret.positive_ = positive_;
+        ret.magnitude_ = add_magnitudes(magnitude_, rhs.magnitude_);
+    }
+    else if (compare(magnitude_, rhs.magnitude_) == strong_ordering::less)
+    {
+        ret.magnitude_ = sub_magnitudes(rhs.magnitude_, magnitude_);
+        ret.set_positive(rhs.positive_);
+    }
+    else
+    {
+        ret.magnitude_ = sub_magnitudes(magnitude_, rhs.magnitude_);
+        ret.set_positive(positive_);
+    }
+
+    return ret;
+}
+
+BigIntBin BigIntBin::operator-(const BigIntBin& rhs) const
+{
+    return *this + (-rhs);
+}
+
+BigIntBin BigIntBin::operator*(const BigIntBin& rhs) const
+{
+    BigIntBin ret;
+    ret.magnitude_ = mul_magnitudes(magnitude_, rhs.magnitude_);
+    ret.set_positive(positive_ == rhs.positive_);
+    return ret;
+}
+
+BigIntBin BigIntBin::operator/(const BigIntBin& rhs) const
+{
+    if (rhs.is_zero())
+        return BigIntBin();
+
+    BigIntBin ret;
+    Magnitude remainder;
+    div_mod_magnitudes(magnitude_, rhs.magnitude_, ret.magnitude_, remainder);
+
+    // Знаки как у встроенных типов (см. BigInt::operator/())
+    ret.set_positive(positive_ == rhs.positive_);
+    return ret;
+}
+
+BigIntBin BigIntBin::operator%(const BigIntBin& rhs) const
+{
+    if (rhs.is_zero())
+        return BigIntBin();
+
+    BigIntBin ret;
+    Magnitude quotient;
+    div_mod_magnitudes(magnitude_, rhs.magnitude_, quotient, ret.magnitude_);
+
+    // Знак остатка совпадает со знаком числителя
+    ret.set_positive(positive_);
+    return ret;
+}
+
+BigIntBin BigIntBin::operator-() const
+{
+    BigIntBin ret = *this;
+    ret.set_positive(!positive_);
+    return ret;
+}
+
+string BigIntBin::to_string() const
+{
+    DecimalPowers powers;
+
+    // Выбираем уровень, при котором число меньше 10^(19 * 2^(level + 1))
+    size_t level = 0;
+    while (compare(magnitude_, powers.get(level + 1)) != strong_ordering::less)
+        ++level;
+
+    string digits(digits_per_limb << (level + 1), '0');
+    to_decimal(magnitude_, level, powers, digits.data());
+
+    // Убираем ведущие нули
+    size_t first_digit_pos = min(digits.find_first_not_of('0'), digits.size() - 1);
+
+    string ret = positive_ ? string() : string("-");
+    ret.append(digits, first_digit_pos);
+    return ret;
+}
+
+} // namespace dviglo
@@ -0,0 +1,78 @@
+// Copyright (c) the Dviglo project
+// License: MIT
+
+#pragma once
+
+#include <compare>
+#include <cstdint> // uint64_t, ...
+#include <string>
+#include <vector>
+
+
+namespace dviglo
+{
+
+/// Длинное число с цифрами (лимбами) по основанию 2^64.
+/// В отличие от BigInt, сложение и умножение используют все биты машинного слова
+/// и переносы без деления на base. Зато преобразование в строку и обратно требует
+/// деления и умножения на степени 10 (используются алгоритмы "разделяй и властвуй")
+class BigIntBin
+{
+public:
+    /// Отдельная цифра длинного числа
+    using Limb = uint64_t;
+
+private:
+    /// Знак числа (ноль всегда положительный)
+    bool positive_;
+
+    /// Цифры числа в обратном порядке. Всегда содержит как минимум одну цифру
+    std::vector<Limb> magnitude_;
+
+public:
+    /// Инициализирует нулём
+    BigIntBin();
+
+    BigIntBin(int32_t value);
+    BigIntBin(uint32_t value);
+    BigIntBin(int64_t value);
+    BigIntBin(uint64_t value);
+
+    /// Некорректная строка преобразуется в 0
+    BigIntBin(const std::string& str);
+
+    bool is_zero() const;
+    bool is_positive() const { return positive_; }
+    bool is_negative() const { return !positive_; }
+    void set_positive(bool positive);
+
+    /// Число цифр (лимбов)
+    size_t size() const { return magnitude_.size(); }
+
+    bool operator==(const BigIntBin& rhs) const { return positive_ == rhs.positive_ && magnitude_ == rhs.magnitude_; }
+    std::strong_ordering operator<=>(const BigIntBin& rhs) const;
+
+    BigIntBin operator+(const BigIntBin& rhs) const;
+    BigIntBin operator-(const BigIntBin& rhs) const;
+    BigIntBin operator*(const BigIntBin& rhs) const;
+
+    /// Возвращает 0, если rhs ноль
+    BigIntBin operator/(const BigIntBin& rhs) const;
+
+    /// Возвращает 0, если rhs ноль
+    BigIntBin operator%(const BigIntBin& rhs) const;
+
+    BigIntBin operator-() const;
+
+    BigIntBin& operator+=(const BigIntBin& rhs) { return *this = *this + rhs; }
+    BigIntBin& operator-=(const BigIntBin& rhs) { return *this = *this - rhs; }
+    BigIntBin& operator*=(const BigIntBin& rhs) { return *this = *this * rhs; }
+    BigIntBin& operator/=(const BigIntBin& rhs) { return *this = *this / rhs; }
+    BigIntBin& operator%=(const BigIntBin& rhs) { return *this = *this % rhs; }
+
+    std::string to_string() const;
+};
+
+inline BigIntBin abs(const BigIntBin& value) { return value.is_negative() ? -value : value; }
+
+} // namespace dviglo
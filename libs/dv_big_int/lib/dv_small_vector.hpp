@@ -0,0 +1,208 @@
+// Copyright (c) the Dviglo project
+// License: MIT
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstring> // memcpy, memmove
+#include <initializer_list>
+#include <type_traits>
+
+
+namespace dviglo
+{
+
+/// Упрощённый аналог std::vector, который хранит до inline_capacity элементов внутри объекта,
+/// не выделяя память в куче. Если элементов больше, то они переносятся в кучу.
+/// Ёмкость никогда не уменьшается, поэтому повторное использование объекта не выделяет память.
+/// Только для тривиально копируемых типов
+template<typename T, size_t inline_capacity>
+class SmallVector
+{
+    static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_default_constructible_v<T>);
+    static_assert(inline_capacity > 0);
+
+private:
+    /// Указывает либо на inline_, либо на память в куче
+    T* data_ = inline_;
+
+    size_t size_ = 0;
+    size_t capacity_ = inline_capacity;
+
+    T inline_[inline_capacity];
+
+    bool is_inline() const { return data_ == inline_; }
+
+    /// Увеличивает ёмкость без сохранения элементов
+    void grow_discard(size_t capacity)
+    {
+        if (capacity <= capacity_)
+            return;
+
+        if (!is_inline())
+            delete[] data_;
+
+        data_ = new T[capacity];
+        capacity_ = capacity;
+    }
+
+    /// Забирает содержимое other и оставляет other пустым
+    void move_from(SmallVector& other)
+    {
+        // Если у other нет памяти в куче, то элементы приходится копировать
+        if (other.is_inline())
+        {
+            assign(other.begin(), other.end());
+            other.size_ = 0;
+            return;
+        }
+
+        if (!is_inline())
+            delete[] data_;
+
+        data_ = other.data_;
+        size_ = other.size_;
+        capacity_ = other.capacity_;
+
+        other.data_ = other.inline_;
+        other.size_ = 0;
+        other.capacity_ = inline_capacity;
+    }
+
+public:
+    using value_type = T;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    SmallVector() = default;
+
+    /// Новые элементы заполняются нулями (как в std::vector)
+    explicit SmallVector(size_t size) { resize(size); }
+
+    SmallVector(size_t size, const T& value) { assign(size, value); }
+    SmallVector(const T* first, const T* last) { assign(first, last); }
+    SmallVector(std::initializer_list<T> list) { assign(list.begin(), list.end()); }
+    SmallVector(const SmallVector& other) { assign(other.begin(), other.end()); }
+    SmallVector(SmallVector&& other) noexcept { move_from(other); }
+
+    ~SmallVector()
+    {
+        if (!is_inline())
+            delete[] data_;
+    }
+
+    SmallVector& operator=(const SmallVector& other)
+    {
+        if (this != &other)
+            assign(other.begin(), other.end());
+
+        return *this;
+    }
+
+    SmallVector& operator=(SmallVector&& other) noexcept
+    {
+        if (this != &other)
+            move_from(other);
+
+        return *this;
+    }
+
+    bool operator==(const SmallVector& rhs) const { return std::equal(begin(), end(), rhs.begin(), rhs.end()); }
+
+    size_t size() const { return size_; }
+    size_t capacity() const { return capacity_; }
+    bool empty() const { return size_ == 0; }
+
+    T* data() { return data_; }
+    const T* data() const { return data_; }
+
+    T* begin() { return data_; }
+    const T* begin() const { return data_; }
+    T* end() { return data_ + size_; }
+    const T* end() const { return data_ + size_; }
+
+    T& operator[](size_t index) { assert(index < size_); return data_[index]; }
+    const T& operator[](size_t index) const { assert(index < size_); return data_[index]; }
+
+    T& front() { assert(size_); return data_[0]; }
+    const T& front() const { assert(size_); return data_[0]; }
+    T& back() { assert(size_); return data_[size_ - 1]; }
+    const T& back() const { assert(size_); return data_[size_ - 1]; }
+
+    void reserve(size_t capacity)
+    {
+        if (capacity <= capacity_)
+            return;
+
+        T* new_data = new T[capacity];
+
+        if (size_)
+            std::memcpy(new_data, data_, size_ * sizeof(T));
+
+        if (!is_inline())
+            delete[] data_;
+
+        data_ = new_data;
+        capacity_ = capacity;
+    }
+
+    void resize(size_t size, const T& value = T())
+    {
+        if (size > capacity_)
+            reserve(std::max(size, capacity_ * 2));
+
+        if (size > size_)
+            std::fill(data_ + size_, data_ + size, value);
+
+        size_ = size;
+    }
+
+    void clear() { size_ = 0; }
+
+    void push_back(const T& value)
+    {
+        if (size_ == capacity_)
+        {
+            // value может ссылаться на элемент этого же вектора
+            T copy = value;
+            reserve(capacity_ * 2);
+            data_[size_++] = copy;
+            return;
+        }
+
+        data_[size_++] = value;
+    }
+
+    void pop_back()
+    {
+        assert(size_);
+        --size_;
+    }
+
+    void assign(size_t size, const T& value)
+    {
+        T copy = value;
+        grow_discard(size);
+        std::fill(data_, data_ + size, copy);
+        size_ = size;
+    }
+
+    void assign(const T* first, const T* last)
+    {
+        size_t size = last - first;
+
+        if (size > capacity_)
+        {
+            // Диапазон не может быть частью этого вектора, так как он длиннее ёмкости
+            grow_discard(size);
+        }
+
+        if (size)
+            std::memmove(data_, first, size * sizeof(T));
+
+        size_ = size;
+    }
+};
+
+} // namespace dviglo
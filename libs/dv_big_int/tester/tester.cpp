@@ -4,9 +4,12 @@
 #include "force_assert.hpp"
 
 #include <dv_big_int.hpp>
+#include <dv_big_int_bin.hpp>
 
 #include <chrono>
+#include <cstdlib> // malloc, free
 #include <iostream>
+#include <new>
 
 using namespace dviglo;
 using namespace std;
@@ -16,6 +19,29 @@ using namespace std;
     #pragma warning(disable: 4146)
 #endif
 
+// Число выделений памяти в куче. Нужно, чтобы проверять, что операции с короткими числами не выделяют память
+static size_t num_allocations = 0;
+
+void* operator new(size_t size)
+{
+    ++num_allocations;
+
+    if (void* ptr = malloc(size))
+        return ptr;
+
+    throw bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    free(ptr);
+}
+
 void run()
 {
     // BigInt()
@@ -133,6 +159,46 @@ void run()
                       "00000000000000000000000000000000000000000000000000000000000000000001");
     }
 
+    // Все алгоритмы умножения дают одинаковый результат
+    {
+        const BigInt::MulThresholds default_thresholds = BigInt::mul_thresholds;
+
+        // Пороги, при которых алгоритм используется уже для коротких чисел
+        const BigInt::MulThresholds schoolbook{SIZE_MAX, SIZE_MAX, SIZE_MAX};
+        const BigInt::MulThresholds karatsuba{2, SIZE_MAX, SIZE_MAX};
+        const BigInt::MulThresholds toom3{2, 3, SIZE_MAX};
+        const BigInt::MulThresholds ntt{2, 3, 4};
+
+        // Длины множителей. Есть сильно различающиеся длины
+        const pair<size_t, size_t> sizes[] = {{1, 1}, {2, 1}, {5, 3}, {17, 17}, {40, 39}, {100, 37},
+                                              {150, 150}, {301, 200}, {1000, 999}, {2000, 10}};
+
+        for (auto [a_size, b_size] : sizes)
+        {
+            BigInt a = BigInt::generate(a_size);
+            BigInt b = -BigInt::generate(b_size);
+
+            // Максимум переносов: все цифры равны base - 1
+            BigInt c(string(a_size * BigInt::chunk_length, '9'));
+
+            BigInt::mul_thresholds = schoolbook;
+            BigInt ab = a * b;
+            BigInt aa = a * a;
+            BigInt cc = c * c;
+
+            for (const BigInt::MulThresholds& thresholds : {karatsuba, toom3, ntt, default_thresholds})
+            {
+                BigInt::mul_thresholds = thresholds;
+                assert(a * b == ab);
+                assert(b * a == ab);
+                assert(a * a == aa);
+                assert(c * c == cc);
+            }
+        }
+
+        BigInt::mul_thresholds = default_thresholds;
+    }
+
     // Деление
     assert(("0"_bi / "-0"_bi).to_string() == "0");
     assert(("0"_bi % "0"_bi).to_string() == "0");
@@ -217,6 +283,59 @@ void run()
     }
 #endif
 
+    // div_mod() и все алгоритмы деления дают одинаковый результат
+    {
+        const BigInt::DivThresholds default_thresholds = BigInt::div_thresholds;
+
+        // Пороги, при которых алгоритм используется уже для коротких чисел.
+        // Метод Ньютона используется, только если частное длиннее знаменателя минимум в 4 раза
+        const BigInt::DivThresholds knuth{SIZE_MAX, SIZE_MAX};
+        const BigInt::DivThresholds burnikel_ziegler{2, SIZE_MAX};
+        const BigInt::DivThresholds newton{2, 2};
+
+        // Длины числителя и знаменателя
+        const pair<size_t, size_t> sizes[] = {{2, 2}, {5, 2}, {9, 2}, {9, 4}, {40, 17}, {100, 20}, {301, 150},
+                                              {500, 100}, {1000, 999}, {2000, 700}, {3000, 1000}};
+
+        for (auto [a_size, b_size] : sizes)
+        {
+            BigInt a = -BigInt::generate(a_size);
+            BigInt b = BigInt::generate(b_size);
+
+            // Все цифры равны base - 1 (максимум заёмов)
+            BigInt c(string(a_size * BigInt::chunk_length, '9'));
+            BigInt d(string(b_size * BigInt::chunk_length, '9'));
+
+            // Степень base (старшая цифра - 1, нужна максимальная нормализация)
+            BigInt e("1" + string((b_size - 1) * BigInt::chunk_length, '0'));
+
+            BigInt::div_thresholds = knuth;
+            pair<BigInt, BigInt> ab = a.div_mod(b);
+            pair<BigInt, BigInt> cd = c.div_mod(d);
+            pair<BigInt, BigInt> ce = c.div_mod(e);
+
+            assert(ab.first * b + ab.second == a);
+            assert(abs(ab.second) < b);
+            assert(ab.second.is_zero() || ab.second.is_negative());
+            assert(cd.first * d + cd.second == c);
+            assert(cd.second < d);
+            assert(ce.first * e + ce.second == c);
+            assert(ce.second < e);
+
+            for (const BigInt::DivThresholds& thresholds : {burnikel_ziegler, newton, default_thresholds})
+            {
+                BigInt::div_thresholds = thresholds;
+                assert(a.div_mod(b) == ab);
+                assert(a / b == ab.first);
+                assert(a % b == ab.second);
+                assert(c.div_mod(d) == cd);
+                assert(c.div_mod(e) == ce);
+            }
+        }
+
+        BigInt::div_thresholds = default_thresholds;
+    }
+
     {
         // https://en.cppreference.com/w/cpp/language/operator_arithmetic#Built-in_multiplicative_operators
         // (a/b)*b + a%b == a
@@ -263,6 +382,64 @@ void run()
     }
 #endif
 
+    // BigIntBin
+    assert(BigIntBin().to_string() == "0");
+    assert(BigIntBin(-1).to_string() == "-1");
+    assert(BigIntBin(-0x7FFFFFFFFFFFFFFF - 1).to_string() == "-9223372036854775808");
+    assert(BigIntBin(0xFFFFFFFFFFFFFFFF).to_string() == "18446744073709551615");
+    assert(BigIntBin("").to_string() == "0");
+    assert(BigIntBin("-").to_string() == "0");
+    assert(BigIntBin("1abc").to_string() == "0");
+    assert(BigIntBin("-000").to_string() == "0");
+    assert(BigIntBin("-0001230000").to_string() == "-1230000");
+    assert(BigIntBin("18446744073709551616").to_string() == "18446744073709551616");
+    assert((BigIntBin(0xFFFFFFFFFFFFFFFF) + 1).to_string() == "18446744073709551616");
+    assert((BigIntBin("18446744073709551616") - 1).to_string() == "18446744073709551615");
+    assert((BigIntBin(-7) / 3).to_string() == "-2");
+    assert((BigIntBin(-7) % 3).to_string() == "-1");
+    assert((BigIntBin(7) / 0).is_zero());
+    assert(BigIntBin(-10) < BigIntBin(-2));
+
+    // BigIntBin и BigInt дают одинаковый результат
+    {
+        const pair<size_t, size_t> sizes[] = {{1, 1}, {3, 2}, {10, 10}, {50, 7}, {90, 80}, {200, 130}, {700, 20}};
+
+        for (auto [a_size, b_size] : sizes)
+        {
+            BigInt a = BigInt::generate(a_size);
+            BigInt b = -BigInt::generate(b_size);
+
+            BigIntBin a_bin(a.to_string());
+            BigIntBin b_bin(b.to_string());
+            assert(a_bin.to_string() == a.to_string());
+            assert(b_bin.to_string() == b.to_string());
+
+            assert((a_bin + b_bin).to_string() == (a + b).to_string());
+            assert((a_bin - b_bin).to_string() == (a - b).to_string());
+            assert((a_bin * b_bin).to_string() == (a * b).to_string());
+            assert((a_bin / b_bin).to_string() == (a / b).to_string());
+            assert((a_bin % b_bin).to_string() == (a % b).to_string());
+            assert((b_bin / a_bin).to_string() == (b / a).to_string());
+        }
+
+        // Длинные числа преобразуются алгоритмами "разделяй и властвуй"
+        for (size_t size : {1000, 5000, 20000})
+        {
+            BigInt a = BigInt::generate(size);
+            BigInt b = BigInt::generate(size / 3);
+            string a_str = a.to_string();
+            BigIntBin a_bin(a_str);
+            assert(a_bin.to_string() == a_str);
+            assert((a_bin * BigIntBin(b.to_string())).to_string() == (a * b).to_string());
+
+            // Степени 10 и числа из одних девяток - граничные случаи деления на степени 10
+            string power = "1" + string(size * BigInt::chunk_length, '0');
+            assert(BigIntBin(power).to_string() == power);
+            string nines(size * BigInt::chunk_length, '9');
+            assert(BigIntBin(nines).to_string() == nines);
+        }
+    }
+
     // Дополнительные операторы
     {
         BigInt bi = 1;
@@ -277,8 +454,537 @@ void run()
         assert((bi += 10).to_string() == "11");
         assert((bi -= 2).to_string() == "9");
         assert((bi *= 2).to_string() == "18");
+        assert((bi -= 20).to_string() == "-2");
+        assert((bi *= -3).to_string() == "6");
+        assert((bi -= 6u).to_string() == "0" && bi.is_positive());
+        assert((--bi).to_string() == "-1");
+        assert((++bi).to_string() == "0" && bi.is_positive());
+        assert((bi += uint64_t(18446744073709551615u)).to_string() == "18446744073709551615");
+        assert((bi += int64_t(-9223372036854775807 - 1)).to_string() == "9223372036854775807");
+        assert((bi *= uint32_t(4294967295u)).to_string() == "39614081247908796755622232065");
+        assert((bi *= 0).to_string() == "0" && bi.is_positive());
+    }
+
+    // Отрицательное число, ставшее нулём при умножении или делении на месте, становится положительным
+    {
+        BigInt bi = -5;
+        assert((bi *= BigInt(0)).to_string() == "0" && bi.is_positive());
+
+        bi = -7;
+        assert((bi /= BigInt(10)).to_string() == "0" && bi.is_positive());
+
+        bi = "-123456789012345678901234567890"_bi;
+        assert((bi *= int32_t(0)).to_string() == "0" && bi.is_positive());
+
+        bi = -9;
+        assert((bi *= int64_t(0)).to_string() == "0" && bi.is_positive());
+
+        bi = -3;
+        assert((bi *= "-0"_bi).to_string() == "0" && bi.is_positive());
+
+        bi = -7;
+        assert((bi /= -10).to_string() == "0" && bi.is_positive());
+    }
+
+    // Преобразование в строку и обратно
+    {
+        // Все цифры на всех позициях куска
+        string str = "1";
+
+        for (size_t i = 0; i < 100; ++i)
+            str += char('0' + (i * 7) % 10);
+
+        for (size_t length = 1; length <= str.size(); ++length)
+        {
+            string part = str.substr(0, length);
+            assert(BigInt(part).to_string() == part);
+            assert(BigInt("-" + part).to_string() == "-" + part);
+        }
+
+        assert(BigInt("+000123456789012345678").to_string() == "123456789012345678");
+        assert(BigInt("12a3").to_string() == "0");
+    }
+
+    // Кэшированная строка пересчитывается только после изменения числа
+    {
+        BigInt bi("123456789012345678901234567890");
+        const string& cached = bi.to_cached_string();
+        assert(cached == "123456789012345678901234567890");
+        assert(&bi.to_cached_string() == &cached);
+        assert(bi.to_string() == cached);
+
+        bi += 10;
+        assert(bi.to_cached_string() == "123456789012345678901234567900");
+        bi.set_positive(false);
+        assert(bi.to_cached_string() == "-123456789012345678901234567900");
+        bi *= -2;
+        assert(bi.to_cached_string() == "246913578024691357802469135800");
+        bi /= 100;
+        assert(bi.to_cached_string() == "2469135780246913578024691358");
+        bi %= 1000;
+        assert(bi.to_cached_string() == "358");
+        bi = "-7"_bi;
+        assert(bi.to_cached_string() == "-7");
+        --bi;
+        assert(bi.to_cached_string() == "-8");
+    }
+
+    // Приблизительная запись
+    {
+        assert(BigInt(0).to_abbreviated_string() == "0");
+        assert(BigInt(123).to_abbreviated_string() == "123");
+        assert(BigInt(-1234).to_abbreviated_string() == "-1.23e3");
+        assert(BigInt(1000).to_abbreviated_string(1) == "1e3");
+        assert("99999999999999999999"_bi.to_abbreviated_string(5) == "9.9999e19");
+        assert("12345678901234567890123"_bi.to_abbreviated_string(20) == "1.2345678901234567890e22");
+        assert("12345678901234567890123"_bi.to_abbreviated_string(23) == "12345678901234567890123");
+
+        BigInt big = BigInt("1" + string(455, '0')) * 123 + 456;
+        assert(big.to_abbreviated_string() == "1.23e457");
+        assert((-big).to_abbreviated_string(4) == "-1.230e457");
+    }
+
+    // Составные операторы работают на месте и дают тот же результат, что и обычные
+    {
+        const size_t sizes[] = {1, 2, 3, 4, 5, 30, 200};
+
+        for (size_t a_size : sizes)
+        {
+            for (size_t b_size : sizes)
+            {
+                BigInt a = BigInt::generate(a_size);
+                BigInt b = -BigInt::generate(b_size);
+                BigInt c(string(a_size * BigInt::chunk_length, '9')); // Максимум переносов
+
+                BigInt x = a;
+                assert((x += b) == a + b);
+                assert((x -= b) == a);
+                assert((x -= a) == 0 && x.is_positive());
+                assert((x -= b) == -b);
+                assert((x *= a) == -b * a);
+                assert((x /= b) == -a);
+                assert((x %= b) == -a % b);
+
+                x = c;
+                assert((x += c) == c * 2);
+                assert((x += 1) == c * 2 + 1);
+                assert((x -= c) == c + 1);
+                assert((x -= 1u) == c);
+                assert((x *= 1'000'000'007u) == c * BigInt(1'000'000'007u));
+                assert((x /= 7) == c * BigInt(1'000'000'007u) / 7);
+                assert((x %= 1000) == c * BigInt(1'000'000'007u) / 7 % 1000);
+            }
+        }
+
+        // Операнд совпадает с результатом
+        BigInt a = BigInt::generate(100);
+        BigInt x = a;
+        assert((x += x) == a * 2);
+        assert((x *= x) == a * a * 4);
+        assert((x -= x) == 0);
+    }
+
+    // Короткие числа хранятся внутри объекта, поэтому операции с ними не выделяют память
+    {
+        BigInt gold = 12345;
+        BigInt power = "999999999999"_bi;
+
+        size_t allocations_before = num_allocations;
+
+        for (size_t i = 0; i < 1000; ++i)
+        {
+            gold += power;
+            ++power;
+            gold -= 5;
+            gold *= 3u;
+            gold /= 3;
+            gold += uint64_t(123456789);
+        }
+
+        BigInt sum = gold + power;
+        BigInt difference = gold - power;
+        BigInt product = gold * 7;
+        BigInt quotient = gold / 1000;
+        BigInt remainder = gold % 1000;
+
+        // В тестовых конфигурациях с маленьким base числа не умещаются внутри объекта
+        if (BigInt::base == 1'000'000'000)
+            assert(num_allocations == allocations_before);
+
+        assert(sum - difference == power * 2);
+        assert(quotient * 1000 + remainder == gold);
+        assert(product == gold * 7);
     }
+
+    // Сдвиги
+    {
+        assert((BigInt(1) << 100).to_string() == "1267650600228229401496703205376");
+        assert(("1267650600228229401496703205376"_bi >> 100).to_string() == "1");
+        assert((BigInt(-5) >> 1).to_string() == "-2");
+        assert((BigInt(-1) >> 1).to_string() == "0" && (BigInt(-1) >> 1).is_positive());
+        assert((BigInt(0) << 10).to_string() == "0");
+        assert((BigInt(7) >> 0).to_string() == "7");
+
+        for (size_t bits : {1, 9, 29, 30, 64, 1000, 5000})
+        {
+            BigInt a = BigInt::generate(50);
+            BigInt power = pow(BigInt(2), bits);
+            assert((a << bits) == a * power);
+            assert((a >> bits) == a / power);
+            assert((-a >> bits) == -a / power);
+
+            BigInt x = a;
+            assert((x <<= bits) == a * power);
+            assert((x >>= bits) == a);
+        }
+    }
+
+    // Возведение в степень
+    {
+        assert(pow(BigInt(0), 0).to_string() == "1");
+        assert(pow(BigInt(0), 5).to_string() == "0");
+        assert(pow(BigInt(-3), 3).to_string() == "-27");
+        assert(pow(BigInt(10), 30).to_string() == "1" + string(30, '0'));
+        assert(pow(BigInt(2), 64).to_string() == "18446744073709551616");
+    }
+
+    // Возведение в степень по модулю
+    {
+        // Наивная реализация для проверки
+        auto naive_pow_mod = [](BigInt value, BigInt exponent, const BigInt& modulus)
+        {
+            BigInt ret = 1;
+            value %= modulus;
+
+            if (value.is_negative())
+                value += modulus;
+
+            while (!exponent.is_zero())
+            {
+                if (exponent % 2 == 1)
+                    ret = ret * value % modulus;
+
+                exponent /= 2;
+                value = value * value % modulus;
+            }
+
+            return ret % modulus;
+        };
+
+        assert(pow_mod(4, 13, 497).to_string() == "445");
+        assert(pow_mod(2, 10, 1000).to_string() == "24");
+        assert(pow_mod(-2, 3, 7).to_string() == "6");
+        assert(pow_mod(5, 0, 7).to_string() == "1");
+        assert(pow_mod(5, 0, 1).to_string() == "0");
+        assert(pow_mod(5, 3, 0).to_string() == "0");
+        assert(pow_mod(5, -3, 7).to_string() == "0");
+
+        // Малая теорема Ферма: 2^(p - 1) mod p == 1 для простого p = 2^127 - 1
+        BigInt p = pow(BigInt(2), 127) - 1;
+        assert(pow_mod(2, p - 1, p) == 1);
+
+        // Модули, взаимно простые с base (Монтгомери), и чётные (обычное деление)
+        for (size_t size : {1, 2, 3, 10, 40})
+        {
+            for (size_t i = 0; i < 8; ++i)
+            {
+                BigInt modulus = BigInt::generate(size);
+                BigInt value = BigInt::generate(size * 2);
+                BigInt exponent = BigInt::generate(i % 4 + 1);
+
+                if (i % 2)
+                    value = -value;
+
+                assert(pow_mod(value, exponent, modulus) == naive_pow_mod(value, exponent, modulus));
+            }
+        }
+    }
+
+    // НОД
+    {
+        auto naive_gcd = [](BigInt a, BigInt b)
+        {
+            a = abs(a);
+            b = abs(b);
+
+            while (!b.is_zero())
+            {
+                BigInt r = a % b;
+                a = b;
+                b = r;
+            }
+
+            return a;
+        };
+
+        assert(gcd(0, 0).to_string() == "0");
+        assert(gcd(0, -12).to_string() == "12");
+        assert(gcd(-12, 18).to_string() == "6");
+        assert(gcd("123456789012345678901234567890"_bi, "987654321098765432109876543210"_bi).to_string()
+               == "9000000000900000000090");
+
+        // Соседние числа Фибоначчи - худший случай для алгоритма Евклида
+        BigInt f1 = 1, f2 = 1;
+
+        for (size_t i = 0; i < 1000; ++i)
+        {
+            BigInt f3 = f1 + f2;
+            f1 = f2;
+            f2 = f3;
+        }
+
+        assert(gcd(f1, f2) == 1);
+
+        for (size_t a_size : {1, 3, 10, 50, 300})
+        {
+            for (size_t b_size : {1, 3, 10, 50, 300})
+            {
+                BigInt common = BigInt::generate(b_size / 2 + 1);
+                BigInt a = BigInt::generate(a_size) * common;
+                BigInt b = -BigInt::generate(b_size) * common;
+                assert(gcd(a, b) == naive_gcd(a, b));
+                assert(gcd(b, a) == naive_gcd(a, b));
+            }
+        }
+    }
+
+    // Целая часть квадратного корня
+    {
+        assert(isqrt(-4).to_string() == "0");
+        assert(isqrt(0).to_string() == "0");
+        assert(isqrt(15).to_string() == "3");
+        assert(isqrt(16).to_string() == "4");
+        assert(isqrt("100000000000000000000000000000000000000000000"_bi).to_string() == "10000000000000000000000");
+
+        for (size_t size : {1, 2, 3, 4, 5, 20, 101, 500})
+        {
+            BigInt value = BigInt::generate(size);
+            BigInt root = isqrt(value);
+            assert(root * root <= value && (root + 1) * (root + 1) > value);
+
+            // Точные квадраты и соседние числа
+            BigInt square = value * value;
+            assert(isqrt(square) == value);
+            assert(isqrt(square - 1) == value - 1);
+            assert(isqrt(square + 1) == value);
+        }
+    }
+}
+
+//#define DV_MUL_BENCHMARK 1
+
+#if DV_MUL_BENCHMARK
+// Для подбора BigInt::mul_thresholds: время умножения чисел одинаковой длины разными алгоритмами
+void mul_benchmark()
+{
+    const BigInt::MulThresholds default_thresholds = BigInt::mul_thresholds;
+
+    const pair<const char*, BigInt::MulThresholds> algorithms[] =
+    {
+        {"schoolbook", {SIZE_MAX, SIZE_MAX, SIZE_MAX}},
+        {"karatsuba", {default_thresholds.karatsuba, SIZE_MAX, SIZE_MAX}},
+        {"toom3", {default_thresholds.karatsuba, default_thresholds.toom3, SIZE_MAX}},
+        {"ntt", {1, 1, 1}}
+    };
+
+    cout << "Длина (цифр Digit) | schoolbook | karatsuba | toom3 | ntt (мкс на умножение)" << endl;
+
+    for (size_t size = 16; size <= 16384; size *= 2)
+    {
+        BigInt a = BigInt::generate(size);
+        BigInt b = BigInt::generate(size);
+
+        // Чтобы суммарное время для каждой длины было примерно одинаковым
+        size_t repeats = max(size_t(1), size_t(200'000) / size);
+
+        cout << size;
+
+        for (const auto& [name, thresholds] : algorithms)
+        {
+            // Умножение столбиком длинных чисел слишком медленное
+            if (size > 4096 && thresholds.karatsuba == SIZE_MAX)
+            {
+                cout << " | -";
+                continue;
+            }
+
+            BigInt::mul_thresholds = thresholds;
+
+            auto begin_time = chrono::high_resolution_clock::now();
+
+            for (size_t i = 0; i < repeats; ++i)
+                a * b;
+
+            auto duration = chrono::high_resolution_clock::now() - begin_time;
+            cout << " | " << chrono::duration_cast<chrono::nanoseconds>(duration).count() / repeats / 1000.0;
+        }
+
+        cout << endl;
+    }
+
+    BigInt::mul_thresholds = default_thresholds;
 }
+#endif
+
+//#define DV_INPLACE_BENCHMARK 1
+
+#if DV_INPLACE_BENCHMARK
+// Время и число выделений памяти для составных операторов и быстрых путей
+void inplace_benchmark()
+{
+    cout << "Длина (цифр Digit) | операция | нс на операцию | выделений памяти на операцию" << endl;
+
+    for (size_t size : {1, 2, 4, 8, 64, 1024})
+    {
+        const BigInt b = BigInt::generate(size);
+        const size_t repeats = 1'000'000 / size;
+
+        auto measure = [&](const char* name, auto func)
+        {
+            BigInt a = BigInt::generate(size);
+            size_t allocations_before = num_allocations;
+            auto begin_time = chrono::high_resolution_clock::now();
+
+            for (size_t i = 0; i < repeats; ++i)
+                func(a);
+
+            auto duration = chrono::high_resolution_clock::now() - begin_time;
+            double ns = (double)chrono::duration_cast<chrono::nanoseconds>(duration).count() / repeats;
+            double allocations = (double)(num_allocations - allocations_before) / repeats;
+            cout << size << " | " << name << " | " << ns << " | " << allocations << endl;
+        };
+
+        measure("a = a + b", [&](BigInt& a) { a = a + b; });
+        measure("a += b", [&](BigInt& a) { a += b; });
+        measure("a -= b", [&](BigInt& a) { a -= b; });
+        measure("++a", [&](BigInt& a) { ++a; });
+        measure("a += uint64_t", [&](BigInt& a) { a += uint64_t(999'999'999'999); });
+        measure("a *= uint32_t", [&](BigInt& a) { a *= 3u; a /= 3u; });
+    }
+}
+#endif
+
+//#define DV_DIV_ALGORITHMS_BENCHMARK 1
+
+#if DV_DIV_ALGORITHMS_BENCHMARK
+// Для подбора BigInt::div_thresholds: время деления числа длиной 5n на число длиной n разными алгоритмами
+void div_benchmark()
+{
+    const BigInt::DivThresholds default_thresholds = BigInt::div_thresholds;
+
+    const pair<const char*, BigInt::DivThresholds> algorithms[] =
+    {
+        {"knuth", {SIZE_MAX, SIZE_MAX}},
+        {"burnikel_ziegler", {default_thresholds.burnikel_ziegler, SIZE_MAX}},
+        {"newton", {default_thresholds.burnikel_ziegler, 1}}
+    };
+
+    cout << "Длина знаменателя (цифр Digit) | knuth | burnikel_ziegler | newton (мкс на деление)" << endl;
+
+    for (size_t size = 16; size <= 16384; size *= 2)
+    {
+        BigInt a = BigInt::generate(size * 5);
+        BigInt b = BigInt::generate(size);
+
+        // Чтобы суммарное время для каждой длины было примерно одинаковым
+        size_t repeats = max(size_t(1), size_t(200'000) / size);
+
+        cout << size;
+
+        for (const auto& [name, thresholds] : algorithms)
+        {
+            // Деление столбиком длинных чисел слишком медленное
+            if (size > 4096 && thresholds.burnikel_ziegler == SIZE_MAX)
+            {
+                cout << " | -";
+                continue;
+            }
+
+            BigInt::div_thresholds = thresholds;
+
+            auto begin_time = chrono::high_resolution_clock::now();
+
+            for (size_t i = 0; i < repeats; ++i)
+                a.div_mod(b);
+
+            auto duration = chrono::high_resolution_clock::now() - begin_time;
+            cout << " | " << chrono::duration_cast<chrono::nanoseconds>(duration).count() / repeats / 1000.0;
+        }
+
+        cout << endl;
+    }
+
+    BigInt::div_thresholds = default_thresholds;
+}
+#endif
+
+//#define DV_NUMBER_THEORY_BENCHMARK 1
+
+#if DV_NUMBER_THEORY_BENCHMARK
+// Сравнение pow_mod(), gcd() и сдвигов с наивными реализациями через operator% и умножение
+void number_theory_benchmark()
+{
+    auto measure = [](auto func)
+    {
+        auto begin_time = chrono::high_resolution_clock::now();
+        func();
+        auto duration = chrono::high_resolution_clock::now() - begin_time;
+        return chrono::duration_cast<chrono::microseconds>(duration).count();
+    };
+
+    cout << "Длина (цифр Digit) | pow_mod | наивный pow_mod | gcd | наивный gcd | << 1000 | * 2^1000 (мкс)" << endl;
+
+    for (size_t size : {4, 16, 64, 256})
+    {
+        const BigInt modulus = BigInt::generate(size) * 10 + 1; // Нечётный и не кратный 5
+        const BigInt value = BigInt::generate(size);
+        const BigInt exponent = BigInt::generate(size);
+        const BigInt a = BigInt::generate(size * 4);
+        const BigInt b = BigInt::generate(size * 4);
+        const BigInt power = pow(BigInt(2), 1000);
+        BigInt result;
+
+        cout << size;
+
+        cout << " | " << measure([&] { result = pow_mod(value, exponent, modulus); });
+
+        cout << " | " << measure([&]
+        {
+            BigInt x = value;
+            BigInt e = exponent;
+            result = 1;
+
+            while (!e.is_zero())
+            {
+                if (e % 2 == 1)
+                    result = result * x % modulus;
+
+                e /= 2;
+                x = x * x % modulus;
+            }
+        });
+
+        cout << " | " << measure([&] { result = gcd(a, b); });
+
+        cout << " | " << measure([&]
+        {
+            BigInt x = a, y = b;
+
+            while (!y.is_zero())
+            {
+                BigInt r = x % y;
+                x = std::move(y);
+                y = std::move(r);
+            }
+
+            result = x;
+        });
+
+        cout << " | " << measure([&] { for (size_t i = 0; i < 1000; ++i) result = a << 1000; });
+        cout << " | " << measure([&] { for (size_t i = 0; i < 1000; ++i) result = a * power; }) << endl;
+    }
+}
+#endif
 
 int main()
 {
@@ -295,5 +1001,21 @@ int main()
     cout << "Все тесты пройдены успешно" << endl;
     cout << "Время: " << duration_ms << " ms" << endl;
 
+#if DV_MUL_BENCHMARK
+    mul_benchmark();
+#endif
+
+#if DV_INPLACE_BENCHMARK
+    inplace_benchmark();
+#endif
+
+#if DV_DIV_ALGORITHMS_BENCHMARK
+    div_benchmark();
+#endif
+
+#if DV_NUMBER_THEORY_BENCHMARK
+    number_theory_benchmark();
+#endif
+
     return 0;
 }